@@ -9,10 +9,287 @@
 #import <Proton/NSArray+HigherOrderAdditions.h>
 #import <Proton/EXTSafeCategory.h>
 #import <Proton/EXTScope.h>
+#import <Proton/PROConcurrentFunctions.h>
+#import <Proton/PROLazySequence.h>
 #import <libkern/OSAtomic.h>
 
+/**
+ * A `CFDictionaryApplierFunction` which adds the count for `key` in the
+ * dictionary being enumerated to the mutable dictionary `context`.
+ */
+static void addCount (const void *key, const void *value, void *context) {
+    CFMutableDictionaryRef counts = context;
+
+    uintptr_t count = (uintptr_t)CFDictionaryGetValue(counts, key);
+    CFDictionarySetValue(counts, key, (const void *)(count + (uintptr_t)value));
+}
+
+/**
+ * A `CFDictionaryApplierFunction` which adds the count for `key` to the
+ * `NSMutableDictionary` `context`, boxed as an `NSNumber`.
+ */
+static void boxCount (const void *key, const void *value, void *context) {
+    NSMutableDictionary *counts = (__bridge NSMutableDictionary *)context;
+    [counts setObject:[NSNumber numberWithUnsignedInteger:(NSUInteger)value] forKey:(__bridge id)key];
+}
+
+/**
+ * An object being considered by a selection algorithm, along with its position
+ * in the order of enumeration.
+ */
+typedef struct {
+    /**
+     * The object, which is retained by the collection being enumerated.
+     */
+    __unsafe_unretained id object;
+
+    /**
+     * The position of <object> in the order of enumeration, which breaks ties
+     * between objects that the comparator considers equal.
+     */
+    NSUInteger position;
+} PROSelectionCandidate;
+
+/**
+ * Returns whether `left` should be sorted before `right`, according to
+ * `comparator` and then their positions.
+ */
+static BOOL candidatePrecedes (PROSelectionCandidate left, PROSelectionCandidate right, NSComparator comparator) {
+    NSComparisonResult result = comparator(left.object, right.object);
+    if (result == NSOrderedSame)
+        return left.position < right.position;
+    else
+        return result == NSOrderedAscending;
+}
+
+/**
+ * Swaps the candidates at the given indexes of `candidates`.
+ */
+static void swapCandidates (PROSelectionCandidate *candidates, NSUInteger leftIndex, NSUInteger rightIndex) {
+    PROSelectionCandidate temp = candidates[leftIndex];
+    candidates[leftIndex] = candidates[rightIndex];
+    candidates[rightIndex] = temp;
+}
+
+/**
+ * Restores the heap property of `heap` (where every candidate is sorted after
+ * its children) by moving the candidate at `index` down the heap.
+ */
+static void siftCandidateDown (PROSelectionCandidate *heap, NSUInteger heapCount, NSUInteger index, NSComparator comparator) {
+    for (;;) {
+        NSUInteger lastIndex = index;
+        NSUInteger leftChild = index * 2 + 1;
+        NSUInteger rightChild = leftChild + 1;
+
+        if (leftChild < heapCount && candidatePrecedes(heap[lastIndex], heap[leftChild], comparator))
+            lastIndex = leftChild;
+
+        if (rightChild < heapCount && candidatePrecedes(heap[lastIndex], heap[rightChild], comparator))
+            lastIndex = rightChild;
+
+        if (lastIndex == index)
+            return;
+
+        swapCandidates(heap, index, lastIndex);
+        index = lastIndex;
+    }
+}
+
+/**
+ * Restores the heap property of `heap` by moving the candidate at `index` up
+ * the heap.
+ */
+static void siftCandidateUp (PROSelectionCandidate *heap, NSUInteger index, NSComparator comparator) {
+    while (index > 0) {
+        NSUInteger parent = (index - 1) / 2;
+        if (!candidatePrecedes(heap[parent], heap[index], comparator))
+            return;
+
+        swapCandidates(heap, parent, index);
+        index = parent;
+    }
+}
+
+/**
+ * Selects the first `topCount` objects (in the order defined by `comparator`)
+ * from the given range of `objects`, writing them in sorted order into `heap`,
+ * and returning the number of objects written.
+ *
+ * Only `topCount` candidates are kept at any one time, so this takes O(n log k)
+ * time, instead of the O(n log n) needed to sort the whole range.
+ *
+ * @param heap A buffer with space for at least `topCount` candidates (or
+ * `range.length` candidates, if that is less).
+ * @param topCount The maximum number of objects to select.
+ * @param objects A buffer of objects in the order of enumeration. The index of
+ * each object in this buffer is used as its position.
+ * @param range The range of `objects` to select from.
+ * @param comparator The comparator which defines the sort order.
+ */
+static NSUInteger selectTopCandidates (PROSelectionCandidate *heap, NSUInteger topCount, const __unsafe_unretained id *objects, NSRange range, NSComparator comparator) {
+    if (!topCount)
+        return 0;
+
+    NSUInteger heapCount = 0;
+
+    // 'heap' is a max-heap, so the candidate which sorts last (and which will
+    // be replaced next) is always at the top
+    for (NSUInteger position = range.location; position < NSMaxRange(range); ++position) {
+        PROSelectionCandidate candidate = { .object = objects[position], .position = position };
+
+        if (heapCount < topCount) {
+            heap[heapCount] = candidate;
+            siftCandidateUp(heap, heapCount, comparator);
+            ++heapCount;
+        } else if (candidatePrecedes(candidate, heap[0], comparator)) {
+            heap[0] = candidate;
+            siftCandidateDown(heap, heapCount, 0, comparator);
+        }
+    }
+
+    // heapsort what remains, which moves the last candidate to the end on each
+    // iteration
+    for (NSUInteger remaining = heapCount; remaining > 1; --remaining) {
+        swapCandidates(heap, 0, remaining - 1);
+        siftCandidateDown(heap, remaining - 1, 0, comparator);
+    }
+
+    return heapCount;
+}
+
+/**
+ * Partially orders `candidates` with a quickselect, such that the candidate at
+ * `index` is the one that would be there if `candidates` were fully sorted.
+ */
+static void selectCandidate (PROSelectionCandidate *candidates, NSUInteger count, NSUInteger index, NSComparator comparator) {
+    NSUInteger low = 0;
+    NSUInteger high = count - 1;
+
+    while (low < high) {
+        // move the median of the first, middle, and last candidates to the end
+        // of the range, to use as the pivot
+        NSUInteger middle = low + (high - low) / 2;
+
+        if (candidatePrecedes(candidates[middle], candidates[low], comparator))
+            swapCandidates(candidates, middle, low);
+
+        if (candidatePrecedes(candidates[high], candidates[low], comparator))
+            swapCandidates(candidates, high, low);
+
+        if (candidatePrecedes(candidates[middle], candidates[high], comparator))
+            swapCandidates(candidates, middle, high);
+
+        PROSelectionCandidate pivot = candidates[high];
+        NSUInteger pivotIndex = low;
+
+        // positions break all ties, so no two candidates are ever equal, and
+        // this partitioning can't degenerate on repeated objects
+        for (NSUInteger i = low; i < high; ++i) {
+            if (candidatePrecedes(candidates[i], pivot, comparator))
+                swapCandidates(candidates, i, pivotIndex++);
+        }
+
+        swapCandidates(candidates, pivotIndex, high);
+
+        if (pivotIndex == index)
+            return;
+        else if (index < pivotIndex)
+            high = pivotIndex - 1;
+        else
+            low = pivotIndex + 1;
+    }
+}
+
 @safecategory (NSArray, HigherOrderAdditions)
 
+- (BOOL)anyObjectPassingTest:(BOOL (^)(id obj))predicate; {
+    return [self anyObjectWithOptions:0 passingTest:predicate];
+}
+
+- (BOOL)anyObjectWithOptions:(NSEnumerationOptions)opts passingTest:(BOOL (^)(id obj))predicate; {
+    NSParameterAssert(predicate != nil);
+
+    NSUInteger count = [self count];
+
+    PROAutomaticEnumeration automaticEnumeration = PROBeginAutomaticEnumeration(&opts, count, predicate);
+    @onExit {
+        PROEndAutomaticEnumeration(automaticEnumeration);
+    };
+
+    BOOL concurrent = (opts & NSEnumerationConcurrent);
+    BOOL reverse = (opts & NSEnumerationReverse);
+
+    NSUInteger matchPosition;
+    NSUInteger matchCount = PROConcurrentSearch(count, (concurrent ? 0 : count), 1, &matchPosition, ^(NSUInteger position){
+        return predicate([self objectAtIndex:(reverse ? count - position - 1 : position)]);
+    });
+
+    return matchCount > 0;
+}
+
+- (NSDictionary *)countByUsingBlock:(id (^)(id obj))block; {
+    return [self countByWithOptions:0 usingBlock:block];
+}
+
+- (NSDictionary *)countByWithOptions:(NSEnumerationOptions)opts usingBlock:(id (^)(id obj))block; {
+    NSParameterAssert(block != nil);
+
+    NSUInteger count = [self count];
+
+    PROAutomaticEnumeration automaticEnumeration = PROBeginAutomaticEnumeration(&opts, count, block);
+    @onExit {
+        PROEndAutomaticEnumeration(automaticEnumeration);
+    };
+
+    BOOL concurrent = (opts & NSEnumerationConcurrent);
+    BOOL reverse = (opts & NSEnumerationReverse);
+
+    // each chunk counts into its own table of unboxed integers, and the tables
+    // are then merged together
+    id counts = PROConcurrentReduce(count, (concurrent ? 0 : count), nil, ^ id (NSRange range){
+        CFMutableDictionaryRef chunkCounts = CFDictionaryCreateMutable(NULL, 0, &kCFTypeDictionaryKeyCallBacks, NULL);
+
+        for (NSUInteger position = range.location; position < NSMaxRange(range); ++position) {
+            id key = block([self objectAtIndex:(reverse ? count - position - 1 : position)]);
+            if (!key)
+                continue;
+
+            uintptr_t keyCount = (uintptr_t)CFDictionaryGetValue(chunkCounts, (__bridge void *)key);
+            CFDictionarySetValue(chunkCounts, (__bridge void *)key, (const void *)(keyCount + 1));
+        }
+
+        return CFBridgingRelease(chunkCounts);
+    }, ^(id left, id right){
+        CFDictionaryApplyFunction((__bridge CFDictionaryRef)right, &addCount, (__bridge void *)left);
+        return left;
+    });
+
+    NSMutableDictionary *boxedCounts = [[NSMutableDictionary alloc] init];
+
+    if (counts)
+        CFDictionaryApplyFunction((__bridge CFDictionaryRef)counts, &boxCount, (__bridge void *)boxedCounts);
+
+    return boxedCounts;
+}
+
+- (BOOL)everyObjectPassingTest:(BOOL (^)(id obj))predicate; {
+    return [self everyObjectWithOptions:0 passingTest:predicate];
+}
+
+- (BOOL)everyObjectWithOptions:(NSEnumerationOptions)opts passingTest:(BOOL (^)(id obj))predicate; {
+    NSParameterAssert(predicate != nil);
+
+    PROAutomaticEnumeration automaticEnumeration = PROBeginAutomaticEnumeration(&opts, [self count], predicate);
+    @onExit {
+        PROEndAutomaticEnumeration(automaticEnumeration);
+    };
+
+    // search for a counterexample
+    return ![self anyObjectWithOptions:opts passingTest:^ BOOL (id obj){
+        return !predicate(obj);
+    }];
+}
+
 - (id)filterUsingBlock:(BOOL(^)(id obj))block {
     return [self filterWithOptions:0 usingBlock:block];
 }
@@ -26,40 +303,167 @@
 }
 
 - (id)filterWithOptions:(NSEnumerationOptions)opts failedObjects:(NSArray **)failedObjects usingBlock:(BOOL(^)(id obj))block; {
-    NSIndexSet *successIndexes = [self indexesOfObjectsWithOptions:opts passingTest:^(id obj, NSUInteger idx, BOOL *stop) {
-        return block(obj);
+    NSUInteger originalCount = [self count];
+
+    PROAutomaticEnumeration automaticEnumeration = PROBeginAutomaticEnumeration(&opts, originalCount, block);
+    @onExit {
+        PROEndAutomaticEnumeration(automaticEnumeration);
+    };
+
+    BOOL concurrent = (opts & NSEnumerationConcurrent);
+    BOOL reverse = (opts & NSEnumerationReverse);
+
+    // whether each object passed the test, indexed by its position in the
+    // receiver
+    BOOL *passed = calloc(originalCount + 1, sizeof(*passed));
+    if (!passed) {
+        return nil;
+    }
+
+    @onExit {
+        free(passed);
+    };
+
+    [self enumerateObjectsWithOptions:opts usingBlock:^(id obj, NSUInteger index, BOOL *stop){
+        passed[index] = (block(obj) ? YES : NO);
     }];
 
-    if (opts & NSEnumerationReverse) {
-        NSMutableArray *mutableSuccess = [[NSMutableArray alloc] initWithCapacity:[successIndexes count]];
+    if (concurrent) {
+        // finish all assignments into the 'passed' array
+        OSMemoryBarrier();
+    }
 
-        NSMutableArray *mutableFailed = nil;
-        if (failedObjects)
-            mutableFailed = [[NSMutableArray alloc] initWithCapacity:[self count] - [successIndexes count] - 1];
+    // note that we don't need to retain the objects, since the array is already
+    // doing so
+    __unsafe_unretained id *passedObjects = (__unsafe_unretained id *)calloc(originalCount + 1, sizeof(*passedObjects));
+    if (!passedObjects) {
+        return nil;
+    }
 
-        [self enumerateObjectsWithOptions:NSEnumerationReverse usingBlock:^(id obj, NSUInteger index, BOOL *stop){
-            if ([successIndexes containsIndex:index])
-                [mutableSuccess addObject:obj];
-            else
-                [mutableFailed addObject:obj];
-        }];
+    @onExit {
+        free(passedObjects);
+    };
 
-        if (failedObjects)
-            *failedObjects = [mutableFailed copy];
+    __unsafe_unretained id *rejectedObjects = NULL;
+    if (failedObjects) {
+        rejectedObjects = (__unsafe_unretained id *)calloc(originalCount + 1, sizeof(*rejectedObjects));
+        if (!rejectedObjects) {
+            return nil;
+        }
+    }
+
+    @onExit {
+        free(rejectedObjects);
+    };
+
+    // positions are in the order of the results, which is only different from
+    // the order of the receiver when enumerating in reverse
+    NSUInteger passedCount = PROConcurrentCompact(originalCount, (concurrent ? 0 : originalCount), ^(NSRange range){
+        NSUInteger count = 0;
 
-        return [mutableSuccess copy];
-    } else {
-        if (failedObjects) {
-            NSUInteger totalCount = self.count;
+        for (NSUInteger position = range.location; position < NSMaxRange(range); ++position) {
+            count += passed[reverse ? originalCount - position - 1 : position];
+        }
+
+        return count;
+    }, ^(NSRange range, NSUInteger outputIndex){
+        // every object before this range which didn't pass must have failed
+        NSUInteger rejectedIndex = range.location - outputIndex;
 
-            NSMutableIndexSet *failedIndexes = [[NSMutableIndexSet alloc] initWithIndexesInRange:NSMakeRange(0, totalCount)];
-            [failedIndexes removeIndexes:successIndexes];
+        for (NSUInteger position = range.location; position < NSMaxRange(range); ++position) {
+            NSUInteger index = (reverse ? originalCount - position - 1 : position);
 
-            *failedObjects = [self objectsAtIndexes:failedIndexes];
+            if (passed[index])
+                passedObjects[outputIndex++] = [self objectAtIndex:index];
+            else if (rejectedObjects)
+                rejectedObjects[rejectedIndex++] = [self objectAtIndex:index];
         }
+    });
+
+    if (failedObjects)
+        *failedObjects = [NSArray arrayWithObjects:(id *)rejectedObjects count:originalCount - passedCount];
+
+    return [NSArray arrayWithObjects:(id *)passedObjects count:passedCount];
+}
 
-        return [self objectsAtIndexes:successIndexes];
+- (id)filterWithOptions:(NSEnumerationOptions)opts grainSize:(NSUInteger)grainSize failedObjects:(NSArray **)failedObjects usingBlock:(BOOL(^)(id obj))block; {
+    // automatic enumeration chooses its own grain size
+    if ((opts & PROEnumerationAutomatic) || !(opts & NSEnumerationConcurrent))
+        return [self filterWithOptions:opts failedObjects:failedObjects usingBlock:block];
+
+    NSUInteger originalCount = [self count];
+    BOOL reverse = (opts & NSEnumerationReverse);
+
+    // the results of each chunk are compacted into the beginning of that
+    // chunk's range of these buffers
+    //
+    // note that we don't need to retain the objects, since the array is already
+    // doing so
+    __unsafe_unretained id *passedObjects = (__unsafe_unretained id *)calloc(originalCount + 1, sizeof(*passedObjects));
+    if (!passedObjects) {
+        return nil;
     }
+
+    @onExit {
+        free(passedObjects);
+    };
+
+    __unsafe_unretained id *rejectedObjects = NULL;
+    if (failedObjects) {
+        rejectedObjects = (__unsafe_unretained id *)calloc(originalCount + 1, sizeof(*rejectedObjects));
+        if (!rejectedObjects) {
+            return nil;
+        }
+    }
+
+    @onExit {
+        free(rejectedObjects);
+    };
+
+    NSUInteger chunkCount = PROConcurrentChunkCount(originalCount, grainSize);
+
+    NSRange *passedRanges = calloc(chunkCount + 1, sizeof(*passedRanges));
+    if (!passedRanges) {
+        return nil;
+    }
+
+    @onExit {
+        free(passedRanges);
+    };
+
+    NSRange *rejectedRanges = calloc(chunkCount + 1, sizeof(*rejectedRanges));
+    if (!rejectedRanges) {
+        return nil;
+    }
+
+    @onExit {
+        free(rejectedRanges);
+    };
+
+    PROConcurrentEnumerateChunks(originalCount, grainSize, ^(NSUInteger chunkIndex, NSRange range){
+        NSUInteger nextPassedIndex = range.location;
+        NSUInteger nextRejectedIndex = range.location;
+
+        for (NSUInteger i = range.location; i < NSMaxRange(range); ++i) {
+            id obj = [self objectAtIndex:(reverse ? originalCount - i - 1 : i)];
+
+            if (block(obj))
+                passedObjects[nextPassedIndex++] = obj;
+            else if (rejectedObjects)
+                rejectedObjects[nextRejectedIndex++] = obj;
+        }
+
+        passedRanges[chunkIndex] = NSMakeRange(range.location, nextPassedIndex - range.location);
+        rejectedRanges[chunkIndex] = NSMakeRange(range.location, nextRejectedIndex - range.location);
+    });
+
+    if (failedObjects) {
+        NSUInteger rejectedCount = PROConcurrentCompactChunks(rejectedObjects, sizeof(*rejectedObjects), rejectedRanges, chunkCount);
+        *failedObjects = [NSArray arrayWithObjects:(id *)rejectedObjects count:rejectedCount];
+    }
+
+    NSUInteger passedCount = PROConcurrentCompactChunks(passedObjects, sizeof(*passedObjects), passedRanges, chunkCount);
+    return [NSArray arrayWithObjects:(id *)passedObjects count:passedCount];
 }
 
 - (id)foldLeftWithValue:(id)startingValue usingBlock:(id (^)(id left, id right))block; {
@@ -82,6 +486,63 @@
     return value;
 }
 
+- (NSDictionary *)groupByUsingBlock:(id (^)(id obj))block; {
+    return [self groupByWithOptions:0 usingBlock:block];
+}
+
+- (NSDictionary *)groupByWithOptions:(NSEnumerationOptions)opts usingBlock:(id (^)(id obj))block; {
+    NSParameterAssert(block != nil);
+
+    NSUInteger count = [self count];
+
+    PROAutomaticEnumeration automaticEnumeration = PROBeginAutomaticEnumeration(&opts, count, block);
+    @onExit {
+        PROEndAutomaticEnumeration(automaticEnumeration);
+    };
+
+    BOOL concurrent = (opts & NSEnumerationConcurrent);
+    BOOL reverse = (opts & NSEnumerationReverse);
+
+    // each chunk groups into its own dictionary, and the groups of later chunks
+    // are then appended to the groups of earlier ones
+    return PROConcurrentReduce(count, (concurrent ? 0 : count), [NSDictionary dictionary], ^ id (NSRange range){
+        NSMutableDictionary *chunkGroups = [[NSMutableDictionary alloc] init];
+
+        for (NSUInteger position = range.location; position < NSMaxRange(range); ++position) {
+            id obj = [self objectAtIndex:(reverse ? count - position - 1 : position)];
+
+            id key = block(obj);
+            if (!key)
+                continue;
+
+            NSMutableArray *group = [chunkGroups objectForKey:key];
+            if (!group) {
+                group = [[NSMutableArray alloc] init];
+                [chunkGroups setObject:group forKey:key];
+            }
+
+            [group addObject:obj];
+        }
+
+        return chunkGroups;
+    }, ^(NSMutableDictionary *leftGroups, NSDictionary *rightGroups){
+        [rightGroups enumerateKeysAndObjectsUsingBlock:^(id key, NSMutableArray *rightGroup, BOOL *stop){
+            NSMutableArray *leftGroup = [leftGroups objectForKey:key];
+
+            if (leftGroup)
+                [leftGroup addObjectsFromArray:rightGroup];
+            else
+                [leftGroups setObject:rightGroup forKey:key];
+        }];
+
+        return leftGroups;
+    });
+}
+
+- (PROLazySequence *)lazySequence; {
+    return [PROLazySequence sequenceWithCollection:self];
+}
+
 - (id)mapUsingBlock:(id (^)(id obj))block; {
     return [self mapWithOptions:0 usingBlock:block];
 }
@@ -89,6 +550,11 @@
 - (id)mapWithOptions:(NSEnumerationOptions)opts usingBlock:(id (^)(id obj))block; {
     NSUInteger originalCount = [self count];
 
+    PROAutomaticEnumeration automaticEnumeration = PROBeginAutomaticEnumeration(&opts, originalCount, block);
+    @onExit {
+        PROEndAutomaticEnumeration(automaticEnumeration);
+    };
+
     BOOL concurrent = (opts & NSEnumerationConcurrent);
     BOOL reverse = (opts & NSEnumerationReverse);
 
@@ -97,12 +563,8 @@
         return nil;
     }
 
-    // declare this variable way up here so that it can be used in the @onExit
-    // block below (avoiding unnecessary iteration)
-    __block NSUInteger actualCount = originalCount;
-
     @onExit {
-        for (NSUInteger i = 0;i < actualCount;++i) {
+        for (NSUInteger i = 0;i < originalCount;++i) {
             // nil out everything in the array to make sure ARC releases
             // everything appropriately
             objects[i] = nil;
@@ -151,27 +613,140 @@
         }
     }
 
-    if (needsCompaction) {
-        for (NSUInteger index = 0;index < actualCount;) {
-            if (objects[index]) {
-                ++index;
-                continue;
-            }
+    if (!needsCompaction)
+        return [NSArray arrayWithObjects:(id *)objects count:originalCount];
 
-            // otherwise, move down everything above
-            memmove((void *)(objects + index), (void *)(objects + index + 1), sizeof(*objects) * (originalCount - index - 1));
-            --actualCount;
+    // the results are already retained by 'objects', so the compacted buffer
+    // doesn't need to retain them again
+    __unsafe_unretained id *compactedObjects = (__unsafe_unretained id *)calloc(originalCount, sizeof(*compactedObjects));
+    if (!compactedObjects) {
+        return nil;
+    }
+
+    @onExit {
+        free(compactedObjects);
+    };
+
+    NSUInteger compactedCount = PROConcurrentCompact(originalCount, (concurrent ? 0 : originalCount), ^(NSRange range){
+        NSUInteger count = 0;
+
+        for (NSUInteger i = range.location; i < NSMaxRange(range); ++i) {
+            if (objects[i])
+                ++count;
         }
+
+        return count;
+    }, ^(NSRange range, NSUInteger outputIndex){
+        for (NSUInteger i = range.location; i < NSMaxRange(range); ++i) {
+            if (objects[i])
+                compactedObjects[outputIndex++] = objects[i];
+        }
+    });
+
+    return [NSArray arrayWithObjects:(id *)compactedObjects count:compactedCount];
+}
+
+- (id)mapWithOptions:(NSEnumerationOptions)opts grainSize:(NSUInteger)grainSize usingBlock:(id (^)(id obj))block; {
+    // automatic enumeration chooses its own grain size
+    if ((opts & PROEnumerationAutomatic) || !(opts & NSEnumerationConcurrent))
+        return [self mapWithOptions:opts usingBlock:block];
+
+    NSUInteger originalCount = [self count];
+    BOOL reverse = (opts & NSEnumerationReverse);
+
+    // the results of each chunk are compacted into the beginning of that
+    // chunk's range of this buffer
+    __strong id *objects = (__strong id *)calloc(originalCount + 1, sizeof(*objects));
+    if (!objects) {
+        return nil;
+    }
+
+    NSUInteger chunkCount = PROConcurrentChunkCount(originalCount, grainSize);
+
+    NSRange *resultRanges = calloc(chunkCount + 1, sizeof(*resultRanges));
+    if (!resultRanges) {
+        free((void *)objects);
+        return nil;
     }
 
+    // declare this variable way up here so that it can be used in the @onExit
+    // block below -- until compaction, this is the number of objects at the
+    // beginning of the buffer which are guaranteed to be valid
+    __block NSUInteger actualCount = 0;
+
+    @onExit {
+        // nil out everything in the array to make sure ARC releases
+        // everything appropriately (anything past 'actualCount' was moved)
+        for (NSUInteger i = 0;i < actualCount;++i) {
+            objects[i] = nil;
+        }
+
+        free((void *)objects);
+        free(resultRanges);
+    };
+
+    PROConcurrentEnumerateChunks(originalCount, grainSize, ^(NSUInteger chunkIndex, NSRange range){
+        NSUInteger nextIndex = range.location;
+
+        for (NSUInteger i = range.location; i < NSMaxRange(range); ++i) {
+            id result = block([self objectAtIndex:(reverse ? originalCount - i - 1 : i)]);
+            if (result)
+                objects[nextIndex++] = result;
+        }
+
+        resultRanges[chunkIndex] = NSMakeRange(range.location, nextIndex - range.location);
+    });
+
+    actualCount = PROConcurrentCompactChunks((void *)objects, sizeof(*objects), resultRanges, chunkCount);
     return [NSArray arrayWithObjects:(id *)objects count:actualCount];
 }
 
+- (BOOL)noObjectPassingTest:(BOOL (^)(id obj))predicate; {
+    return [self noObjectWithOptions:0 passingTest:predicate];
+}
+
+- (BOOL)noObjectWithOptions:(NSEnumerationOptions)opts passingTest:(BOOL (^)(id obj))predicate; {
+    return ![self anyObjectWithOptions:opts passingTest:predicate];
+}
+
+- (id)nthObject:(NSUInteger)index usingComparator:(NSComparator)comparator; {
+    NSParameterAssert(comparator != nil);
+
+    NSUInteger count = [self count];
+
+    // this also covers an empty receiver, in which case there is nothing to
+    // select
+    if (index >= count)
+        return nil;
+
+    PROSelectionCandidate *candidates = malloc(count * sizeof(*candidates));
+    if (!candidates) {
+        return nil;
+    }
+
+    @onExit {
+        free(candidates);
+    };
+
+    [self enumerateObjectsUsingBlock:^(id obj, NSUInteger position, BOOL *stop){
+        candidates[position].object = obj;
+        candidates[position].position = position;
+    }];
+
+    selectCandidate(candidates, count, index, comparator);
+    return candidates[index].object;
+}
+
 - (id)objectPassingTest:(BOOL (^)(id obj, NSUInteger index, BOOL *stop))predicate; {
     return [self objectWithOptions:0 passingTest:predicate];
 }
 
 - (id)objectWithOptions:(NSEnumerationOptions)opts passingTest:(BOOL (^)(id obj, NSUInteger index, BOOL *stop))predicate; {
+    PROAutomaticEnumeration automaticEnumeration = PROBeginAutomaticEnumeration(&opts, [self count], predicate);
+    @onExit {
+        PROEndAutomaticEnumeration(automaticEnumeration);
+    };
+
     NSUInteger index = [self indexOfObjectWithOptions:opts passingTest:predicate];
     if (index == NSNotFound)
         return nil;
@@ -179,4 +754,192 @@
         return [self objectAtIndex:index];
 }
 
+- (id)objectsWithMaximumCount:(NSUInteger)maximumCount passingTest:(BOOL (^)(id obj))predicate; {
+    return [self objectsWithOptions:0 maximumCount:maximumCount passingTest:predicate];
+}
+
+- (id)objectsWithOptions:(NSEnumerationOptions)opts maximumCount:(NSUInteger)maximumCount passingTest:(BOOL (^)(id obj))predicate; {
+    NSParameterAssert(predicate != nil);
+
+    NSUInteger count = [self count];
+
+    PROAutomaticEnumeration automaticEnumeration = PROBeginAutomaticEnumeration(&opts, count, predicate);
+    @onExit {
+        PROEndAutomaticEnumeration(automaticEnumeration);
+    };
+
+    BOOL concurrent = (opts & NSEnumerationConcurrent);
+    BOOL reverse = (opts & NSEnumerationReverse);
+
+    // positions are in the order of enumeration, which is only different from
+    // the order of the receiver when enumerating in reverse
+    NSUInteger *positions = calloc(MIN(maximumCount, count) + 1, sizeof(*positions));
+    if (!positions) {
+        return nil;
+    }
+
+    @onExit {
+        free(positions);
+    };
+
+    NSUInteger matchCount = PROConcurrentSearch(count, (concurrent ? 0 : count), maximumCount, positions, ^(NSUInteger position){
+        return predicate([self objectAtIndex:(reverse ? count - position - 1 : position)]);
+    });
+
+    NSMutableArray *objects = [[NSMutableArray alloc] initWithCapacity:matchCount];
+
+    for (NSUInteger i = 0; i < matchCount; ++i) {
+        NSUInteger position = positions[i];
+        [objects addObject:[self objectAtIndex:(reverse ? count - position - 1 : position)]];
+    }
+
+    return [objects copy];
+}
+
+- (NSArray *)objectsWithOptions:(NSEnumerationOptions)opts topCount:(NSUInteger)topCount usingComparator:(NSComparator)comparator; {
+    NSParameterAssert(comparator != nil);
+
+    NSUInteger count = [self count];
+    if (!count || !topCount)
+        return [NSArray array];
+
+    PROAutomaticEnumeration automaticEnumeration = PROBeginAutomaticEnumeration(&opts, count, comparator);
+    @onExit {
+        PROEndAutomaticEnumeration(automaticEnumeration);
+    };
+
+    BOOL concurrent = (opts & NSEnumerationConcurrent);
+    BOOL reverse = (opts & NSEnumerationReverse);
+
+    // note that we don't need to retain the objects, since the array is
+    // already doing so
+    __unsafe_unretained id *objects = (__unsafe_unretained id *)malloc(count * sizeof(*objects));
+    if (!objects) {
+        return nil;
+    }
+
+    @onExit {
+        free(objects);
+    };
+
+    // positions are in the order of enumeration, which is only different from
+    // the order of the receiver when enumerating in reverse
+    [self enumerateObjectsUsingBlock:^(id obj, NSUInteger index, BOOL *stop){
+        objects[reverse ? count - index - 1 : index] = obj;
+    }];
+
+    // each chunk selects into its own heap, and then the sorted results of
+    // adjacent chunks are merged, keeping only the first 'topCount' objects
+    return PROConcurrentReduce(count, (concurrent ? 0 : count), [NSArray array], ^ id (NSRange range){
+        NSUInteger heapCapacity = MIN(topCount, range.length);
+
+        PROSelectionCandidate *heap = malloc(heapCapacity * sizeof(*heap));
+        if (!heap) {
+            return nil;
+        }
+
+        @onExit {
+            free(heap);
+        };
+
+        NSUInteger heapCount = selectTopCandidates(heap, topCount, objects, range, comparator);
+        NSMutableArray *selectedObjects = [[NSMutableArray alloc] initWithCapacity:heapCount];
+
+        for (NSUInteger i = 0; i < heapCount; ++i) {
+            [selectedObjects addObject:heap[i].object];
+        }
+
+        return selectedObjects;
+    }, ^(NSArray *leftObjects, NSArray *rightObjects){
+        NSUInteger leftCount = leftObjects.count;
+        NSUInteger rightCount = rightObjects.count;
+
+        NSMutableArray *mergedObjects = [[NSMutableArray alloc] initWithCapacity:MIN(topCount, leftCount + rightCount)];
+        NSUInteger leftIndex = 0;
+        NSUInteger rightIndex = 0;
+
+        while (mergedObjects.count < topCount && (leftIndex < leftCount || rightIndex < rightCount)) {
+            // on a tie, the left object wins, since it came earlier in the
+            // order of enumeration
+            BOOL takeLeft = (rightIndex >= rightCount);
+            if (!takeLeft && leftIndex < leftCount)
+                takeLeft = (comparator([leftObjects objectAtIndex:leftIndex], [rightObjects objectAtIndex:rightIndex]) != NSOrderedDescending);
+
+            if (takeLeft)
+                [mergedObjects addObject:[leftObjects objectAtIndex:leftIndex++]];
+            else
+                [mergedObjects addObject:[rightObjects objectAtIndex:rightIndex++]];
+        }
+
+        return mergedObjects;
+    });
+}
+
+- (NSArray *)objectsWithTopCount:(NSUInteger)topCount usingComparator:(NSComparator)comparator; {
+    return [self objectsWithOptions:0 topCount:topCount usingComparator:comparator];
+}
+
+- (NSArray *)partitionUsingBlock:(NSUInteger (^)(id obj))block; {
+    return [self partitionWithOptions:0 usingBlock:block];
+}
+
+- (NSArray *)partitionWithOptions:(NSEnumerationOptions)opts usingBlock:(NSUInteger (^)(id obj))block; {
+    NSParameterAssert(block != nil);
+
+    NSUInteger count = [self count];
+
+    PROAutomaticEnumeration automaticEnumeration = PROBeginAutomaticEnumeration(&opts, count, block);
+    @onExit {
+        PROEndAutomaticEnumeration(automaticEnumeration);
+    };
+
+    BOOL concurrent = (opts & NSEnumerationConcurrent);
+    BOOL reverse = (opts & NSEnumerationReverse);
+
+    // each chunk distributes into its own buckets, and the buckets of later
+    // chunks are then appended to the buckets of earlier ones
+    return PROConcurrentReduce(count, (concurrent ? 0 : count), [NSArray array], ^ id (NSRange range){
+        NSMutableArray *chunkBuckets = [[NSMutableArray alloc] init];
+
+        for (NSUInteger position = range.location; position < NSMaxRange(range); ++position) {
+            id obj = [self objectAtIndex:(reverse ? count - position - 1 : position)];
+
+            NSUInteger bucketIndex = block(obj);
+            if (bucketIndex == NSNotFound)
+                continue;
+
+            while (chunkBuckets.count <= bucketIndex) {
+                [chunkBuckets addObject:[[NSMutableArray alloc] init]];
+            }
+
+            [[chunkBuckets objectAtIndex:bucketIndex] addObject:obj];
+        }
+
+        return chunkBuckets;
+    }, ^(NSMutableArray *leftBuckets, NSArray *rightBuckets){
+        [rightBuckets enumerateObjectsUsingBlock:^(NSMutableArray *rightBucket, NSUInteger bucketIndex, BOOL *stop){
+            if (bucketIndex < leftBuckets.count)
+                [[leftBuckets objectAtIndex:bucketIndex] addObjectsFromArray:rightBucket];
+            else
+                [leftBuckets addObject:rightBucket];
+        }];
+
+        return leftBuckets;
+    });
+}
+
+- (id)reduceWithIdentity:(id)identity usingBlock:(id (^)(id left, id right))block; {
+    NSParameterAssert(block != nil);
+
+    return PROConcurrentReduce(self.count, 0, identity, ^ id (NSRange range){
+        id value = identity;
+
+        for (NSUInteger index = range.location; index < NSMaxRange(range); ++index) {
+            value = block(value, [self objectAtIndex:index]);
+        }
+
+        return value;
+    }, block);
+}
+
 @end
@@ -8,11 +8,65 @@
 
 #import <Foundation/Foundation.h>
 
+/**
+ * An option which may be included in the `NSEnumerationOptions` passed to
+ * <[NSArray enumerateTreeWithOptions:nodeKeyPath:usingBlock:]>, to visit each
+ * node after its descendants, instead of before.
+ */
+enum {
+    PROTreeEnumerationPostOrder = (1UL << 17)
+};
+
 /**
  * Extensions for using index paths with `NSArray`.
  */
 @interface NSArray (IndexPathAdditions)
 
+/**
+ * @name Enumerating Trees
+ */
+
+/**
+ * Invokes <enumerateTreeWithOptions:nodeKeyPath:usingBlock:> with no options
+ * and a `nil` key path.
+ */
+- (void)enumerateTreeUsingBlock:(void (^)(id obj, NSUInteger depth, const NSUInteger *indexes, BOOL *skipDescendants, BOOL *stop))block;
+
+/**
+ * Enumerates every object in the tree of nested arrays rooted at the receiver,
+ * depth-first.
+ *
+ * The children of each object are found in the same manner as
+ * <objectAtIndexPath:nodeKeyPath:>: if `nodeKeyPath` is not `nil`, the object
+ * receives a `valueForKeyPath:` message with it, and the result is used.
+ * Otherwise, the object itself is used. If the children are not an array, the
+ * object is treated as a leaf. When using a key path, every object in the tree
+ * (including leaves) must be key-value coding compliant for it.
+ *
+ * The traversal keeps its own stack, rather than recursing, and reuses a single
+ * buffer for the index path of the current object, so nothing is allocated
+ * for each object visited.
+ *
+ * @param opts A mask of `NSEnumerationOptions` to apply when enumerating. With
+ * `NSEnumerationReverse`, the children of each object are visited from last to
+ * first. With `NSEnumerationConcurrent`, the subtrees of the receiver's objects
+ * are enumerated concurrently, though each subtree is still enumerated in
+ * order. With <PROTreeEnumerationPostOrder>, each object is visited after its
+ * descendants, instead of before.
+ * @param nodeKeyPath If not `nil`, each object will receive a `valueForKeyPath:`
+ * message with this key path, and the result will be used as its children.
+ * @param block A block to invoke for each object in the tree. The block is
+ * passed the object, its depth (which is zero for objects of the receiver),
+ * and its index path relative to the receiver, which contains `depth + 1`
+ * indexes and is only valid until the block returns. The block may set
+ * `skipDescendants` to `YES` to avoid visiting the descendants of the object
+ * (which has no effect when visiting in post-order), or `stop` to `YES` to end
+ * the enumeration. If the enumeration is concurrent, this block must be
+ * thread-safe, and other subtrees may still be visited briefly after `stop` is
+ * set.
+ */
+- (void)enumerateTreeWithOptions:(NSEnumerationOptions)opts nodeKeyPath:(NSString *)nodeKeyPath usingBlock:(void (^)(id obj, NSUInteger depth, const NSUInteger *indexes, BOOL *skipDescendants, BOOL *stop))block;
+
 /**
  * @name Retrieving Objects at Index Paths
  */
@@ -46,4 +100,44 @@
  */
 - (id)objectAtIndexPath:(NSIndexPath *)indexPath nodeKeyPath:(NSString *)nodeKeyPath;
 
+/**
+ * Returns the object at the path described by the given indexes, with the same
+ * semantics as <objectAtIndexPath:nodeKeyPath:>.
+ *
+ * This avoids the need to create an `NSIndexPath`, and can be used directly
+ * with the indexes of a <PROIndexPath>.
+ *
+ * @param indexes The indexes of the path from which to return an object. This
+ * may be `NULL` if `length` is zero.
+ * @param length The number of indexes in `indexes`. If this is zero, the
+ * receiver is returned.
+ * @param nodeKeyPath If not `nil`, each index prior to the last will receive
+ * a `valueForKeyPath:` message with this key path, and the result will be used
+ * for further indexing.
+ */
+- (id)objectAtIndexes:(const NSUInteger *)indexes length:(NSUInteger)length nodeKeyPath:(NSString *)nodeKeyPath;
+
+/**
+ * Invokes <objectsAtIndexPaths:nodeKeyPath:> with a `nil` key path.
+ */
+- (NSArray *)objectsAtIndexPaths:(NSArray *)indexPaths;
+
+/**
+ * Returns the objects at the given index paths relative to the receiver, in the
+ * same order as `indexPaths`.
+ *
+ * This is equivalent to invoking <objectAtIndexPath:nodeKeyPath:> for each
+ * index path, but the paths are visited in sorted order with a
+ * <PROTreeCursor>, so that each node shared by multiple paths is only resolved
+ * once.
+ *
+ * @param indexPaths An array of `NSIndexPath` objects. For any path which does
+ * not correspond to an object (because an index is out of range, or a node
+ * along the way has no children), the result will be `NSNull`.
+ * @param nodeKeyPath If not `nil`, each index prior to the last will receive
+ * a `valueForKeyPath:` message with this key path, and the result will be used
+ * for further indexing.
+ */
+- (NSArray *)objectsAtIndexPaths:(NSArray *)indexPaths nodeKeyPath:(NSString *)nodeKeyPath;
+
 @end
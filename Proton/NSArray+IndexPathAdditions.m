@@ -8,9 +8,164 @@
 
 #import "NSArray+IndexPathAdditions.h"
 #import "EXTSafeCategory.h"
+#import "EXTScope.h"
+#import "PROAssert.h"
+#import "PROConcurrentFunctions.h"
+#import "PROKeyPath.h"
+#import "PROTreeCursor.h"
+
+/**
+ * Invokes `block` for a node of a tree being enumerated, returning whether
+ * enumeration should continue.
+ */
+static BOOL visitTreeNode (void (^block)(id, NSUInteger, const NSUInteger *, BOOL *, BOOL *), id obj, NSUInteger depth, const NSUInteger *indexes, BOOL *skipDescendants, volatile BOOL *stopped) {
+    BOOL stop = NO;
+    block(obj, depth, indexes, skipDescendants, &stop);
+
+    if (stop)
+        *stopped = YES;
+
+    return !*stopped;
+}
+
+/**
+ * Enumerates the subtrees of the objects at the given positions of `rootArray`,
+ * without recursion, and without allocating anything for each node visited.
+ *
+ * @param rootArray The array at the root of the tree.
+ * @param rootRange The range of positions in `rootArray` whose subtrees should
+ * be enumerated. If `reverse` is `YES`, positions are counted from the end of
+ * each array.
+ * @param nodeKeyPath The key path used to get from a node to its children, or
+ * `nil` if nodes are themselves arrays.
+ * @param postOrder Whether to visit each node after its children, instead of
+ * before.
+ * @param reverse Whether to visit the children of each node from last to first.
+ * @param stopped A flag shared between concurrent enumerations, which is set to
+ * `YES` when any of them should stop.
+ * @param block The block to invoke for each node.
+ */
+static void enumerateTree (NSArray *rootArray, NSRange rootRange, PROKeyPath *nodeKeyPath, BOOL postOrder, BOOL reverse, volatile BOOL *stopped, void (^block)(id, NSUInteger, const NSUInteger *, BOOL *, BOOL *)) {
+    // the arrays of children at each level of the current path
+    NSMutableArray *containers = [[NSMutableArray alloc] initWithObjects:rootArray, nil];
+
+    // the position of the current path at each level, and the actual index of
+    // the object at each position (which differs if 'reverse' is YES)
+    //
+    // these are __block so that the cleanup block sees them after they've been
+    // reallocated
+    NSUInteger capacity = 16;
+    __block NSUInteger *positions = malloc(capacity * sizeof(*positions));
+    __block NSUInteger *indexes = malloc(capacity * sizeof(*indexes));
+
+    @onExit {
+        free(positions);
+        free(indexes);
+    };
+
+    if (!PROAssert(positions && indexes, @"Could not allocate space for %lu indexes", (unsigned long)capacity))
+        return;
+
+    NSUInteger depth = 0;
+    positions[0] = rootRange.location;
+
+    for (;;) {
+        NSArray *container = [containers objectAtIndex:depth];
+        NSUInteger count = container.count;
+        NSUInteger limit = (depth ? count : NSMaxRange(rootRange));
+
+        if (positions[depth] >= limit) {
+            // finished with this level, so move back up to the parent
+            if (!depth)
+                break;
+
+            [containers removeLastObject];
+            --depth;
+
+            if (postOrder) {
+                id parent = [[containers objectAtIndex:depth] objectAtIndex:indexes[depth]];
+
+                BOOL skipDescendants = NO;
+                if (!visitTreeNode(block, parent, depth, indexes, &skipDescendants, stopped))
+                    return;
+            }
+
+            ++positions[depth];
+            continue;
+        }
+
+        if (*stopped)
+            return;
+
+        NSUInteger position = positions[depth];
+        NSUInteger index = (reverse ? count - position - 1 : position);
+        indexes[depth] = index;
+
+        id obj = [container objectAtIndex:index];
+
+        BOOL skipDescendants = NO;
+        if (!postOrder && !visitTreeNode(block, obj, depth, indexes, &skipDescendants, stopped))
+            return;
+
+        if (!skipDescendants) {
+            id children = (nodeKeyPath ? [nodeKeyPath valueForObject:obj] : obj);
+
+            if ([children isKindOfClass:[NSArray class]] && [children count]) {
+                if (depth + 1 >= capacity) {
+                    capacity *= 2;
+
+                    NSUInteger *newPositions = realloc(positions, capacity * sizeof(*positions));
+                    if (!PROAssert(newPositions, @"Could not allocate space for %lu indexes", (unsigned long)capacity))
+                        return;
+
+                    positions = newPositions;
+
+                    NSUInteger *newIndexes = realloc(indexes, capacity * sizeof(*indexes));
+                    if (!PROAssert(newIndexes, @"Could not allocate space for %lu indexes", (unsigned long)capacity))
+                        return;
+
+                    indexes = newIndexes;
+                }
+
+                [containers addObject:children];
+
+                ++depth;
+                positions[depth] = 0;
+                continue;
+            }
+        }
+
+        if (postOrder && !visitTreeNode(block, obj, depth, indexes, &skipDescendants, stopped))
+            return;
+
+        ++positions[depth];
+    }
+}
 
 @safecategory (NSArray, IndexPathAdditions)
 
+- (void)enumerateTreeUsingBlock:(void (^)(id obj, NSUInteger depth, const NSUInteger *indexes, BOOL *skipDescendants, BOOL *stop))block; {
+    [self enumerateTreeWithOptions:0 nodeKeyPath:nil usingBlock:block];
+}
+
+- (void)enumerateTreeWithOptions:(NSEnumerationOptions)opts nodeKeyPath:(NSString *)nodeKeyPath usingBlock:(void (^)(id obj, NSUInteger depth, const NSUInteger *indexes, BOOL *skipDescendants, BOOL *stop))block; {
+    NSParameterAssert(block != nil);
+
+    BOOL concurrent = (opts & NSEnumerationConcurrent);
+    BOOL reverse = (opts & NSEnumerationReverse);
+    BOOL postOrder = (opts & PROTreeEnumerationPostOrder);
+
+    NSUInteger count = self.count;
+    __block volatile BOOL stopped = NO;
+
+    PROKeyPath *compiledKeyPath = (nodeKeyPath ? [PROKeyPath keyPathWithString:nodeKeyPath] : nil);
+
+    // concurrent enumeration splits up the subtrees of the top-level objects
+    PROConcurrentEnumerateChunks(count, (concurrent ? 0 : count), ^(NSUInteger chunkIndex, NSRange range){
+        enumerateTree(self, range, compiledKeyPath, postOrder, reverse, &stopped, block);
+    });
+}
+
 - (id)objectAtIndexPath:(NSIndexPath *)indexPath; {
     return [self objectAtIndexPath:indexPath nodeKeyPath:nil];
 }
@@ -20,24 +175,69 @@
 
     NSUInteger length = indexPath.length;
 
+    NSUInteger indexes[length + 1];
+    [indexPath getIndexes:indexes];
+
+    return [self objectAtIndexes:indexes length:length nodeKeyPath:nodeKeyPath];
+}
+
+- (id)objectAtIndexes:(const NSUInteger *)indexes length:(NSUInteger)length nodeKeyPath:(NSString *)nodeKeyPath; {
+    NSParameterAssert(indexes != NULL || !length);
+
     id object = self;
-    if (length) {
-        NSUInteger indexes[length];
-        [indexPath getIndexes:indexes];
+    PROKeyPath *compiledKeyPath = (nodeKeyPath && length > 1 ? [PROKeyPath keyPathWithString:nodeKeyPath] : nil);
 
-        for (NSUInteger i = 0; i < length; ++i) {
-            if (![object isKindOfClass:[NSArray class]])
-                return nil;
+    for (NSUInteger i = 0; i < length; ++i) {
+        if (![object isKindOfClass:[NSArray class]])
+            return nil;
 
-            NSUInteger index = indexes[i];
-            object = [object objectAtIndex:index];
+        NSUInteger index = indexes[i];
+        object = [object objectAtIndex:index];
 
-            if (i + 1 < length && nodeKeyPath)
-                object = [object valueForKeyPath:nodeKeyPath];
-        }
+        if (i + 1 < length && compiledKeyPath)
+            object = [compiledKeyPath valueForObject:object];
     }
 
     return object;
 }
 
+- (NSArray *)objectsAtIndexPaths:(NSArray *)indexPaths; {
+    return [self objectsAtIndexPaths:indexPaths nodeKeyPath:nil];
+}
+
+- (NSArray *)objectsAtIndexPaths:(NSArray *)indexPaths nodeKeyPath:(NSString *)nodeKeyPath; {
+    NSParameterAssert(indexPaths);
+
+    NSUInteger count = indexPaths.count;
+
+    // visit the paths in sorted order, so that paths with a common prefix are
+    // adjacent, and the cursor only has to resolve the part that differs
+    NSMutableArray *sortedPositions = [[NSMutableArray alloc] initWithCapacity:count];
+    NSMutableArray *results = [[NSMutableArray alloc] initWithCapacity:count];
+
+    for (NSUInteger position = 0; position < count; ++position) {
+        [sortedPositions addObject:[NSNumber numberWithUnsignedInteger:position]];
+        [results addObject:[NSNull null]];
+    }
+
+    [sortedPositions sortUsingComparator:^(NSNumber *left, NSNumber *right){
+        NSIndexPath *leftPath = [indexPaths objectAtIndex:[left unsignedIntegerValue]];
+        NSIndexPath *rightPath = [indexPaths objectAtIndex:[right unsignedIntegerValue]];
+
+        return [leftPath compare:rightPath];
+    }];
+
+    PROTreeCursor *cursor = [[PROTreeCursor alloc] initWithRootArray:self nodeKeyPath:nodeKeyPath];
+
+    for (NSNumber *positionNumber in sortedPositions) {
+        NSUInteger position = [positionNumber unsignedIntegerValue];
+
+        id object = [cursor objectAtIndexPath:[indexPaths objectAtIndex:position]];
+        if (object)
+            [results replaceObjectAtIndex:position withObject:object];
+    }
+
+    return results;
+}
+
 @end
@@ -14,6 +14,72 @@
  */
 @interface NSArray (SearchAdditions)
 
+/**
+ * Returns the range of objects in the receiver which are equal to `obj`,
+ * according to `comparator`.
+ *
+ * The receiver must already be sorted using `comparator`. If there are no equal
+ * objects, the `length` of the returned range is zero, and its `location` is
+ * the index at which `obj` could be inserted while keeping the receiver sorted.
+ *
+ * @param obj The object to search for.
+ * @param comparator The block which was used to sort the receiver.
+ */
+- (NSRange)equalRangeOfObject:(id)obj usingComparator:(NSComparator)comparator;
+
+/**
+ * Computes the changes needed to turn the receiver into `otherArray`, using
+ * Myers' O(ND) difference algorithm.
+ *
+ * The running time is proportional to the total size of the arrays plus the
+ * square of the number of changes, and only linear space is used. Arrays which
+ * are mostly unchanged (like successive snapshots of a model) are cheap to
+ * compare, since any common prefix and suffix is skipped immediately.
+ *
+ * Objects are compared with `isEqual:`, so they must also implement `hash`
+ * consistently.
+ *
+ * @param otherArray The array to compare with the receiver.
+ * @param deletedIndexes If not `NULL`, this will be set to the indexes of
+ * objects in the receiver which are not in `otherArray`.
+ * @param insertedIndexes If not `NULL`, this will be set to the indexes of
+ * objects in `otherArray` which are not in the receiver.
+ * @param movedIndexes If not `NULL`, this will be set to a dictionary mapping
+ * the index of each moved object in the receiver to its index in `otherArray`,
+ * both as `NSNumber` objects. Moved objects are not included in
+ * `deletedIndexes` or `insertedIndexes`. If this argument is `NULL`, moves are
+ * instead reported as a deletion and an insertion.
+ */
+- (void)getDifferencesWithArray:(NSArray *)otherArray deletedIndexes:(NSIndexSet **)deletedIndexes insertedIndexes:(NSIndexSet **)insertedIndexes movedIndexes:(NSDictionary **)movedIndexes;
+
+/**
+ * Computes the changes needed to turn the receiver into `otherArray`, in the
+ * same manner as <getDifferencesWithArray:deletedIndexes:insertedIndexes:movedIndexes:>,
+ * but comparing objects with pointer equality.
+ *
+ * @param otherArray The array to compare with the receiver.
+ * @param deletedIndexes If not `NULL`, this will be set to the indexes of
+ * objects in the receiver which are not in `otherArray`.
+ * @param insertedIndexes If not `NULL`, this will be set to the indexes of
+ * objects in `otherArray` which are not in the receiver.
+ * @param movedIndexes If not `NULL`, this will be set to a dictionary mapping
+ * the index of each moved object in the receiver to its index in `otherArray`,
+ * both as `NSNumber` objects.
+ */
+- (void)getIdentityDifferencesWithArray:(NSArray *)otherArray deletedIndexes:(NSIndexSet **)deletedIndexes insertedIndexes:(NSIndexSet **)insertedIndexes movedIndexes:(NSDictionary **)movedIndexes;
+
+/**
+ * Returns the index of the first object in the receiver which is not less than
+ * `obj`, according to `comparator`, or the count of the receiver if there is no
+ * such object.
+ *
+ * The receiver must already be sorted using `comparator`.
+ *
+ * @param obj The object to search for.
+ * @param comparator The block which was used to sort the receiver.
+ */
+- (NSUInteger)lowerBoundOfObject:(id)obj usingComparator:(NSComparator)comparator;
+
 /**
  * Invokes <longestSubarrayCommonWithArray:subarrayRange:> with `NULL` range
  * pointers.
@@ -60,4 +126,116 @@
  */
 - (NSArray *)longestSubarrayIdenticalWithArray:(NSArray *)otherArray rangeInReceiver:(NSRangePointer)rangeInReceiver rangeInOtherArray:(NSRangePointer)rangeInOtherArray;
 
+/**
+ * Invokes <longestSubsequenceCommonWithArray:indexesInReceiver:indexesInOtherArray:>
+ * with `NULL` index set pointers.
+ */
+- (NSArray *)longestSubsequenceCommonWithArray:(NSArray *)otherArray;
+
+/**
+ * Returns the longest subsequence that the receiver has in common with the
+ * given array, or `nil` if the two arrays have nothing in common.
+ *
+ * Unlike a subarray, the objects of a subsequence need not be adjacent in
+ * either array, but they must appear in the same order. Comparison of each
+ * object is performed with `isEqual:`, so objects must also implement `hash`
+ * consistently.
+ *
+ * Objects are mapped to integer symbols before the search begins, and the
+ * search itself compares 64 positions at a time with bitwise arithmetic. The
+ * running time is proportional to the product of the array sizes divided by
+ * 64, and only linear space is used.
+ *
+ * @param otherArray The array to compare with the receiver.
+ * @param indexesInReceiver If not `NULL`, this will be set to the indexes in the
+ * receiver of the objects in the returned subsequence.
+ * @param indexesInOtherArray If not `NULL`, this will be set to the indexes in
+ * `otherArray` of the objects in the returned subsequence.
+ */
+- (NSArray *)longestSubsequenceCommonWithArray:(NSArray *)otherArray indexesInReceiver:(NSIndexSet **)indexesInReceiver indexesInOtherArray:(NSIndexSet **)indexesInOtherArray;
+
+/**
+ * Invokes <longestSubsequenceIdenticalWithArray:indexesInReceiver:indexesInOtherArray:>
+ * with `NULL` index set pointers.
+ */
+- (NSArray *)longestSubsequenceIdenticalWithArray:(NSArray *)otherArray;
+
+/**
+ * Returns the longest subsequence that has identical objects in the receiver
+ * and the given array, or `nil` if the two arrays have nothing in common.
+ *
+ * This behaves like
+ * <longestSubsequenceCommonWithArray:indexesInReceiver:indexesInOtherArray:>,
+ * except that comparison of each object is performed with pointer equality.
+ *
+ * @param otherArray The array to compare with the receiver.
+ * @param indexesInReceiver If not `NULL`, this will be set to the indexes in the
+ * receiver of the objects in the returned subsequence.
+ * @param indexesInOtherArray If not `NULL`, this will be set to the indexes in
+ * `otherArray` of the objects in the returned subsequence.
+ */
+- (NSArray *)longestSubsequenceIdenticalWithArray:(NSArray *)otherArray indexesInReceiver:(NSIndexSet **)indexesInReceiver indexesInOtherArray:(NSIndexSet **)indexesInOtherArray;
+
+/**
+ * Returns a sorted array of the objects which are in both the receiver and
+ * `otherArray`.
+ *
+ * Both arrays must already be sorted using `comparator`. An object which occurs
+ * multiple times is included as many times as it occurs in the array
+ * containing fewer copies. When objects compare equal, the object from the
+ * receiver is used.
+ *
+ * Instead of stepping through every object, this method uses exponential
+ * searches to skip over runs of objects which are not in the other array. The
+ * intersection of a small array with a large one therefore takes time
+ * proportional to the size of the small array times the logarithm of the size
+ * of the large one.
+ *
+ * @param otherArray A sorted array to intersect with the receiver.
+ * @param comparator The block which was used to sort both arrays.
+ */
+- (NSArray *)sortedArrayByIntersectingSortedArray:(NSArray *)otherArray usingComparator:(NSComparator)comparator;
+
+/**
+ * Returns a sorted array of the objects in the receiver which are not in
+ * `otherArray`.
+ *
+ * Both arrays must already be sorted using `comparator`. An object which occurs
+ * multiple times is removed as many times as it occurs in `otherArray`. Runs of
+ * objects are skipped using exponential searches, in the same manner as
+ * <sortedArrayByIntersectingSortedArray:usingComparator:>.
+ *
+ * @param otherArray A sorted array of objects to remove from the receiver.
+ * @param comparator The block which was used to sort both arrays.
+ */
+- (NSArray *)sortedArrayBySubtractingSortedArray:(NSArray *)otherArray usingComparator:(NSComparator)comparator;
+
+/**
+ * Returns a sorted array of the objects which are in either the receiver or
+ * `otherArray`.
+ *
+ * Both arrays must already be sorted using `comparator`. An object which occurs
+ * multiple times is included as many times as it occurs in the array
+ * containing more copies. When objects compare equal, the object from the
+ * receiver is used. Runs of objects from either array are found using
+ * exponential searches and copied all at once, in the same manner as
+ * <sortedArrayByIntersectingSortedArray:usingComparator:>.
+ *
+ * @param otherArray A sorted array to unite with the receiver.
+ * @param comparator The block which was used to sort both arrays.
+ */
+- (NSArray *)sortedArrayByUnioningSortedArray:(NSArray *)otherArray usingComparator:(NSComparator)comparator;
+
+/**
+ * Returns the index of the first object in the receiver which is greater than
+ * `obj`, according to `comparator`, or the count of the receiver if there is no
+ * such object.
+ *
+ * The receiver must already be sorted using `comparator`.
+ *
+ * @param obj The object to search for.
+ * @param comparator The block which was used to sort the receiver.
+ */
+- (NSUInteger)upperBoundOfObject:(id)obj usingComparator:(NSComparator)comparator;
+
 @end
@@ -10,11 +10,49 @@
 #import "EXTSafeCategory.h"
 #import "EXTScope.h"
 #import "PROAssert.h"
+#import "PROSearchIndex.h"
+
+/**
+ * Creates a dictionary for use with <symbolizeArray>, which compares objects
+ * using `-hash` and `-isEqual:` if `checkForEquality` is `YES`, or by pointer
+ * identity otherwise.
+ */
+static CFMutableDictionaryRef createSymbolDictionary (BOOL checkForEquality) {
+    return CFDictionaryCreateMutable(NULL, 0, (checkForEquality ? &kCFTypeDictionaryKeyCallBacks : NULL), NULL);
+}
+
+/**
+ * Converts each object of `array` into an integer symbol, writing the symbols
+ * into `symbols`, such that two objects have the same symbol if and only if
+ * they compare equal according to `symbolsByObject`.
+ *
+ * Objects which are not already in `symbolsByObject` are added with a new
+ * symbol, so the same dictionary can be used to symbolize multiple arrays
+ * consistently.
+ */
+static void symbolizeArray (NSArray *array, CFMutableDictionaryRef symbolsByObject, NSUInteger *symbols) {
+    NSUInteger index = 0;
+
+    for (id obj in array) {
+        const void *symbolValue = NULL;
+
+        if (!CFDictionaryGetValueIfPresent(symbolsByObject, (__bridge void *)obj, &symbolValue)) {
+            symbolValue = (const void *)(uintptr_t)CFDictionaryGetCount(symbolsByObject);
+            CFDictionarySetValue(symbolsByObject, (__bridge void *)obj, symbolValue);
+        }
+
+        symbols[index++] = (NSUInteger)symbolValue;
+    }
+}
 
 /**
  * Worker function for the longest subarray methods, with support for checking
  * for equality or identity.
  *
+ * A <PROSearchIndex> is built over `otherArray`, and then the receiver is run
+ * through it, which finds the longest common subarray in time linear in the
+ * total length of both arrays.
+ *
  * @param self The first array to compare.
  * @param otherArray The second array to compare.
  * @param checkForEquality Whether `isEqual:` should be used to compare each
@@ -27,90 +65,756 @@
  * `nil`, the `location` of the range will be `NSNotFound`.
  */
 static NSArray *longestSubarray (NSArray *self, NSArray *otherArray, BOOL checkForEquality, NSRangePointer rangeInReceiver, NSRangePointer rangeInOtherArray) {
-    if (!self.count || !otherArray.count) {
-        if (rangeInReceiver)
-            *rangeInReceiver = NSMakeRange(NSNotFound, 0);
+    if (rangeInReceiver)
+        *rangeInReceiver = NSMakeRange(NSNotFound, 0);
 
-        if (rangeInOtherArray)
-            *rangeInOtherArray = NSMakeRange(NSNotFound, 0);
+    if (rangeInOtherArray)
+        *rangeInOtherArray = NSMakeRange(NSNotFound, 0);
 
+    if (!self.count || !otherArray.count)
         return nil;
+
+    PROSearchIndex *searchIndex = [[PROSearchIndex alloc] initWithArray:otherArray comparesIdentity:!checkForEquality];
+    return [searchIndex longestSubarrayCommonWithArray:self rangeInArray:rangeInReceiver rangeInIndexedArray:rangeInOtherArray];
+}
+
+/**
+ * Finds the point at which to split a shortest edit script from `oldSymbols`
+ * to `newSymbols` into two halves, by running Myers' algorithm forward from the
+ * start and backward from the end at the same time, until the two paths
+ * overlap.
+ *
+ * This returns `NO` if the paths never overlap (which only happens if the
+ * sequences have nothing in common).
+ *
+ * @param oldSymbols The symbols of the old sequence.
+ * @param oldCount The number of symbols in `oldSymbols`.
+ * @param newSymbols The symbols of the new sequence.
+ * @param newCount The number of symbols in `newSymbols`.
+ * @param forward Scratch space for the furthest forward paths, with room for at
+ * least `oldCount + newCount + 2` integers.
+ * @param backward Scratch space for the furthest backward paths, of the same
+ * size as `forward`.
+ * @param oldSplit On success, set to the index in `oldSymbols` at which to
+ * split.
+ * @param newSplit On success, set to the index in `newSymbols` at which to
+ * split.
+ */
+static BOOL findMiddleOfEditScript (const NSUInteger *oldSymbols, NSInteger oldCount, const NSUInteger *newSymbols, NSInteger newCount, NSInteger *forward, NSInteger *backward, NSInteger *oldSplit, NSInteger *newSplit) {
+    NSInteger maximumDistance = (oldCount + newCount + 1) / 2;
+    NSInteger offset = maximumDistance;
+    NSInteger length = 2 * maximumDistance + 2;
+
+    for (NSInteger i = 0; i < length; ++i) {
+        forward[i] = -1;
+        backward[i] = -1;
     }
 
-    NSUInteger selfCount = self.count;
-    NSUInteger otherCount = otherArray.count;
-    
-    __block NSUInteger *current = calloc(otherCount, sizeof(*current));
-    if (!PROAssert(current, @"Could not allocate space for %lu integers", (unsigned long)otherCount))
-        return nil;
+    forward[offset + 1] = 0;
+    backward[offset + 1] = 0;
+
+    NSInteger delta = oldCount - newCount;
+
+    // if the difference in lengths is odd, the forward path will be the one to
+    // overlap first
+    BOOL checkForward = (delta % 2 != 0);
+
+    // diagonals which have run off the edge of the edit graph, and don't need
+    // to be considered anymore
+    NSInteger forwardStart = 0;
+    NSInteger forwardEnd = 0;
+    NSInteger backwardStart = 0;
+    NSInteger backwardEnd = 0;
+
+    for (NSInteger distance = 0; distance < maximumDistance; ++distance) {
+        for (NSInteger diagonal = -distance + forwardStart; diagonal <= distance - forwardEnd; diagonal += 2) {
+            NSInteger index = offset + diagonal;
+            NSInteger x;
+
+            if (diagonal == -distance || (diagonal != distance && forward[index - 1] < forward[index + 1]))
+                x = forward[index + 1];
+            else
+                x = forward[index - 1] + 1;
+
+            NSInteger y = x - diagonal;
+
+            // follow the snake of matching symbols
+            while (x < oldCount && y < newCount && oldSymbols[x] == newSymbols[y]) {
+                ++x;
+                ++y;
+            }
+
+            forward[index] = x;
+
+            if (x > oldCount) {
+                forwardEnd += 2;
+            } else if (y > newCount) {
+                forwardStart += 2;
+            } else if (checkForward) {
+                NSInteger backwardIndex = offset + delta - diagonal;
+
+                if (backwardIndex >= 0 && backwardIndex < length && backward[backwardIndex] != -1) {
+                    if (x >= oldCount - backward[backwardIndex]) {
+                        *oldSplit = x;
+                        *newSplit = y;
+                        return YES;
+                    }
+                }
+            }
+        }
+
+        for (NSInteger diagonal = -distance + backwardStart; diagonal <= distance - backwardEnd; diagonal += 2) {
+            NSInteger index = offset + diagonal;
+            NSInteger x;
+
+            if (diagonal == -distance || (diagonal != distance && backward[index - 1] < backward[index + 1]))
+                x = backward[index + 1];
+            else
+                x = backward[index - 1] + 1;
+
+            NSInteger y = x - diagonal;
+
+            while (x < oldCount && y < newCount && oldSymbols[oldCount - x - 1] == newSymbols[newCount - y - 1]) {
+                ++x;
+                ++y;
+            }
+
+            backward[index] = x;
+
+            if (x > oldCount) {
+                backwardEnd += 2;
+            } else if (y > newCount) {
+                backwardStart += 2;
+            } else if (!checkForward) {
+                NSInteger forwardIndex = offset + delta - diagonal;
+
+                if (forwardIndex >= 0 && forwardIndex < length && forward[forwardIndex] != -1) {
+                    NSInteger forwardX = forward[forwardIndex];
+                    NSInteger forwardY = offset + forwardX - forwardIndex;
+
+                    if (forwardX >= oldCount - x) {
+                        *oldSplit = forwardX;
+                        *newSplit = forwardY;
+                        return YES;
+                    }
+                }
+            }
+        }
+    }
+
+    return NO;
+}
+
+/**
+ * Computes a shortest edit script from `oldSymbols` to `newSymbols` with Myers'
+ * O(ND) algorithm, in linear space, marking every deleted and inserted
+ * position.
+ *
+ * @param oldSymbols The symbols of the old sequence.
+ * @param oldCount The number of symbols in `oldSymbols`.
+ * @param newSymbols The symbols of the new sequence.
+ * @param newCount The number of symbols in `newSymbols`.
+ * @param deleted An array of flags for each position of `oldSymbols`, which
+ * will be set to `YES` for each deleted position.
+ * @param inserted An array of flags for each position of `newSymbols`, which
+ * will be set to `YES` for each inserted position.
+ * @param forward Scratch space for <findMiddleOfEditScript>.
+ * @param backward Scratch space for <findMiddleOfEditScript>.
+ */
+static void findEditScript (const NSUInteger *oldSymbols, NSInteger oldCount, const NSUInteger *newSymbols, NSInteger newCount, BOOL *deleted, BOOL *inserted, NSInteger *forward, NSInteger *backward) {
+    // skip any common prefix and suffix, which is all that needs to be done for
+    // mostly-unchanged sequences
+    while (oldCount && newCount && *oldSymbols == *newSymbols) {
+        ++oldSymbols;
+        ++newSymbols;
+        ++deleted;
+        ++inserted;
+        --oldCount;
+        --newCount;
+    }
+
+    while (oldCount && newCount && oldSymbols[oldCount - 1] == newSymbols[newCount - 1]) {
+        --oldCount;
+        --newCount;
+    }
+
+    NSInteger oldSplit;
+    NSInteger newSplit;
+
+    if (!oldCount || !newCount || !findMiddleOfEditScript(oldSymbols, oldCount, newSymbols, newCount, forward, backward, &oldSplit, &newSplit)) {
+        for (NSInteger i = 0; i < oldCount; ++i) {
+            deleted[i] = YES;
+        }
+
+        for (NSInteger i = 0; i < newCount; ++i) {
+            inserted[i] = YES;
+        }
+
+        return;
+    }
+
+    findEditScript(oldSymbols, oldSplit, newSymbols, newSplit, deleted, inserted, forward, backward);
+    findEditScript(oldSymbols + oldSplit, oldCount - oldSplit, newSymbols + newSplit, newCount - newSplit, deleted + oldSplit, inserted + newSplit, forward, backward);
+}
+
+/**
+ * Returns an index set containing every index for which `flags` is `YES`.
+ */
+static NSIndexSet *indexSetFromFlags (const BOOL *flags, NSUInteger count) {
+    NSMutableIndexSet *indexSet = [NSMutableIndexSet indexSet];
+    NSUInteger index = 0;
 
+    while (index < count) {
+        if (!flags[index]) {
+            ++index;
+            continue;
+        }
+
+        NSUInteger start = index;
+        while (index < count && flags[index]) {
+            ++index;
+        }
+
+        [indexSet addIndexesInRange:NSMakeRange(start, index - start)];
+    }
+
+    return indexSet;
+}
+
+/**
+ * Worker function for the difference methods, with support for checking for
+ * equality or identity.
+ *
+ * @param self The old array.
+ * @param otherArray The new array.
+ * @param checkForEquality Whether `isEqual:` should be used to compare each
+ * object. If `NO`, pointer equality is used instead.
+ * @param deletedIndexes If not `NULL`, set to the indexes in `self` of objects
+ * which were removed.
+ * @param insertedIndexes If not `NULL`, set to the indexes in `otherArray` of
+ * objects which were added.
+ * @param movedIndexes If not `NULL`, set to a dictionary mapping the indexes in
+ * `self` of objects which were moved to their new indexes in `otherArray`.
+ * This dictionary uses `NSNumber` objects for both keys and values. If `NULL`,
+ * moved objects are instead included in both `deletedIndexes` and
+ * `insertedIndexes`.
+ */
+static void differences (NSArray *self, NSArray *otherArray, BOOL checkForEquality, NSIndexSet **deletedIndexes, NSIndexSet **insertedIndexes, NSDictionary **movedIndexes) {
+    NSUInteger oldCount = self.count;
+    NSUInteger newCount = otherArray.count;
+
+    CFMutableDictionaryRef symbolsByObject = createSymbolDictionary(checkForEquality);
     @onExit {
-        free(current);
+        CFRelease(symbolsByObject);
     };
 
-    __block NSUInteger *previous = calloc(otherCount, sizeof(*previous));
-    if (!PROAssert(previous, @"Could not allocate space for %lu integers", (unsigned long)otherCount))
-        return nil;
+    // allocate one buffer for all of the symbols and flags, since they're all
+    // proportional in size
+    NSUInteger scratchCount = oldCount + newCount + 2;
+    size_t bufferSize = (oldCount + newCount) * (sizeof(NSUInteger) + sizeof(BOOL)) + scratchCount * 2 * sizeof(NSInteger);
+
+    void *buffer = calloc(1, bufferSize);
+    if (!PROAssert(buffer, @"Could not allocate space to compare %lu and %lu objects", (unsigned long)oldCount, (unsigned long)newCount))
+        return;
 
     @onExit {
-        free(previous);
+        free(buffer);
     };
 
-    __block NSRange range = NSMakeRange(NSNotFound, 0);
-    __block NSUInteger otherArrayIndex = NSNotFound;
+    NSInteger *forward = buffer;
+    NSInteger *backward = forward + scratchCount;
+    NSUInteger *oldSymbols = (NSUInteger *)(backward + scratchCount);
+    NSUInteger *newSymbols = oldSymbols + oldCount;
+    BOOL *deleted = (BOOL *)(newSymbols + newCount);
+    BOOL *inserted = deleted + oldCount;
 
-    [self enumerateObjectsUsingBlock:^(id selfObj, NSUInteger selfIndex, BOOL *stop){
-        [otherArray enumerateObjectsUsingBlock:^(id otherObj, NSUInteger otherIndex, BOOL *stop){
-            BOOL equal;
+    symbolizeArray(self, symbolsByObject, oldSymbols);
+    symbolizeArray(otherArray, symbolsByObject, newSymbols);
 
-            if (checkForEquality)
-                equal = [selfObj isEqual:otherObj];
-            else
-                equal = (selfObj == otherObj);
+    findEditScript(oldSymbols, (NSInteger)oldCount, newSymbols, (NSInteger)newCount, deleted, inserted, forward, backward);
+
+    if (movedIndexes) {
+        // pair up deleted and inserted objects which are equal, in order, and
+        // consider them moved instead
+        NSMutableDictionary *deletedIndexesBySymbol = [NSMutableDictionary dictionary];
+
+        for (NSUInteger index = 0; index < oldCount; ++index) {
+            if (!deleted[index])
+                continue;
+
+            NSNumber *symbol = [NSNumber numberWithUnsignedInteger:oldSymbols[index]];
+
+            NSMutableArray *symbolIndexes = [deletedIndexesBySymbol objectForKey:symbol];
+            if (!symbolIndexes) {
+                symbolIndexes = [NSMutableArray array];
+                [deletedIndexesBySymbol setObject:symbolIndexes forKey:symbol];
+            }
+
+            [symbolIndexes addObject:[NSNumber numberWithUnsignedInteger:index]];
+        }
+
+        NSMutableDictionary *moves = [NSMutableDictionary dictionary];
+
+        for (NSUInteger index = 0; index < newCount; ++index) {
+            if (!inserted[index])
+                continue;
+
+            NSMutableArray *symbolIndexes = [deletedIndexesBySymbol objectForKey:[NSNumber numberWithUnsignedInteger:newSymbols[index]]];
+            if (!symbolIndexes.count)
+                continue;
+
+            NSNumber *oldIndex = [symbolIndexes objectAtIndex:0];
+            [symbolIndexes removeObjectAtIndex:0];
+
+            [moves setObject:[NSNumber numberWithUnsignedInteger:index] forKey:oldIndex];
+
+            deleted[[oldIndex unsignedIntegerValue]] = NO;
+            inserted[index] = NO;
+        }
+
+        *movedIndexes = moves;
+    }
+
+    if (deletedIndexes)
+        *deletedIndexes = indexSetFromFlags(deleted, oldCount);
+
+    if (insertedIndexes)
+        *insertedIndexes = indexSetFromFlags(inserted, newCount);
+}
+
+/**
+ * A nonzero word of the bit mask of positions at which a symbol occurs, in a
+ * sequence being searched by a <PROSubsequenceSearch>.
+ */
+typedef struct {
+    /**
+     * The index of this word in the full bit mask.
+     */
+    NSUInteger wordIndex;
+
+    /**
+     * The bits of the mask in this word, with the least significant bit
+     * representing the first position.
+     */
+    uint64_t bits;
+
+    /**
+     * The index of the next nonzero word of the same symbol's mask, or
+     * `NSNotFound` if this is the last one.
+     */
+    NSUInteger nextWord;
+} PROSymbolMaskWord;
+
+/**
+ * The state of a search for the longest common subsequence of two sequences of
+ * symbols.
+ *
+ * Rows of the dynamic programming table are computed with the bit-parallel
+ * algorithm of Allison and Dix (as formulated by Hyyrö), which handles 64
+ * positions of the other sequence with each machine word. Only one row is kept
+ * at a time, and the subsequence itself is recovered with Hirschberg's
+ * divide-and-conquer method, so the space used is linear.
+ */
+typedef struct {
+    const NSUInteger *symbols;
+    const NSUInteger *otherSymbols;
+
+    /**
+     * The nonzero words of the mask of each symbol, for the positions of
+     * `otherSymbols` being searched.
+     */
+    PROSymbolMaskWord *maskWords;
+    NSUInteger maskWordCount;
+
+    /**
+     * The first and last entries in `maskWords` for each symbol, or
+     * `NSNotFound` if the symbol does not occur.
+     */
+    NSUInteger *firstMaskWords;
+    NSUInteger *lastMaskWords;
+
+    /**
+     * The current row of the table, encoded as a bit vector in which each zero
+     * bit represents an increase in the length of the common subsequence.
+     */
+    uint64_t *row;
+
+    /**
+     * Scratch space for the lengths of the common subsequences of each prefix
+     * and each suffix of the other sequence.
+     */
+    NSUInteger *prefixLengths;
+    NSUInteger *suffixLengths;
+
+    /**
+     * The indexes of the matched symbols in each sequence, in order.
+     */
+    NSUInteger *matchedIndexes;
+    NSUInteger *otherMatchedIndexes;
+    NSUInteger matchCount;
+} PROSubsequenceSearch;
+
+/**
+ * Records a match between the given indexes of the two sequences.
+ */
+static void addSubsequenceMatch (PROSubsequenceSearch *search, NSUInteger index, NSUInteger otherIndex) {
+    search->matchedIndexes[search->matchCount] = index;
+    search->otherMatchedIndexes[search->matchCount] = otherIndex;
+    ++search->matchCount;
+}
+
+/**
+ * Computes the length of the longest common subsequence between the given range
+ * of `symbols` and every prefix of the given range of `otherSymbols`.
+ *
+ * If `reverse` is `YES`, both ranges are treated as if they were reversed, so
+ * the lengths computed are actually for every suffix of the other range.
+ *
+ * @param search The search state.
+ * @param range The range of `symbols` to compare.
+ * @param otherRange The range of `otherSymbols` to compare.
+ * @param reverse Whether to compare the ranges backwards.
+ * @param lengths An array of `otherRange.length + 1` integers, which will be
+ * filled in with the length of the longest common subsequence for each prefix
+ * length of the other range (or suffix length, if `reverse` is `YES`).
+ */
+static void computeSubsequenceLengths (PROSubsequenceSearch *search, NSRange range, NSRange otherRange, BOOL reverse, NSUInteger *lengths) {
+    const NSUInteger *symbols = search->symbols;
+    const NSUInteger *otherSymbols = search->otherSymbols;
+
+    PROSymbolMaskWord *maskWords = search->maskWords;
+    NSUInteger *firstMaskWords = search->firstMaskWords;
+    NSUInteger *lastMaskWords = search->lastMaskWords;
+    uint64_t *row = search->row;
+
+    NSUInteger otherCount = otherRange.length;
+    NSUInteger wordCount = (otherCount + 63) / 64;
+
+    // build the masks of the positions at which each symbol occurs, in order
+    // of increasing word
+    search->maskWordCount = 0;
+
+    for (NSUInteger position = 0; position < otherCount; ++position) {
+        NSUInteger symbol = otherSymbols[reverse ? NSMaxRange(otherRange) - position - 1 : otherRange.location + position];
+        NSUInteger wordIndex = position / 64;
+        uint64_t bit = (uint64_t)1 << (position % 64);
+
+        NSUInteger lastMaskWord = lastMaskWords[symbol];
+        if (lastMaskWord != NSNotFound && maskWords[lastMaskWord].wordIndex == wordIndex) {
+            maskWords[lastMaskWord].bits |= bit;
+            continue;
+        }
+
+        NSUInteger maskWord = search->maskWordCount++;
+        maskWords[maskWord].wordIndex = wordIndex;
+        maskWords[maskWord].bits = bit;
+        maskWords[maskWord].nextWord = NSNotFound;
+
+        if (lastMaskWord == NSNotFound)
+            firstMaskWords[symbol] = maskWord;
+        else
+            maskWords[lastMaskWord].nextWord = maskWord;
+
+        lastMaskWords[symbol] = maskWord;
+    }
+
+    for (NSUInteger wordIndex = 0; wordIndex < wordCount; ++wordIndex) {
+        row[wordIndex] = ~(uint64_t)0;
+    }
+
+    for (NSUInteger i = 0; i < range.length; ++i) {
+        NSUInteger symbol = symbols[reverse ? NSMaxRange(range) - i - 1 : range.location + i];
+
+        NSUInteger maskWord = firstMaskWords[symbol];
+        if (maskWord == NSNotFound)
+            continue;
+
+        // row = (row + matches) | (row - matches), where matches is the
+        // intersection of the row and the symbol's mask
+        //
+        // words without any matches and without a carry into them are
+        // unchanged, so only the words of the mask (and any carries out of
+        // them) need to be visited
+        uint64_t carry = 0;
+        NSUInteger wordIndex = maskWords[maskWord].wordIndex;
+
+        while (wordIndex < wordCount) {
+            uint64_t matches = 0;
 
-            if (!equal) {
-                current[otherIndex] = 0;
-                return;
+            if (maskWord != NSNotFound && maskWords[maskWord].wordIndex == wordIndex) {
+                matches = row[wordIndex] & maskWords[maskWord].bits;
+                maskWord = maskWords[maskWord].nextWord;
+            } else if (!carry) {
+                if (maskWord == NSNotFound)
+                    break;
+
+                wordIndex = maskWords[maskWord].wordIndex;
+                continue;
             }
 
-            if (selfIndex == 0 || otherIndex == 0) {
-                current[otherIndex] = 1;
-            } else {
-                current[otherIndex] = 1 + previous[otherIndex - 1];
+            uint64_t word = row[wordIndex];
+            uint64_t sum = word + matches;
+            uint64_t carriedSum = sum + carry;
+
+            carry = (sum < word || carriedSum < sum);
+            row[wordIndex] = carriedSum | (word & ~matches);
+
+            ++wordIndex;
+        }
+    }
+
+    lengths[0] = 0;
+    for (NSUInteger position = 0; position < otherCount; ++position) {
+        BOOL increased = !((row[position / 64] >> (position % 64)) & 1);
+        lengths[position + 1] = lengths[position] + increased;
+    }
+
+    // clear the masks for the next use
+    for (NSUInteger position = 0; position < otherCount; ++position) {
+        NSUInteger symbol = otherSymbols[otherRange.location + position];
+
+        firstMaskWords[symbol] = NSNotFound;
+        lastMaskWords[symbol] = NSNotFound;
+    }
+}
+
+/**
+ * Finds the longest common subsequence between the given ranges of the two
+ * sequences in `search`, recording each match in order.
+ */
+static void findSubsequence (PROSubsequenceSearch *search, NSRange range, NSRange otherRange) {
+    const NSUInteger *symbols = search->symbols;
+    const NSUInteger *otherSymbols = search->otherSymbols;
+
+    // a common prefix or suffix is always part of a longest common subsequence
+    while (range.length && otherRange.length && symbols[range.location] == otherSymbols[otherRange.location]) {
+        addSubsequenceMatch(search, range.location, otherRange.location);
+
+        ++range.location;
+        --range.length;
+        ++otherRange.location;
+        --otherRange.length;
+    }
+
+    NSUInteger suffixLength = 0;
+    while (range.length && otherRange.length && symbols[NSMaxRange(range) - 1] == otherSymbols[NSMaxRange(otherRange) - 1]) {
+        --range.length;
+        --otherRange.length;
+        ++suffixLength;
+    }
+
+    if (range.length == 1) {
+        for (NSUInteger otherIndex = otherRange.location; otherIndex < NSMaxRange(otherRange); ++otherIndex) {
+            if (otherSymbols[otherIndex] == symbols[range.location]) {
+                addSubsequenceMatch(search, range.location, otherIndex);
+                break;
             }
+        }
+    } else if (range.length && otherRange.length) {
+        // split the range in half, and find the position in the other range at
+        // which the longest subsequences of each half can be joined
+        NSRange firstHalf = NSMakeRange(range.location, range.length / 2);
+        NSRange secondHalf = NSMakeRange(NSMaxRange(firstHalf), range.length - firstHalf.length);
+
+        NSUInteger *prefixLengths = search->prefixLengths;
+        NSUInteger *suffixLengths = search->suffixLengths;
+
+        computeSubsequenceLengths(search, firstHalf, otherRange, NO, prefixLengths);
+        computeSubsequenceLengths(search, secondHalf, otherRange, YES, suffixLengths);
 
-            if (current[otherIndex] > range.length) {
-                NSUInteger currentLength = current[otherIndex];
+        NSUInteger split = 0;
+        NSUInteger longestLength = 0;
 
-                range = NSMakeRange(selfIndex + 1 - currentLength, currentLength);
-                otherArrayIndex = otherIndex + 1 - currentLength;
+        for (NSUInteger position = 0; position <= otherRange.length; ++position) {
+            NSUInteger length = prefixLengths[position] + suffixLengths[otherRange.length - position];
+
+            if (length > longestLength) {
+                split = position;
+                longestLength = length;
             }
-        }];
+        }
 
-        NSUInteger *swap = current;
-        current = previous;
-        previous = swap;
-    }];
+        findSubsequence(search, firstHalf, NSMakeRange(otherRange.location, split));
+        findSubsequence(search, secondHalf, NSMakeRange(otherRange.location + split, otherRange.length - split));
+    }
 
-    if (range.length > 0) {
-        NSCAssert(range.location != NSNotFound, @"Location of receiver range is NSNotFound even when length (%lu) is non-zero", (unsigned long)range.length);
-        NSCAssert(otherArrayIndex != NSNotFound, @"Location of other array range is NSNotFound even when length (%lu) is non-zero", (unsigned long)range.length);
+    for (NSUInteger i = 0; i < suffixLength; ++i) {
+        addSubsequenceMatch(search, NSMaxRange(range) + i, NSMaxRange(otherRange) + i);
     }
+}
 
-    if (rangeInReceiver)
-        *rangeInReceiver = range;
+/**
+ * Worker function for the longest common subsequence methods, with support for
+ * checking for equality or identity.
+ *
+ * @param self The receiver.
+ * @param otherArray The array to compare with the receiver.
+ * @param checkForEquality Whether `isEqual:` should be used to compare each
+ * object. If `NO`, pointer equality is used instead.
+ * @param indexesInReceiver If not `NULL`, set to the indexes in `self` of the
+ * objects in the subsequence.
+ * @param indexesInOtherArray If not `NULL`, set to the indexes in `otherArray`
+ * of the objects in the subsequence.
+ */
+static NSArray *longestSubsequence (NSArray *self, NSArray *otherArray, BOOL checkForEquality, NSIndexSet **indexesInReceiver, NSIndexSet **indexesInOtherArray) {
+    if (indexesInReceiver)
+        *indexesInReceiver = [NSIndexSet indexSet];
 
-    if (rangeInOtherArray)
-        *rangeInOtherArray = NSMakeRange(otherArrayIndex, range.length);
+    if (indexesInOtherArray)
+        *indexesInOtherArray = [NSIndexSet indexSet];
+
+    NSUInteger count = self.count;
+    NSUInteger otherCount = otherArray.count;
+
+    if (!count || !otherCount)
+        return nil;
 
-    if (range.location == NSNotFound)
+    CFMutableDictionaryRef symbolsByObject = createSymbolDictionary(checkForEquality);
+    @onExit {
+        CFRelease(symbolsByObject);
+    };
+
+    NSUInteger *symbols = malloc(count * sizeof(*symbols));
+    if (!PROAssert(symbols, @"Could not allocate space for %lu integers", (unsigned long)count))
         return nil;
-    else
-        return [self subarrayWithRange:range];
+
+    @onExit {
+        free(symbols);
+    };
+
+    NSUInteger *otherSymbols = malloc(otherCount * sizeof(*otherSymbols));
+    if (!PROAssert(otherSymbols, @"Could not allocate space for %lu integers", (unsigned long)otherCount))
+        return nil;
+
+    @onExit {
+        free(otherSymbols);
+    };
+
+    symbolizeArray(self, symbolsByObject, symbols);
+    symbolizeArray(otherArray, symbolsByObject, otherSymbols);
+
+    NSUInteger symbolCount = (NSUInteger)CFDictionaryGetCount(symbolsByObject);
+    NSUInteger wordCount = (otherCount + 63) / 64;
+    NSUInteger matchCapacity = MIN(count, otherCount);
+
+    PROSubsequenceSearch search = {
+        .symbols = symbols,
+        .otherSymbols = otherSymbols,
+        .maskWords = malloc(otherCount * sizeof(*search.maskWords)),
+        .firstMaskWords = malloc(symbolCount * sizeof(*search.firstMaskWords)),
+        .lastMaskWords = malloc(symbolCount * sizeof(*search.lastMaskWords)),
+        .row = malloc(wordCount * sizeof(*search.row)),
+        .prefixLengths = malloc((otherCount + 1) * sizeof(*search.prefixLengths)),
+        .suffixLengths = malloc((otherCount + 1) * sizeof(*search.suffixLengths)),
+        .matchedIndexes = malloc(matchCapacity * sizeof(*search.matchedIndexes)),
+        .otherMatchedIndexes = malloc(matchCapacity * sizeof(*search.otherMatchedIndexes))
+    };
+
+    @onExit {
+        free(search.maskWords);
+        free(search.firstMaskWords);
+        free(search.lastMaskWords);
+        free(search.row);
+        free(search.prefixLengths);
+        free(search.suffixLengths);
+        free(search.matchedIndexes);
+        free(search.otherMatchedIndexes);
+    };
+
+    BOOL allocated = search.maskWords && search.firstMaskWords && search.lastMaskWords && search.row && search.prefixLengths && search.suffixLengths && search.matchedIndexes && search.otherMatchedIndexes;
+    if (!PROAssert(allocated, @"Could not allocate space to compare %lu and %lu objects", (unsigned long)count, (unsigned long)otherCount))
+        return nil;
+
+    for (NSUInteger symbol = 0; symbol < symbolCount; ++symbol) {
+        search.firstMaskWords[symbol] = NSNotFound;
+        search.lastMaskWords[symbol] = NSNotFound;
+    }
+
+    findSubsequence(&search, NSMakeRange(0, count), NSMakeRange(0, otherCount));
+
+    if (!search.matchCount)
+        return nil;
+
+    NSMutableArray *subsequence = [[NSMutableArray alloc] initWithCapacity:search.matchCount];
+    NSMutableIndexSet *receiverIndexes = [[NSMutableIndexSet alloc] init];
+    NSMutableIndexSet *otherIndexes = [[NSMutableIndexSet alloc] init];
+
+    for (NSUInteger i = 0; i < search.matchCount; ++i) {
+        [subsequence addObject:[self objectAtIndex:search.matchedIndexes[i]]];
+        [receiverIndexes addIndex:search.matchedIndexes[i]];
+        [otherIndexes addIndex:search.otherMatchedIndexes[i]];
+    }
+
+    if (indexesInReceiver)
+        *indexesInReceiver = receiverIndexes;
+
+    if (indexesInOtherArray)
+        *indexesInOtherArray = otherIndexes;
+
+    return [subsequence copy];
+}
+
+/**
+ * Returns the index of the first object in the given range of `array` which is
+ * not less than `obj`, according to `comparator`.
+ *
+ * The search begins at the start of the range and takes exponentially larger
+ * steps until it passes `obj`, and only then uses binary search, so it takes
+ * time logarithmic in the distance to the result rather than in the size of
+ * the range. This makes repeated searches which advance through `array` (as
+ * when merging) cheap when `obj` is nearby.
+ */
+static NSUInteger gallopToObject (NSArray *array, NSRange range, id obj, NSComparator comparator) {
+    NSUInteger start = range.location;
+    NSUInteger end = NSMaxRange(range);
+
+    if (start >= end || comparator([array objectAtIndex:start], obj) != NSOrderedAscending)
+        return start;
+
+    // invariant: the object at 'lowerIndex' is less than 'obj'
+    NSUInteger lowerIndex = start;
+    NSUInteger step = 1;
+
+    while (step < end - start && comparator([array objectAtIndex:start + step], obj) == NSOrderedAscending) {
+        lowerIndex = start + step;
+        step *= 2;
+    }
+
+    NSUInteger upperIndex = MIN(start + step, end);
+    return [array indexOfObject:obj inSortedRange:NSMakeRange(lowerIndex + 1, upperIndex - lowerIndex - 1) options:NSBinarySearchingFirstEqual | NSBinarySearchingInsertionIndex usingComparator:comparator];
+}
+
+/**
+ * Appends the objects in the given range of `array` to `result`.
+ */
+static void appendObjectsInRange (NSMutableArray *result, NSArray *array, NSRange range) {
+    if (range.length)
+        [result addObjectsFromArray:[array subarrayWithRange:range]];
 }
 
 @safecategory (NSArray, SearchAdditions)
 
+- (NSRange)equalRangeOfObject:(id)obj usingComparator:(NSComparator)comparator; {
+    NSUInteger lowerBound = [self lowerBoundOfObject:obj usingComparator:comparator];
+    NSUInteger upperBound = [self indexOfObject:obj inSortedRange:NSMakeRange(lowerBound, self.count - lowerBound) options:NSBinarySearchingLastEqual | NSBinarySearchingInsertionIndex usingComparator:comparator];
+
+    return NSMakeRange(lowerBound, upperBound - lowerBound);
+}
+
+- (void)getDifferencesWithArray:(NSArray *)otherArray deletedIndexes:(NSIndexSet **)deletedIndexes insertedIndexes:(NSIndexSet **)insertedIndexes movedIndexes:(NSDictionary **)movedIndexes; {
+    differences(self, otherArray, YES, deletedIndexes, insertedIndexes, movedIndexes);
+}
+
+- (void)getIdentityDifferencesWithArray:(NSArray *)otherArray deletedIndexes:(NSIndexSet **)deletedIndexes insertedIndexes:(NSIndexSet **)insertedIndexes movedIndexes:(NSDictionary **)movedIndexes; {
+    differences(self, otherArray, NO, deletedIndexes, insertedIndexes, movedIndexes);
+}
+
+- (NSUInteger)lowerBoundOfObject:(id)obj usingComparator:(NSComparator)comparator; {
+    NSParameterAssert(comparator != nil);
+
+    return [self indexOfObject:obj inSortedRange:NSMakeRange(0, self.count) options:NSBinarySearchingFirstEqual | NSBinarySearchingInsertionIndex usingComparator:comparator];
+}
+
 - (NSArray *)longestSubarrayCommonWithArray:(NSArray *)otherArray; {
     return [self longestSubarrayCommonWithArray:otherArray rangeInReceiver:NULL rangeInOtherArray:NULL];
 }
@@ -127,4 +831,133 @@ static NSArray *longestSubarray (NSArray *self, NSArray *otherArray, BOOL checkF
     return longestSubarray(self, otherArray, NO, rangeInReceiver, rangeInOtherArray);
 }
 
+- (NSArray *)longestSubsequenceCommonWithArray:(NSArray *)otherArray; {
+    return [self longestSubsequenceCommonWithArray:otherArray indexesInReceiver:NULL indexesInOtherArray:NULL];
+}
+
+- (NSArray *)longestSubsequenceCommonWithArray:(NSArray *)otherArray indexesInReceiver:(NSIndexSet **)indexesInReceiver indexesInOtherArray:(NSIndexSet **)indexesInOtherArray; {
+    return longestSubsequence(self, otherArray, YES, indexesInReceiver, indexesInOtherArray);
+}
+
+- (NSArray *)longestSubsequenceIdenticalWithArray:(NSArray *)otherArray; {
+    return [self longestSubsequenceIdenticalWithArray:otherArray indexesInReceiver:NULL indexesInOtherArray:NULL];
+}
+
+- (NSArray *)longestSubsequenceIdenticalWithArray:(NSArray *)otherArray indexesInReceiver:(NSIndexSet **)indexesInReceiver indexesInOtherArray:(NSIndexSet **)indexesInOtherArray; {
+    return longestSubsequence(self, otherArray, NO, indexesInReceiver, indexesInOtherArray);
+}
+
+- (NSArray *)sortedArrayByIntersectingSortedArray:(NSArray *)otherArray usingComparator:(NSComparator)comparator; {
+    NSParameterAssert(comparator != nil);
+
+    NSUInteger count = self.count;
+    NSUInteger otherCount = otherArray.count;
+
+    NSMutableArray *result = [[NSMutableArray alloc] initWithCapacity:MIN(count, otherCount)];
+
+    NSUInteger index = 0;
+    NSUInteger otherIndex = 0;
+
+    while (index < count && otherIndex < otherCount) {
+        id obj = [self objectAtIndex:index];
+        id otherObj = [otherArray objectAtIndex:otherIndex];
+
+        NSComparisonResult order = comparator(obj, otherObj);
+
+        if (order == NSOrderedAscending) {
+            index = gallopToObject(self, NSMakeRange(index, count - index), otherObj, comparator);
+        } else if (order == NSOrderedDescending) {
+            otherIndex = gallopToObject(otherArray, NSMakeRange(otherIndex, otherCount - otherIndex), obj, comparator);
+        } else {
+            [result addObject:obj];
+
+            ++index;
+            ++otherIndex;
+        }
+    }
+
+    return [result copy];
+}
+
+- (NSArray *)sortedArrayBySubtractingSortedArray:(NSArray *)otherArray usingComparator:(NSComparator)comparator; {
+    NSParameterAssert(comparator != nil);
+
+    NSUInteger count = self.count;
+    NSUInteger otherCount = otherArray.count;
+
+    NSMutableArray *result = [[NSMutableArray alloc] initWithCapacity:count];
+
+    NSUInteger index = 0;
+    NSUInteger otherIndex = 0;
+
+    while (index < count && otherIndex < otherCount) {
+        id obj = [self objectAtIndex:index];
+        id otherObj = [otherArray objectAtIndex:otherIndex];
+
+        NSComparisonResult order = comparator(obj, otherObj);
+
+        if (order == NSOrderedAscending) {
+            NSUInteger nextIndex = gallopToObject(self, NSMakeRange(index, count - index), otherObj, comparator);
+            appendObjectsInRange(result, self, NSMakeRange(index, nextIndex - index));
+
+            index = nextIndex;
+        } else if (order == NSOrderedDescending) {
+            otherIndex = gallopToObject(otherArray, NSMakeRange(otherIndex, otherCount - otherIndex), obj, comparator);
+        } else {
+            ++index;
+            ++otherIndex;
+        }
+    }
+
+    appendObjectsInRange(result, self, NSMakeRange(index, count - index));
+    return [result copy];
+}
+
+- (NSArray *)sortedArrayByUnioningSortedArray:(NSArray *)otherArray usingComparator:(NSComparator)comparator; {
+    NSParameterAssert(comparator != nil);
+
+    NSUInteger count = self.count;
+    NSUInteger otherCount = otherArray.count;
+
+    NSMutableArray *result = [[NSMutableArray alloc] initWithCapacity:MAX(count, otherCount)];
+
+    NSUInteger index = 0;
+    NSUInteger otherIndex = 0;
+
+    while (index < count && otherIndex < otherCount) {
+        id obj = [self objectAtIndex:index];
+        id otherObj = [otherArray objectAtIndex:otherIndex];
+
+        NSComparisonResult order = comparator(obj, otherObj);
+
+        if (order == NSOrderedAscending) {
+            NSUInteger nextIndex = gallopToObject(self, NSMakeRange(index, count - index), otherObj, comparator);
+            appendObjectsInRange(result, self, NSMakeRange(index, nextIndex - index));
+
+            index = nextIndex;
+        } else if (order == NSOrderedDescending) {
+            NSUInteger nextIndex = gallopToObject(otherArray, NSMakeRange(otherIndex, otherCount - otherIndex), obj, comparator);
+            appendObjectsInRange(result, otherArray, NSMakeRange(otherIndex, nextIndex - otherIndex));
+
+            otherIndex = nextIndex;
+        } else {
+            [result addObject:obj];
+
+            ++index;
+            ++otherIndex;
+        }
+    }
+
+    appendObjectsInRange(result, self, NSMakeRange(index, count - index));
+    appendObjectsInRange(result, otherArray, NSMakeRange(otherIndex, otherCount - otherIndex));
+
+    return [result copy];
+}
+
+- (NSUInteger)upperBoundOfObject:(id)obj usingComparator:(NSComparator)comparator; {
+    NSParameterAssert(comparator != nil);
+
+    return [self indexOfObject:obj inSortedRange:NSMakeRange(0, self.count) options:NSBinarySearchingLastEqual | NSBinarySearchingInsertionIndex usingComparator:comparator];
+}
+
 @end
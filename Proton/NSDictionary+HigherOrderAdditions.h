@@ -13,6 +13,55 @@
  */
 @interface NSDictionary (HigherOrderAdditions)
 
+/**
+ * Returns whether any entry in the receiver passes the given test.
+ *
+ * Enumeration stops as soon as a matching entry is found.
+ *
+ * @param predicate The test to apply to each entry in the receiver.
+ */
+- (BOOL)anyEntryPassingTest:(BOOL (^)(id key, id value))predicate;
+
+/**
+ * Returns whether any entry in the receiver passes the given test, applying
+ * `opts` while enumerating.
+ *
+ * Enumeration stops as soon as a matching entry is found. With
+ * `NSEnumerationConcurrent`, this cancels the work of every other chunk as
+ * well.
+ *
+ * @param opts A mask of `NSEnumerationOptions` to apply when enumerating.
+ * @param predicate The test to apply to each entry in the receiver. If `opts`
+ * includes `NSEnumerationConcurrent`, this block may be invoked concurrently,
+ * and must be thread-safe.
+ */
+- (BOOL)anyEntryWithOptions:(NSEnumerationOptions)opts passingTest:(BOOL (^)(id key, id value))predicate;
+
+/**
+ * Returns whether every entry in the receiver passes the given test. If the
+ * receiver is empty, this returns `YES`.
+ *
+ * Enumeration stops as soon as an entry fails the test.
+ *
+ * @param predicate The test to apply to each entry in the receiver.
+ */
+- (BOOL)everyEntryPassingTest:(BOOL (^)(id key, id value))predicate;
+
+/**
+ * Returns whether every entry in the receiver passes the given test, applying
+ * `opts` while enumerating. If the receiver is empty, this returns `YES`.
+ *
+ * Enumeration stops as soon as an entry fails the test. With
+ * `NSEnumerationConcurrent`, this cancels the work of every other chunk as
+ * well.
+ *
+ * @param opts A mask of `NSEnumerationOptions` to apply when enumerating.
+ * @param predicate The test to apply to each entry in the receiver. If `opts`
+ * includes `NSEnumerationConcurrent`, this block may be invoked concurrently,
+ * and must be thread-safe.
+ */
+- (BOOL)everyEntryWithOptions:(NSEnumerationOptions)opts passingTest:(BOOL (^)(id key, id value))predicate;
+
 /**
  * Filters the keys and values of the receiver with the given predicate,
  * returning a new dictionary built from those entries.
@@ -64,6 +113,33 @@
  */
 - (NSDictionary *)filterEntriesWithOptions:(NSEnumerationOptions)opts failedEntries:(NSDictionary **)failedEntries usingBlock:(BOOL(^)(id key, id value))block;
 
+/**
+ * Returns an dictionary of filtered entries for which `block` returns `YES`,
+ * and sets `failedEntries` to a dictionary of the entries for which `block`
+ * returned `NO`, processing chunks of `grainSize` entries at a time.
+ *
+ * If `opts` includes `NSEnumerationConcurrent`, each chunk is filtered on the
+ * concurrent global `SDQueue` into its own region of a buffer, and the results
+ * are combined afterward. Unlike
+ * <filterEntriesWithOptions:failedEntries:usingBlock:>, this involves no
+ * per-entry synchronization.
+ *
+ * Without `NSEnumerationConcurrent`, `grainSize` is ignored, and this method
+ * behaves exactly like <filterEntriesWithOptions:failedEntries:usingBlock:>.
+ *
+ * @param opts A mask of `NSEnumerationOptions` to apply when filtering.
+ * @param grainSize The maximum number of entries to filter in each chunk. If
+ * zero, a grain size is chosen automatically.
+ * @param failedEntries If not `NULL`, this will be a collection of all the
+ * entries for which `block` returned `NO`. If no entries failed, this will be
+ * an empty dictionary.
+ * @param block A predicate with which to filter key-value pairs in the
+ * receiver. If this block returns `YES`, the entry will be added to the
+ * returned collection. If this block returns `NO`, the object will be added to
+ * `failedEntries`.
+ */
+- (NSDictionary *)filterEntriesWithOptions:(NSEnumerationOptions)opts grainSize:(NSUInteger)grainSize failedEntries:(NSDictionary **)failedEntries usingBlock:(BOOL(^)(id key, id value))block;
+
 /**
  * Reduces the receiver to a single value, using the given block.
  *
@@ -90,6 +166,32 @@
  */
 - (id)foldEntriesWithValue:(id)startingValue usingBlock:(id (^)(id left, id rightKey, id rightValue))block;
 
+/**
+ * Returns a set of the keys of up to `maximumCount` entries in the receiver
+ * which pass the given test, stopping as soon as that many have been found.
+ *
+ * @param maximumCount The maximum number of keys to return.
+ * @param predicate The test to apply to each entry in the receiver.
+ */
+- (NSSet *)keysOfEntriesWithMaximumCount:(NSUInteger)maximumCount passingTest:(BOOL (^)(id key, id value))predicate;
+
+/**
+ * Returns a set of the keys of up to `maximumCount` entries in the receiver
+ * which pass the given test, applying `opts` while enumerating.
+ *
+ * Enumeration stops as soon as enough entries have been found. With
+ * `NSEnumerationConcurrent`, the receiver is searched in chunks on the
+ * concurrent global `SDQueue`, and every chunk stops once the search is
+ * satisfied.
+ *
+ * @param opts A mask of `NSEnumerationOptions` to apply when enumerating.
+ * @param maximumCount The maximum number of keys to return.
+ * @param predicate The test to apply to each entry in the receiver. If `opts`
+ * includes `NSEnumerationConcurrent`, this block may be invoked concurrently,
+ * and must be thread-safe.
+ */
+- (NSSet *)keysOfEntriesWithOptions:(NSEnumerationOptions)opts maximumCount:(NSUInteger)maximumCount passingTest:(BOOL (^)(id key, id value))predicate;
+
 /**
  * Transforms each value in the receiver with the given predicate, returning
  * a new dictionary built from the original keys and the transformed values.
@@ -122,6 +224,32 @@
  */
 - (NSDictionary *)mapValuesWithOptions:(NSEnumerationOptions)opts usingBlock:(id (^)(id key, id value))block;
 
+/**
+ * Transforms each value in the receiver with the given predicate, according to
+ * the semantics of `opts`, processing chunks of `grainSize` entries at a time.
+ *
+ * If `opts` includes `NSEnumerationConcurrent`, each chunk is mapped on the
+ * concurrent global `SDQueue` into its own region of a buffer, and the results
+ * are combined afterward. Unlike <mapValuesWithOptions:usingBlock:>, this
+ * involves no per-entry synchronization.
+ *
+ * Without `NSEnumerationConcurrent`, `grainSize` is ignored, and this method
+ * behaves exactly like <mapValuesWithOptions:usingBlock:>.
+ *
+ * @param opts A mask of `NSEnumerationOptions` to apply when mapping.
+ * @param grainSize The maximum number of entries to map in each chunk. If zero,
+ * a grain size is chosen automatically.
+ * @param block A block with which to transform each value. The key and original
+ * value from the receiver are passed in as the arguments.
+ *
+ * @warning **Important:** It is permissible to return `nil` from `block`, but
+ * doing so will omit an entry from the resultant dictionary, such that the
+ * number of objects in the result is less than the number of objects in the
+ * receiver. If you need the dictionaries to match in size, ensure that the
+ * given block returns `NSNull` or `EXTNil` instead of `nil`.
+ */
+- (NSDictionary *)mapValuesWithOptions:(NSEnumerationOptions)opts grainSize:(NSUInteger)grainSize usingBlock:(id (^)(id key, id value))block;
+
 /**
  * Returns the key of an entry in the receiver that passes the given test, or
  * `nil` if no such entry exists.
@@ -141,4 +269,49 @@
  */
 - (id)keyOfEntryWithOptions:(NSEnumerationOptions)opts passingTest:(BOOL (^)(id key, id obj, BOOL *stop))predicate;
 
+/**
+ * Returns whether no entry in the receiver passes the given test. If the
+ * receiver is empty, this returns `YES`.
+ *
+ * Enumeration stops as soon as a matching entry is found.
+ *
+ * @param predicate The test to apply to each entry in the receiver.
+ */
+- (BOOL)noEntryPassingTest:(BOOL (^)(id key, id value))predicate;
+
+/**
+ * Returns whether no entry in the receiver passes the given test, applying
+ * `opts` while enumerating. If the receiver is empty, this returns `YES`.
+ *
+ * Enumeration stops as soon as a matching entry is found. With
+ * `NSEnumerationConcurrent`, this cancels the work of every other chunk as
+ * well.
+ *
+ * @param opts A mask of `NSEnumerationOptions` to apply when enumerating.
+ * @param predicate The test to apply to each entry in the receiver. If `opts`
+ * includes `NSEnumerationConcurrent`, this block may be invoked concurrently,
+ * and must be thread-safe.
+ */
+- (BOOL)noEntryWithOptions:(NSEnumerationOptions)opts passingTest:(BOOL (^)(id key, id value))predicate;
+
+/**
+ * Reduces the receiver to a single value by folding chunks of the receiver's
+ * entries concurrently, and then combining the partial results.
+ *
+ * Each chunk is folded with `block` (starting with `identity`) on the
+ * concurrent global `SDQueue`, in the same manner as
+ * <foldEntriesWithValue:usingBlock:>. The partial results are then combined
+ * with `combiningBlock` in a balanced tree.
+ *
+ * @param identity An identity value for `combiningBlock`, such that combining
+ * `identity` with any value results in that same value. If the receiver is
+ * empty, this is the value returned.
+ * @param block A block that combines a partial result with an entry of the
+ * receiver. This block may be invoked concurrently, and must be thread-safe.
+ * @param combiningBlock An associative and commutative block that combines two
+ * partial results. This block may be invoked concurrently, and must be
+ * thread-safe.
+ */
+- (id)reduceEntriesWithIdentity:(id)identity usingBlock:(id (^)(id left, id rightKey, id rightValue))block combiningBlock:(id (^)(id left, id right))combiningBlock;
+
 @end
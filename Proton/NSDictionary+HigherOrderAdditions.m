@@ -9,15 +9,47 @@
 #import <Proton/NSDictionary+HigherOrderAdditions.h>
 #import <Proton/EXTSafeCategory.h>
 #import <Proton/EXTScope.h>
+#import <Proton/PROConcurrentFunctions.h>
 #import <libkern/OSAtomic.h>
 
 @safecategory (NSDictionary, HigherOrderAdditions)
 
+- (BOOL)anyEntryPassingTest:(BOOL (^)(id key, id value))predicate; {
+    return [self anyEntryWithOptions:0 passingTest:predicate];
+}
+
+- (BOOL)anyEntryWithOptions:(NSEnumerationOptions)opts passingTest:(BOOL (^)(id key, id value))predicate; {
+    return [[self keysOfEntriesWithOptions:opts maximumCount:1 passingTest:predicate] count] > 0;
+}
+
+- (BOOL)everyEntryPassingTest:(BOOL (^)(id key, id value))predicate; {
+    return [self everyEntryWithOptions:0 passingTest:predicate];
+}
+
+- (BOOL)everyEntryWithOptions:(NSEnumerationOptions)opts passingTest:(BOOL (^)(id key, id value))predicate; {
+    NSParameterAssert(predicate != nil);
+
+    PROAutomaticEnumeration automaticEnumeration = PROBeginAutomaticEnumeration(&opts, [self count], predicate);
+    @onExit {
+        PROEndAutomaticEnumeration(automaticEnumeration);
+    };
+
+    // search for a counterexample
+    return ![self anyEntryWithOptions:opts passingTest:^ BOOL (id key, id value){
+        return !predicate(key, value);
+    }];
+}
+
 - (NSDictionary *)filterEntriesUsingBlock:(BOOL (^)(id key, id value))block; {
     return [self filterEntriesWithOptions:0 usingBlock:block];
 }
 
 - (NSDictionary *)filterEntriesWithOptions:(NSEnumerationOptions)opts usingBlock:(BOOL (^)(id key, id value))block; {
+    PROAutomaticEnumeration automaticEnumeration = PROBeginAutomaticEnumeration(&opts, [self count], block);
+    @onExit {
+        PROEndAutomaticEnumeration(automaticEnumeration);
+    };
+
     NSSet *matchingKeys = [self keysOfEntriesWithOptions:opts passingTest:^(id key, id value, BOOL *stop){
         return block(key, value);
     }];
@@ -34,6 +66,12 @@
 
 - (NSDictionary *)filterEntriesWithOptions:(NSEnumerationOptions)opts failedEntries:(NSDictionary **)failedEntries usingBlock:(BOOL(^)(id key, id value))block; {
     NSUInteger originalCount = [self count];
+
+    PROAutomaticEnumeration automaticEnumeration = PROBeginAutomaticEnumeration(&opts, originalCount, block);
+    @onExit {
+        PROEndAutomaticEnumeration(automaticEnumeration);
+    };
+
     BOOL concurrent = (opts & NSEnumerationConcurrent);
 
     // this will be used to store both the successful keys (starting from the
@@ -105,6 +143,114 @@
     return [NSDictionary dictionaryWithObjects:(id *)values forKeys:(id *)keys count:successCount];
 }
 
+- (NSDictionary *)filterEntriesWithOptions:(NSEnumerationOptions)opts grainSize:(NSUInteger)grainSize failedEntries:(NSDictionary **)failedEntries usingBlock:(BOOL(^)(id key, id value))block; {
+    // automatic enumeration chooses its own grain size
+    if ((opts & PROEnumerationAutomatic) || !(opts & NSEnumerationConcurrent))
+        return [self filterEntriesWithOptions:opts failedEntries:failedEntries usingBlock:block];
+
+    NSUInteger originalCount = [self count];
+
+    // the successful entries of each chunk are compacted in place into the
+    // beginning of that chunk's range of these buffers
+    //
+    // note that we don't need to retain the objects, since the dictionary is already
+    // doing so
+    __unsafe_unretained id *keys = (__unsafe_unretained id *)calloc(originalCount + 1, sizeof(*keys));
+    if (!keys) {
+        return nil;
+    }
+
+    @onExit {
+        free(keys);
+    };
+
+    __unsafe_unretained id *values = (__unsafe_unretained id *)calloc(originalCount + 1, sizeof(*values));
+    if (!values) {
+        return nil;
+    }
+
+    @onExit {
+        free(values);
+    };
+
+    // the failed entries of each chunk are stored into the beginning of that
+    // chunk's range of these buffers
+    __unsafe_unretained id *failedKeys = NULL;
+    __unsafe_unretained id *failedValues = NULL;
+
+    @onExit {
+        free(failedKeys);
+        free(failedValues);
+    };
+
+    if (failedEntries) {
+        failedKeys = (__unsafe_unretained id *)calloc(originalCount + 1, sizeof(*failedKeys));
+        failedValues = (__unsafe_unretained id *)calloc(originalCount + 1, sizeof(*failedValues));
+
+        if (!failedKeys || !failedValues) {
+            return nil;
+        }
+    }
+
+    NSUInteger chunkCount = PROConcurrentChunkCount(originalCount, grainSize);
+
+    NSRange *passedRanges = calloc(chunkCount + 1, sizeof(*passedRanges));
+    if (!passedRanges) {
+        return nil;
+    }
+
+    @onExit {
+        free(passedRanges);
+    };
+
+    NSRange *failedRanges = calloc(chunkCount + 1, sizeof(*failedRanges));
+    if (!failedRanges) {
+        return nil;
+    }
+
+    @onExit {
+        free(failedRanges);
+    };
+
+    [self getObjects:values andKeys:keys];
+
+    PROConcurrentEnumerateChunks(originalCount, grainSize, ^(NSUInteger chunkIndex, NSRange range){
+        NSUInteger nextPassedIndex = range.location;
+        NSUInteger nextFailedIndex = range.location;
+
+        for (NSUInteger i = range.location; i < NSMaxRange(range); ++i) {
+            id key = keys[i];
+            id value = values[i];
+
+            if (block(key, value)) {
+                // this never overwrites an entry that hasn't been read yet
+                keys[nextPassedIndex] = key;
+                values[nextPassedIndex] = value;
+                ++nextPassedIndex;
+            } else if (failedKeys) {
+                failedKeys[nextFailedIndex] = key;
+                failedValues[nextFailedIndex] = value;
+                ++nextFailedIndex;
+            }
+        }
+
+        passedRanges[chunkIndex] = NSMakeRange(range.location, nextPassedIndex - range.location);
+        failedRanges[chunkIndex] = NSMakeRange(range.location, nextFailedIndex - range.location);
+    });
+
+    if (failedEntries) {
+        PROConcurrentCompactChunks(failedValues, sizeof(*failedValues), failedRanges, chunkCount);
+        NSUInteger failedCount = PROConcurrentCompactChunks(failedKeys, sizeof(*failedKeys), failedRanges, chunkCount);
+
+        *failedEntries = [NSDictionary dictionaryWithObjects:(id *)failedValues forKeys:(id *)failedKeys count:failedCount];
+    }
+
+    PROConcurrentCompactChunks(values, sizeof(*values), passedRanges, chunkCount);
+    NSUInteger passedCount = PROConcurrentCompactChunks(keys, sizeof(*keys), passedRanges, chunkCount);
+
+    return [NSDictionary dictionaryWithObjects:(id *)values forKeys:(id *)keys count:passedCount];
+}
+
 - (id)foldEntriesWithValue:(id)startingValue usingBlock:(id (^)(id left, id rightKey, id rightValue))block; {
     __block id value = startingValue;
     
@@ -115,12 +261,95 @@
     return value;
 }
 
+- (NSSet *)keysOfEntriesWithMaximumCount:(NSUInteger)maximumCount passingTest:(BOOL (^)(id key, id value))predicate; {
+    return [self keysOfEntriesWithOptions:0 maximumCount:maximumCount passingTest:predicate];
+}
+
+- (NSSet *)keysOfEntriesWithOptions:(NSEnumerationOptions)opts maximumCount:(NSUInteger)maximumCount passingTest:(BOOL (^)(id key, id value))predicate; {
+    NSParameterAssert(predicate != nil);
+
+    NSUInteger count = [self count];
+
+    PROAutomaticEnumeration automaticEnumeration = PROBeginAutomaticEnumeration(&opts, count, predicate);
+    @onExit {
+        PROEndAutomaticEnumeration(automaticEnumeration);
+    };
+
+    if (!(opts & NSEnumerationConcurrent)) {
+        // enumerate the dictionary directly, so that we can stop at the first
+        // matches without flattening the whole thing first
+        NSMutableSet *matchingKeys = [[NSMutableSet alloc] init];
+
+        if (maximumCount) {
+            [self enumerateKeysAndObjectsUsingBlock:^(id key, id value, BOOL *stop){
+                if (!predicate(key, value))
+                    return;
+
+                [matchingKeys addObject:key];
+                if (matchingKeys.count >= maximumCount)
+                    *stop = YES;
+            }];
+        }
+
+        return [matchingKeys copy];
+    }
+
+    // we don't need to retain the keys or values, since the dictionary is
+    // already doing so
+    __unsafe_unretained id *keys = (__unsafe_unretained id *)calloc(count + 1, sizeof(*keys));
+    if (!keys) {
+        return nil;
+    }
+
+    @onExit {
+        free(keys);
+    };
+
+    __unsafe_unretained id *values = (__unsafe_unretained id *)calloc(count + 1, sizeof(*values));
+    if (!values) {
+        return nil;
+    }
+
+    @onExit {
+        free(values);
+    };
+
+    NSUInteger *indexes = calloc(MIN(maximumCount, count) + 1, sizeof(*indexes));
+    if (!indexes) {
+        return nil;
+    }
+
+    @onExit {
+        free(indexes);
+    };
+
+    [self getObjects:values andKeys:keys];
+
+    NSUInteger matchCount = PROConcurrentSearch(count, 0, maximumCount, indexes, ^(NSUInteger index){
+        return predicate(keys[index], values[index]);
+    });
+
+    NSMutableSet *matchingKeys = [[NSMutableSet alloc] initWithCapacity:matchCount];
+
+    for (NSUInteger i = 0; i < matchCount; ++i) {
+        [matchingKeys addObject:keys[indexes[i]]];
+    }
+
+    return [matchingKeys copy];
+}
+
 - (NSDictionary *)mapValuesUsingBlock:(id (^)(id key, id value))block; {
     return [self mapValuesWithOptions:0 usingBlock:block];
 }
 
 - (NSDictionary *)mapValuesWithOptions:(NSEnumerationOptions)opts usingBlock:(id (^)(id key, id value))block; {
     NSUInteger originalCount = [self count];
+
+    PROAutomaticEnumeration automaticEnumeration = PROBeginAutomaticEnumeration(&opts, originalCount, block);
+    @onExit {
+        PROEndAutomaticEnumeration(automaticEnumeration);
+    };
+
     BOOL concurrent = (opts & NSEnumerationConcurrent);
 
     // we don't need to retain the individual keys, since the original
@@ -179,11 +408,103 @@
     return [NSDictionary dictionaryWithObjects:(id *)values forKeys:(id *)keys count:(NSUInteger)nextIndex];
 }
 
+- (NSDictionary *)mapValuesWithOptions:(NSEnumerationOptions)opts grainSize:(NSUInteger)grainSize usingBlock:(id (^)(id key, id value))block; {
+    // automatic enumeration chooses its own grain size
+    if ((opts & PROEnumerationAutomatic) || !(opts & NSEnumerationConcurrent))
+        return [self mapValuesWithOptions:opts usingBlock:block];
+
+    NSUInteger originalCount = [self count];
+
+    // we don't need to retain the individual keys or original values, since the
+    // dictionary is already doing so
+    __unsafe_unretained id *keys = (__unsafe_unretained id *)calloc(originalCount + 1, sizeof(*keys));
+    if (!keys) {
+        return nil;
+    }
+
+    @onExit {
+        free(keys);
+    };
+
+    __unsafe_unretained id *originalValues = (__unsafe_unretained id *)calloc(originalCount + 1, sizeof(*originalValues));
+    if (!originalValues) {
+        return nil;
+    }
+
+    @onExit {
+        free(originalValues);
+    };
+
+    NSUInteger chunkCount = PROConcurrentChunkCount(originalCount, grainSize);
+
+    NSRange *resultRanges = calloc(chunkCount + 1, sizeof(*resultRanges));
+    if (!resultRanges) {
+        return nil;
+    }
+
+    @onExit {
+        free(resultRanges);
+    };
+
+    // the results of each chunk (and their keys) are compacted into the
+    // beginning of that chunk's range of this buffer
+    __strong id *values = (__strong id *)calloc(originalCount + 1, sizeof(*values));
+    if (!values) {
+        return nil;
+    }
+
+    // declare this variable way up here so that it can be used in the @onExit
+    // block below -- until compaction, this is the number of values at the
+    // beginning of the buffer which are guaranteed to be valid
+    __block NSUInteger actualCount = 0;
+
+    @onExit {
+        // nil out everything in the 'values' array to make sure ARC releases
+        // everything appropriately (anything past 'actualCount' was moved)
+        for (NSUInteger i = 0;i < actualCount;++i) {
+            values[i] = nil;
+        }
+
+        free((void *)values);
+    };
+
+    [self getObjects:originalValues andKeys:keys];
+
+    PROConcurrentEnumerateChunks(originalCount, grainSize, ^(NSUInteger chunkIndex, NSRange range){
+        NSUInteger nextIndex = range.location;
+
+        for (NSUInteger i = range.location; i < NSMaxRange(range); ++i) {
+            id key = keys[i];
+            id newValue = block(key, originalValues[i]);
+
+            if (!newValue)
+                continue;
+
+            // this never overwrites a key that hasn't been read yet
+            keys[nextIndex] = key;
+            values[nextIndex] = newValue;
+            ++nextIndex;
+        }
+
+        resultRanges[chunkIndex] = NSMakeRange(range.location, nextIndex - range.location);
+    });
+
+    PROConcurrentCompactChunks(keys, sizeof(*keys), resultRanges, chunkCount);
+    actualCount = PROConcurrentCompactChunks((void *)values, sizeof(*values), resultRanges, chunkCount);
+
+    return [NSDictionary dictionaryWithObjects:(id *)values forKeys:(id *)keys count:actualCount];
+}
+
 - (id)keyOfEntryPassingTest:(BOOL (^)(id key, id obj, BOOL *stop))predicate; {
     return [self keyOfEntryWithOptions:0 passingTest:predicate];
 }
 
 - (id)keyOfEntryWithOptions:(NSEnumerationOptions)opts passingTest:(BOOL (^)(id key, id obj, BOOL *stop))predicate; {
+    PROAutomaticEnumeration automaticEnumeration = PROBeginAutomaticEnumeration(&opts, [self count], predicate);
+    @onExit {
+        PROEndAutomaticEnumeration(automaticEnumeration);
+    };
+
     BOOL concurrent = (opts & NSEnumerationConcurrent);
 
     void * volatile match = NULL;
@@ -202,6 +523,10 @@
         } else {
             *matchPtr = (__bridge void *)key;
         }
+
+        // any match will do, so cancel the enumeration (including any other
+        // concurrent invocations)
+        *stop = YES;
     }];
 
     if (concurrent) {
@@ -214,4 +539,53 @@
     return [(__bridge id)match self];
 }
 
+- (BOOL)noEntryPassingTest:(BOOL (^)(id key, id value))predicate; {
+    return [self noEntryWithOptions:0 passingTest:predicate];
+}
+
+- (BOOL)noEntryWithOptions:(NSEnumerationOptions)opts passingTest:(BOOL (^)(id key, id value))predicate; {
+    return ![self anyEntryWithOptions:opts passingTest:predicate];
+}
+
+- (id)reduceEntriesWithIdentity:(id)identity usingBlock:(id (^)(id left, id rightKey, id rightValue))block combiningBlock:(id (^)(id left, id right))combiningBlock; {
+    NSParameterAssert(block != nil);
+    NSParameterAssert(combiningBlock != nil);
+
+    NSUInteger count = [self count];
+    if (!count)
+        return identity;
+
+    // we don't need to retain the keys or values, since the dictionary is
+    // already doing so
+    __unsafe_unretained id *keys = (__unsafe_unretained id *)calloc(count, sizeof(*keys));
+    if (!keys) {
+        return nil;
+    }
+
+    @onExit {
+        free(keys);
+    };
+
+    __unsafe_unretained id *values = (__unsafe_unretained id *)calloc(count, sizeof(*values));
+    if (!values) {
+        return nil;
+    }
+
+    @onExit {
+        free(values);
+    };
+
+    [self getObjects:values andKeys:keys];
+
+    return PROConcurrentReduce(count, 0, identity, ^ id (NSRange range){
+        id value = identity;
+
+        for (NSUInteger index = range.location; index < NSMaxRange(range); ++index) {
+            value = block(value, keys[index], values[index]);
+        }
+
+        return value;
+    }, combiningBlock);
+}
+
 @end
@@ -49,4 +49,89 @@
  */
 - (void)applyKeyValueChangeDictionary:(NSDictionary *)changes toKeyPath:(NSString *)keyPath mappingNewObjectsUsingBlock:(id (^)(id))block;
 
+/**
+ * Applies a set of KVO changes to a to-many property, optionally transforming any
+ * new values that have been added, according to the semantics of `opts`.
+ *
+ * This behaves like
+ * <applyKeyValueChangeDictionary:toKeyPath:mappingNewObjectsUsingBlock:>, but
+ * is better suited to large changes:
+ *
+ *  - With `NSEnumerationConcurrent` in `opts`, new objects are mapped in
+ *  contiguous chunks on the concurrent global `SDQueue`.
+ *  - Objects which already have an entry in `mappedObjects` are replaced with
+ *  that entry, instead of being passed to `block`.
+ *  - Removed objects given as an `NSSet` are removed from an unordered
+ *  collection directly, without building another set.
+ *
+ * @param changes A change dictionary that was passed to
+ * `observeValueForKeyPath:ofObject:change:context:` or a <[PROKeyValueObserver
+ * block]>. This has the same requirements as
+ * <applyKeyValueChangeDictionary:toKeyPath:mappingNewObjectsUsingBlock:>.
+ * @param keyPath A key path, relative to the receiver, at which to apply the
+ * changes. The property at this key path must hold a KVC-compliant collection
+ * (either ordered or unordered).
+ * @param opts A mask of `NSEnumerationOptions` to apply when mapping new
+ * objects.
+ * @param mappedObjects If not `nil`, a dictionary from original objects to the
+ * objects they were previously mapped to. Any new mappings are added to this
+ * dictionary, so it can be reused across many changes. Use
+ * <PROIdentityMappingDictionary> to create a dictionary that does not
+ * require its keys to conform to `NSCopying`.
+ * @param block If not `nil`, this block will be invoked before inserting any
+ * new objects which are not already in `mappedObjects`. The block will be
+ * passed the object that was added in the original changes, and should return
+ * an object to add to the collection at `keyPath`. This block must not return
+ * `nil`, and must be thread-safe if `NSEnumerationConcurrent` is specified.
+ *
+ * @warning **Important:** The collection at `keyPath` must be the same length
+ * as the original collection (i.e., the collection before it was mutated and
+ * generated a KVO notification), and must be the same length as the new
+ * collection when this method completes.
+ */
+- (void)applyKeyValueChangeDictionary:(NSDictionary *)changes toKeyPath:(NSString *)keyPath options:(NSEnumerationOptions)opts mappedObjects:(NSMutableDictionary *)mappedObjects mappingNewObjectsUsingBlock:(id (^)(id))block;
+
+/**
+ * Applies a sequence of KVO changes to a to-many property, optionally
+ * transforming any new values that have been added.
+ *
+ * This has the same result as invoking
+ * <applyKeyValueChangeDictionary:toKeyPath:mappingNewObjectsUsingBlock:> with
+ * each dictionary in turn, but consecutive insertions, removals, and
+ * replacements are first folded together, and then applied to the collection
+ * with at most one removal and one insertion (or a single replacement). Objects
+ * which are inserted and then removed within the sequence are never added to
+ * the collection, or passed to `block`.
+ *
+ * `NSKeyValueChangeSetting` changes are applied individually, after any changes
+ * which precede them.
+ *
+ * @param changeDictionaries An array of change dictionaries, in the order that
+ * they were received. Each dictionary must meet the requirements of
+ * <applyKeyValueChangeDictionary:toKeyPath:mappingNewObjectsUsingBlock:>.
+ * @param keyPath A key path, relative to the receiver, at which to apply the
+ * changes. The property at this key path must hold a KVC-compliant collection
+ * (either ordered or unordered).
+ * @param block If not `nil`, this block will be invoked for each new object
+ * that remains in the collection after all of the changes, and should return an
+ * object to add to the collection at `keyPath`. This block must not return
+ * `nil`.
+ *
+ * @warning **Important:** The collection at `keyPath` must be the same length
+ * as the original collection before the first change, and must be the same
+ * length as the new collection when this method completes.
+ */
+- (void)applyKeyValueChangeDictionaries:(NSArray *)changeDictionaries toKeyPath:(NSString *)keyPath mappingNewObjectsUsingBlock:(id (^)(id))block;
+
 @end
+
+/**
+ * Returns a new, empty mutable dictionary which retains its keys instead of
+ * copying them, and compares them by identity.
+ *
+ * This is meant to be used as the `mappedObjects` argument to
+ * <[NSObject applyKeyValueChangeDictionary:toKeyPath:options:mappedObjects:mappingNewObjectsUsingBlock:]>,
+ * since observed objects often do not conform to `NSCopying`. Entries may be
+ * added with `-setObject:forKey:` as usual.
+ */
+NSMutableDictionary *PROIdentityMappingDictionary(void);
@@ -12,57 +12,255 @@
 #import "NSArray+HigherOrderAdditions.h"
 #import "NSSet+HigherOrderAdditions.h"
 #import "PROAssert.h"
+#import "PROKeyPath.h"
 
 
-static id mutableCollectionForKeyPath(id obj, NSString *keyPath) {
-    id currentValue = [obj valueForKeyPath:keyPath];
+static id mutableCollectionForKeyPath(id obj, PROKeyPath *keyPath) {
+    id currentValue = [keyPath valueForObject:obj];
     if ([currentValue isKindOfClass:[NSArray class]])
-        return [obj mutableArrayValueForKey:keyPath];
+        return [obj mutableArrayValueForKey:keyPath.string];
     else if ([currentValue isKindOfClass:[NSSet class]])
-        return [obj mutableSetValueForKeyPath:keyPath];
+        return [obj mutableSetValueForKeyPath:keyPath.string];
     else if ([currentValue isKindOfClass:[NSOrderedSet class]])
-        return [obj mutableOrderedSetValueForKeyPath:keyPath];
+        return [obj mutableOrderedSetValueForKeyPath:keyPath.string];
 
     return nil;
 }
 
+/**
+ * Returns the objects of the given array, set, or ordered set as an array.
+ */
+static NSArray *arrayWithCollection(id collection) {
+    if ([collection isKindOfClass:[NSArray class]])
+        return collection;
+    else if ([collection isKindOfClass:[NSSet class]])
+        return [collection allObjects];
+    else
+        return [collection array];
+}
 
-@safecategory (NSObject, KeyValueCodingAdditions)
+/**
+ * Applies `block` to the objects in the given collection, and optionally
+ * converts the new collection to an `NSSet`. Returns the new collection.
+ *
+ * If `block` is `nil`, the collection is not mapped. If `mappedObjects` is not
+ * `nil`, it is consulted before invoking `block` for an object, and updated
+ * with the result afterward.
+ */
+static id mappedCollection(id collection, BOOL convertToSet, NSEnumerationOptions opts, NSMutableDictionary *mappedObjects, id (^block)(id)) {
+    id newCollection = collection;
 
-- (void)applyKeyValueChangeDictionary:(NSDictionary *)changes toKeyPath:(NSString *)keyPath mappingNewObjectsUsingBlock:(id (^)(id))block;{ 
-    NSParameterAssert(changes != nil);
-    NSParameterAssert(keyPath != nil);
+    if (block) {
+        if (!PROAssert([collection respondsToSelector:@selector(mapWithOptions:usingBlock:)], @"Object %@ is not a supported collection", collection))
+            return [EXTNil null];
 
-    /**
-     * Applies `block` to the objects in the given collection, and optionally
-     * converts the new collection to an `NSSet`. Returns the new collection.
-     *
-     * If `block` is `nil`, the collection is not mapped.
-     */
-    id (^mappedCollection)(NSArray *, BOOL) = ^(id collection, BOOL convertToSet){
-        id newCollection = collection;
+        id (^mapObject)(id) = ^(id obj){
+            if (mappedObjects) {
+                id existingObj = [mappedObjects objectForKey:obj];
+                if (existingObj)
+                    return existingObj;
+            }
+
+            id newObj = block(obj);
 
-        if (block) {
-            if (!PROAssert([collection respondsToSelector:@selector(mapUsingBlock:)], @"Object %@ is not a supported collection", collection))
-                return [EXTNil null];
+            // make sure objects are never discarded from the collection
+            if (!PROAssert(newObj, @"Mapping block returned nil for input object %@", obj))
+                newObj = [EXTNil null];
 
-            newCollection = [collection mapUsingBlock:^(id obj){
-                id newObj = block(obj);
-            
-                // make sure objects are never discarded from the collection
-                if (!PROAssert(newObj, @"Mapping block returned nil for input object %@", obj))
-                    newObj = [EXTNil null];
+            return newObj;
+        };
+
+        if (!mappedObjects) {
+            newCollection = [collection mapWithOptions:opts usingBlock:mapObject];
+        } else if (!(opts & NSEnumerationConcurrent)) {
+            newCollection = [collection mapWithOptions:opts usingBlock:^(id obj){
+                id newObj = mapObject(obj);
+                [mappedObjects setObject:newObj forKey:obj];
 
                 return newObj;
             }];
+        } else {
+            // the dictionary is only read while mapping concurrently, so no
+            // lock is needed -- new entries are added once every chunk is done
+            NSArray *objects = arrayWithCollection(collection);
+            NSMutableArray *newObjects = [[objects mapWithOptions:opts usingBlock:mapObject] mutableCopy];
+
+            [objects enumerateObjectsUsingBlock:^(id obj, NSUInteger index, BOOL *stop){
+                id existingObj = [mappedObjects objectForKey:obj];
+
+                // if the same object appeared more than once, use the first
+                // mapping for all of them
+                if (existingObj)
+                    [newObjects replaceObjectAtIndex:index withObject:existingObj];
+                else
+                    [mappedObjects setObject:[newObjects objectAtIndex:index] forKey:obj];
+            }];
+
+            if ([collection isKindOfClass:[NSSet class]])
+                newCollection = [NSSet setWithArray:newObjects];
+            else if ([collection isKindOfClass:[NSOrderedSet class]])
+                newCollection = [NSOrderedSet orderedSetWithArray:newObjects];
+            else
+                newCollection = newObjects;
         }
+    }
+
+    if (convertToSet && ![newCollection isKindOfClass:[NSSet class]]) {
+        return [NSSet setWithArray:newCollection];
+    } else {
+        return newCollection;
+    }
+}
+
+/**
+ * Returns the given collection if it is already an `NSSet`, or a set of its
+ * objects otherwise.
+ */
+static NSSet *setWithCollection(id collection) {
+    if ([collection isKindOfClass:[NSSet class]])
+        return collection;
+    else
+        return [NSSet setWithArray:collection];
+}
+
+/**
+ * A mutable dictionary which retains its keys instead of copying them, and
+ * compares them by identity.
+ */
+@interface PROIdentityDictionary : NSMutableDictionary {
+    CFMutableDictionaryRef m_dictionary;
+}
+
+@end
+
+NSMutableDictionary *PROIdentityMappingDictionary(void) {
+    return [[PROIdentityDictionary alloc] init];
+}
+
+/**
+ * Returns the index which has `rank` indexes before it in `indexSet`, or
+ * `NSNotFound` if `indexSet` does not contain that many indexes.
+ */
+static NSUInteger indexAtRank(NSIndexSet *indexSet, NSUInteger rank) {
+    __block NSUInteger remaining = rank;
+    __block NSUInteger result = NSNotFound;
 
-        if (convertToSet && ![newCollection isKindOfClass:[NSSet class]]) {
-            return [NSSet setWithArray:newCollection];
+    [indexSet enumerateRangesUsingBlock:^(NSRange range, BOOL *stop){
+        if (remaining < range.length) {
+            result = range.location + remaining;
+            *stop = YES;
         } else {
-            return newCollection;
+            remaining -= range.length;
         }
-    };
+    }];
+
+    return result;
+}
+
+/**
+ * Folds a sequence of insertions and removals on an ordered collection into at
+ * most one removal and one insertion against the original collection.
+ *
+ * Objects which are inserted and later removed are never added to the
+ * collection, and objects are only mapped once, when the changes are applied.
+ */
+@interface PROOrderedChangeCoalescer : NSObject {
+    /**
+     * The number of objects in the original collection.
+     */
+    NSUInteger m_originalCount;
+
+    /**
+     * The positions, in the collection with all changes so far applied, which
+     * hold objects from the original collection.
+     */
+    NSMutableIndexSet *m_originalPositions;
+
+    /**
+     * The indexes in the original collection of those objects which have not
+     * been removed.
+     */
+    NSMutableIndexSet *m_survivingIndexes;
+
+    /**
+     * The objects which have been inserted and not removed, in the order they
+     * appear in the collection.
+     */
+    NSMutableArray *m_insertedObjects;
+}
+
+/**
+ * The number of objects in the collection with all changes so far applied.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+/**
+ * Initializes the receiver to track changes to a collection of `count`
+ * objects.
+ */
+- (id)initWithCount:(NSUInteger)count;
+
+/**
+ * Records an insertion with the semantics of `-[NSMutableArray
+ * insertObjects:atIndexes:]`.
+ */
+- (void)insertObjects:(NSArray *)objects atIndexes:(NSIndexSet *)indexes;
+
+/**
+ * Records a removal with the semantics of `-[NSMutableArray
+ * removeObjectsAtIndexes:]`.
+ */
+- (void)removeObjectsAtIndexes:(NSIndexSet *)indexes;
+
+/**
+ * Applies all of the recorded changes to `array`, which must contain the
+ * original objects, mapping inserted objects with `block` if it is not `nil`.
+ */
+- (void)applyToArray:(NSMutableArray *)array mappingNewObjectsUsingBlock:(id (^)(id))block;
+@end
+
+/**
+ * Folds a sequence of insertions and removals on an unordered collection into
+ * at most one removal and one insertion.
+ */
+@interface PROUnorderedChangeCoalescer : NSObject
+
+/**
+ * Objects which should be in the collection after the last recorded change.
+ */
+@property (nonatomic, strong, readonly) NSMutableSet *addedObjects;
+
+/**
+ * Objects which should not be in the collection after the last recorded change.
+ */
+@property (nonatomic, strong, readonly) NSMutableSet *removedObjects;
+
+/**
+ * Records the insertion of the objects in the given collection.
+ */
+- (void)addObjects:(id<NSFastEnumeration>)objects;
+
+/**
+ * Records the removal of the objects in the given collection.
+ */
+- (void)removeObjects:(id<NSFastEnumeration>)objects;
+
+/**
+ * Applies all of the recorded changes to `set`, mapping inserted objects with
+ * `block` if it is not `nil`.
+ */
+- (void)applyToSet:(NSMutableSet *)set mappingNewObjectsUsingBlock:(id (^)(id))block;
+@end
+
+@safecategory (NSObject, KeyValueCodingAdditions)
+
+- (void)applyKeyValueChangeDictionary:(NSDictionary *)changes toKeyPath:(NSString *)keyPath mappingNewObjectsUsingBlock:(id (^)(id))block;{ 
+    [self applyKeyValueChangeDictionary:changes toKeyPath:keyPath options:0 mappedObjects:nil mappingNewObjectsUsingBlock:block];
+}
+
+- (void)applyKeyValueChangeDictionary:(NSDictionary *)changes toKeyPath:(NSString *)keyPath options:(NSEnumerationOptions)opts mappedObjects:(NSMutableDictionary *)mappedObjects mappingNewObjectsUsingBlock:(id (^)(id))block; {
+    NSParameterAssert(changes != nil);
+    NSParameterAssert(keyPath != nil);
 
     NSKeyValueChange change = [[changes objectForKey:NSKeyValueChangeKindKey] unsignedIntegerValue];
     id newValue = [changes objectForKey:NSKeyValueChangeNewKey];
@@ -72,22 +270,24 @@ static id mutableCollectionForKeyPath(id obj, NSString *keyPath) {
     switch (change) {
         case NSKeyValueChangeSetting:
             if ([newValue isEqual:[NSNull null]]) {
+                PROKeyPath *compiledKeyPath = [PROKeyPath keyPathWithString:keyPath];
+
                 // Attempt to empty the collection before trying setValue:forKeyPath:
-                id mutableCollection = mutableCollectionForKeyPath(self, keyPath);
+                id mutableCollection = mutableCollectionForKeyPath(self, compiledKeyPath);
                 if (mutableCollection) {
                     [mutableCollection removeAllObjects];
                 } else {
-                    [self setValue:nil forKeyPath:keyPath];
+                    [compiledKeyPath setValue:nil forObject:self];
                 }
             } else if ([newValue isKindOfClass:[NSSet class]]) {
-                [[self mutableSetValueForKeyPath:keyPath] setSet:mappedCollection(newValue, NO)];
+                [[self mutableSetValueForKeyPath:keyPath] setSet:mappedCollection(newValue, NO, opts, mappedObjects, block)];
             } else if ([newValue isKindOfClass:[NSOrderedSet class]]) {
                 NSMutableOrderedSet *orderedSet = [self mutableOrderedSetValueForKeyPath:keyPath];
 
                 [orderedSet removeAllObjects];
-                [orderedSet unionOrderedSet:mappedCollection(newValue, NO)];
+                [orderedSet unionOrderedSet:mappedCollection(newValue, NO, opts, mappedObjects, block)];
             } else {
-                [[self mutableArrayValueForKeyPath:keyPath] setArray:mappedCollection(newValue, NO)];
+                [[self mutableArrayValueForKeyPath:keyPath] setArray:mappedCollection(newValue, NO, opts, mappedObjects, block)];
             }
 
             break;
@@ -97,9 +297,9 @@ static id mutableCollectionForKeyPath(id obj, NSString *keyPath) {
                 return;
 
             if (indexes) {
-                [[self mutableArrayValueForKeyPath:keyPath] insertObjects:mappedCollection(newValue, NO) atIndexes:indexes];
+                [[self mutableArrayValueForKeyPath:keyPath] insertObjects:mappedCollection(newValue, NO, opts, mappedObjects, block) atIndexes:indexes];
             } else {
-                [[self mutableSetValueForKeyPath:keyPath] unionSet:mappedCollection(newValue, YES)];
+                [[self mutableSetValueForKeyPath:keyPath] unionSet:mappedCollection(newValue, YES, opts, mappedObjects, block)];
             }
 
             break;
@@ -111,7 +311,7 @@ static id mutableCollectionForKeyPath(id obj, NSString *keyPath) {
                 if (!PROAssert(oldValue, @"Removed objects not provided for an unordered removal"))
                     return;
 
-                [[self mutableSetValueForKeyPath:keyPath] minusSet:[NSSet setWithArray:oldValue]];
+                [[self mutableSetValueForKeyPath:keyPath] minusSet:setWithCollection(oldValue)];
             }
 
             break;
@@ -121,14 +321,14 @@ static id mutableCollectionForKeyPath(id obj, NSString *keyPath) {
                 return;
 
             if (indexes) {
-                [[self mutableArrayValueForKeyPath:keyPath] replaceObjectsAtIndexes:indexes withObjects:mappedCollection(newValue, NO)];
+                [[self mutableArrayValueForKeyPath:keyPath] replaceObjectsAtIndexes:indexes withObjects:mappedCollection(newValue, NO, opts, mappedObjects, block)];
             } else {
                 if (!PROAssert(oldValue, @"Removed objects not provided for an unordered replacement"))
                     return;
 
                 NSMutableSet *set = [self mutableSetValueForKeyPath:keyPath];
-                [set minusSet:[NSSet setWithArray:oldValue]];
-                [set unionSet:mappedCollection(newValue, YES)];
+                [set minusSet:setWithCollection(oldValue)];
+                [set unionSet:mappedCollection(newValue, YES, opts, mappedObjects, block)];
             }
 
             break;
@@ -138,4 +338,268 @@ static id mutableCollectionForKeyPath(id obj, NSString *keyPath) {
     }
 }
 
+- (void)applyKeyValueChangeDictionaries:(NSArray *)changeDictionaries toKeyPath:(NSString *)keyPath mappingNewObjectsUsingBlock:(id (^)(id))block; {
+    NSParameterAssert(changeDictionaries != nil);
+    NSParameterAssert(keyPath != nil);
+
+    __block PROOrderedChangeCoalescer *orderedChanges = nil;
+    __block PROUnorderedChangeCoalescer *unorderedChanges = nil;
+
+    // applies and discards any changes recorded so far
+    void (^applyCoalescedChanges)(void) = ^{
+        if (orderedChanges)
+            [orderedChanges applyToArray:[self mutableArrayValueForKeyPath:keyPath] mappingNewObjectsUsingBlock:block];
+
+        if (unorderedChanges)
+            [unorderedChanges applyToSet:[self mutableSetValueForKeyPath:keyPath] mappingNewObjectsUsingBlock:block];
+
+        orderedChanges = nil;
+        unorderedChanges = nil;
+    };
+
+    for (NSDictionary *changes in changeDictionaries) {
+        NSKeyValueChange change = [[changes objectForKey:NSKeyValueChangeKindKey] unsignedIntegerValue];
+        id newValue = [changes objectForKey:NSKeyValueChangeNewKey];
+        id oldValue = [changes objectForKey:NSKeyValueChangeOldKey];
+        NSIndexSet *indexes = [changes objectForKey:NSKeyValueChangeIndexesKey];
+
+        if (change == NSKeyValueChangeSetting) {
+            // the whole collection is being replaced, so there's nothing to
+            // fold it into
+            applyCoalescedChanges();
+            [self applyKeyValueChangeDictionary:changes toKeyPath:keyPath mappingNewObjectsUsingBlock:block];
+            continue;
+        }
+
+        if (change != NSKeyValueChangeInsertion && change != NSKeyValueChangeRemoval && change != NSKeyValueChangeReplacement) {
+            PROAssert(NO, @"Unrecognized KVO change kind %i", (int)change);
+            continue;
+        }
+
+        if (change != NSKeyValueChangeRemoval && !PROAssert(newValue, @"Inserted objects not provided for change %@", changes))
+            continue;
+
+        if (indexes) {
+            if (!orderedChanges) {
+                applyCoalescedChanges();
+                orderedChanges = [[PROOrderedChangeCoalescer alloc] initWithCount:[[self valueForKeyPath:keyPath] count]];
+            }
+
+            if (change != NSKeyValueChangeInsertion)
+                [orderedChanges removeObjectsAtIndexes:indexes];
+
+            if (change != NSKeyValueChangeRemoval)
+                [orderedChanges insertObjects:newValue atIndexes:indexes];
+        } else {
+            if (change != NSKeyValueChangeInsertion && !PROAssert(oldValue, @"Removed objects not provided for unordered change %@", changes))
+                continue;
+
+            if (!unorderedChanges) {
+                applyCoalescedChanges();
+                unorderedChanges = [[PROUnorderedChangeCoalescer alloc] init];
+            }
+
+            if (change != NSKeyValueChangeInsertion)
+                [unorderedChanges removeObjects:oldValue];
+
+            if (change != NSKeyValueChangeRemoval)
+                [unorderedChanges addObjects:newValue];
+        }
+    }
+
+    applyCoalescedChanges();
+}
+
+@end
+
+@implementation PROOrderedChangeCoalescer
+
+#pragma mark Properties
+
+- (NSUInteger)count {
+    return m_originalPositions.count + m_insertedObjects.count;
+}
+
+#pragma mark Lifecycle
+
+- (id)initWithCount:(NSUInteger)count; {
+    self = [super init];
+    if (!self)
+        return nil;
+
+    m_originalCount = count;
+    m_originalPositions = [[NSMutableIndexSet alloc] initWithIndexesInRange:NSMakeRange(0, count)];
+    m_survivingIndexes = [m_originalPositions mutableCopy];
+    m_insertedObjects = [[NSMutableArray alloc] init];
+
+    return self;
+}
+
+#pragma mark Recording Changes
+
+- (void)insertObjects:(NSArray *)objects atIndexes:(NSIndexSet *)indexes; {
+    if (!PROAssert(objects.count == indexes.count, @"%lu objects provided for insertion at %lu indexes", (unsigned long)objects.count, (unsigned long)indexes.count))
+        return;
+
+    NSUInteger objectIndex = 0;
+
+    for (NSUInteger index = indexes.firstIndex; index != NSNotFound; index = [indexes indexGreaterThanIndex:index]) {
+        if (!PROAssert(index <= self.count, @"Index %lu is out of bounds for insertion into %lu objects", (unsigned long)index, (unsigned long)self.count))
+            return;
+
+        [m_originalPositions shiftIndexesStartingAtIndex:index by:1];
+
+        // the number of inserted objects which precede this position
+        NSUInteger rank = index - [m_originalPositions countOfIndexesInRange:NSMakeRange(0, index)];
+        [m_insertedObjects insertObject:[objects objectAtIndex:objectIndex++] atIndex:rank];
+    }
+}
+
+- (void)removeObjectsAtIndexes:(NSIndexSet *)indexes; {
+    if (!PROAssert(!indexes.count || indexes.lastIndex < self.count, @"Index %lu is out of bounds for removal from %lu objects", (unsigned long)indexes.lastIndex, (unsigned long)self.count))
+        return;
+
+    // remove from the end, so that earlier positions remain valid
+    for (NSUInteger index = indexes.lastIndex; index != NSNotFound; index = [indexes indexLessThanIndex:index]) {
+        NSUInteger originalsBefore = [m_originalPositions countOfIndexesInRange:NSMakeRange(0, index)];
+
+        if ([m_originalPositions containsIndex:index]) {
+            [m_survivingIndexes removeIndex:indexAtRank(m_survivingIndexes, originalsBefore)];
+            [m_originalPositions removeIndex:index];
+        } else {
+            [m_insertedObjects removeObjectAtIndex:index - originalsBefore];
+        }
+
+        [m_originalPositions shiftIndexesStartingAtIndex:index + 1 by:-1];
+    }
+}
+
+#pragma mark Applying Changes
+
+- (void)applyToArray:(NSMutableArray *)array mappingNewObjectsUsingBlock:(id (^)(id))block; {
+    NSMutableIndexSet *removedIndexes = [[NSMutableIndexSet alloc] initWithIndexesInRange:NSMakeRange(0, m_originalCount)];
+    [removedIndexes removeIndexes:m_survivingIndexes];
+
+    NSMutableIndexSet *insertedIndexes = [[NSMutableIndexSet alloc] initWithIndexesInRange:NSMakeRange(0, self.count)];
+    [insertedIndexes removeIndexes:m_originalPositions];
+
+    NSArray *insertedObjects = mappedCollection(m_insertedObjects, NO, 0, nil, block);
+
+    if (removedIndexes.count && [removedIndexes isEqualToIndexSet:insertedIndexes]) {
+        // every removed object was replaced in the same position, so the
+        // remaining objects haven't moved
+        [array replaceObjectsAtIndexes:insertedIndexes withObjects:insertedObjects];
+        return;
+    }
+
+    if (removedIndexes.count)
+        [array removeObjectsAtIndexes:removedIndexes];
+
+    if (insertedIndexes.count)
+        [array insertObjects:insertedObjects atIndexes:insertedIndexes];
+}
+
+@end
+
+@implementation PROUnorderedChangeCoalescer
+
+#pragma mark Properties
+
+@synthesize addedObjects = m_addedObjects;
+@synthesize removedObjects = m_removedObjects;
+
+#pragma mark Lifecycle
+
+- (id)init; {
+    self = [super init];
+    if (!self)
+        return nil;
+
+    m_addedObjects = [[NSMutableSet alloc] init];
+    m_removedObjects = [[NSMutableSet alloc] init];
+
+    return self;
+}
+
+#pragma mark Recording Changes
+
+- (void)addObjects:(id<NSFastEnumeration>)objects; {
+    for (id obj in objects) {
+        [self.removedObjects removeObject:obj];
+        [self.addedObjects addObject:obj];
+    }
+}
+
+- (void)removeObjects:(id<NSFastEnumeration>)objects; {
+    for (id obj in objects) {
+        [self.addedObjects removeObject:obj];
+        [self.removedObjects addObject:obj];
+    }
+}
+
+#pragma mark Applying Changes
+
+- (void)applyToSet:(NSMutableSet *)set mappingNewObjectsUsingBlock:(id (^)(id))block; {
+    if (self.removedObjects.count)
+        [set minusSet:self.removedObjects];
+
+    if (self.addedObjects.count)
+        [set unionSet:mappedCollection(self.addedObjects, YES, 0, nil, block)];
+}
+
+@end
+
+@implementation PROIdentityDictionary
+
+#pragma mark Lifecycle
+
+- (id)init {
+    return [self initWithCapacity:0];
+}
+
+- (id)initWithCapacity:(NSUInteger)capacity {
+    self = [super init];
+    if (!self)
+        return nil;
+
+    CFDictionaryKeyCallBacks keyCallBacks = kCFTypeDictionaryKeyCallBacks;
+    keyCallBacks.equal = NULL;
+    keyCallBacks.hash = NULL;
+
+    m_dictionary = CFDictionaryCreateMutable(NULL, (CFIndex)capacity, &keyCallBacks, &kCFTypeDictionaryValueCallBacks);
+    return self;
+}
+
+- (void)dealloc {
+    if (m_dictionary)
+        CFRelease(m_dictionary);
+}
+
+#pragma mark NSDictionary
+
+- (NSUInteger)count {
+    return (NSUInteger)CFDictionaryGetCount(m_dictionary);
+}
+
+- (id)objectForKey:(id)key {
+    return (__bridge id)CFDictionaryGetValue(m_dictionary, (__bridge void *)key);
+}
+
+- (NSEnumerator *)keyEnumerator {
+    return [(__bridge NSDictionary *)m_dictionary keyEnumerator];
+}
+
+#pragma mark NSMutableDictionary
+
+- (void)setObject:(id)obj forKey:(id)key {
+    NSParameterAssert(obj);
+    NSParameterAssert(key);
+
+    CFDictionarySetValue(m_dictionary, (__bridge void *)key, (__bridge void *)obj);
+}
+
+- (void)removeObjectForKey:(id)key {
+    CFDictionaryRemoveValue(m_dictionary, (__bridge void *)key);
+}
+
 @end
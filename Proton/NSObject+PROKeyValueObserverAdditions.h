@@ -13,7 +13,11 @@
  * Extends `NSObject` with conveniences that make it easier to use
  * <PROKeyValueObserver>.
  *
- * These extensions are thread-safe.
+ * These extensions are thread-safe. Owned observers are stored in a fixed set
+ * of tables sharded by owner, each with its own lock, so observers for
+ * unrelated owners can usually be added and removed without contention. Every
+ * operation takes the lock for the owner's shard; only an owner's first
+ * observer touches the runtime's associated object storage.
  */
 @interface NSObject (PROKeyValueObserverAdditions)
 /**
@@ -9,98 +9,83 @@
 #import <Proton/NSObject+PROKeyValueObserverAdditions.h>
 #import <Proton/EXTSafeCategory.h>
 #import <Proton/EXTScope.h>
-#import <libkern/OSAtomic.h>
+#import <pthread.h>
 
 /*
- * A global spin lock used to synchronize the `ownedKeyValueObserversLock`
- * associated with each object.
+ * The number of shards used to store owned observers.
  *
- * In other words, this lock is shared by all objects in order to set up
- * individual locks for each one.
+ * Each owner is assigned to one shard based on its address, so that unrelated
+ * owners rarely contend with each other. This must be a power of two.
  */
-static OSSpinLock PROAssociatedKeyValueObserversLockLock;
+#define PRO_OWNED_OBSERVER_SHARD_COUNT 64
 
-@interface NSObject (PROKeyValueObserverAdditionsPrivate)
 /*
- * A lock which synchronizes access to and mutation of the
- * <ownedKeyValueObservers> array.
- *
- * Accessing this property will atomically create a lock if one does not already
- * exist. This property should only ever be set to `nil` (never to a custom
- * lock).
+ * Stores the owned observers for every owner assigned to the shard.
  */
-@property (strong) NSLock *ownedKeyValueObserversLock;
+typedef struct {
+    /*
+     * Synchronizes access to `observersByOwner`, and to each of the sets
+     * within it.
+     *
+     * This is a mutex instead of a spin lock, so that a low-priority thread
+     * holding it cannot be starved by higher-priority threads waiting on it.
+     */
+    pthread_mutex_t lock;
+
+    /*
+     * An `NSMutableSet` of <PROKeyValueObserver> instances for each owner,
+     * keyed by the owner's address, or `NULL` if no owner in this shard has
+     * ever owned an observer.
+     *
+     * Owners are not retained, and an owner's entry is removed when it is
+     * deallocated (see <PROOwnedObserverRegistration>).
+     */
+    CFMutableDictionaryRef observersByOwner;
+} PROOwnedObserverShard;
+
+static PROOwnedObserverShard PROOwnedObserverShards[PRO_OWNED_OBSERVER_SHARD_COUNT] = {
+    [0 ... PRO_OWNED_OBSERVER_SHARD_COUNT - 1] = { .lock = PTHREAD_MUTEX_INITIALIZER, .observersByOwner = NULL }
+};
 
 /*
- * An array containing the <PROKeyValueObserver> instances that are owned by the
- * receiver.
- * 
- * The creation of, accesses to, and mutations of this array should be
- * synchronized with the <ownedKeyValueObserversLock>.
+ * Returns the shard which stores the owned observers of `owner`.
  */
-@property (nonatomic, strong) NSMutableArray *ownedKeyValueObservers;
-@end
-
-@safecategory (NSObject, PROKeyValueObserverAdditions)
-- (NSLock *)ownedKeyValueObserversLock {
-    // use the selector as a key (since it's unique)
-    void * const associatedObjectKey = @selector(ownedKeyValueObserversLock);
-
-    // since the association is atomic, we can try retrieving any existing lock
-    // without first obtaining the spin lock (only locking if we need to
-    // exclusively create one)
-    NSLock *lock = objc_getAssociatedObject(self, associatedObjectKey);
-
-    if (!lock) {
-        OSSpinLockLock(&PROAssociatedKeyValueObserversLockLock);
-
-        @onExit {
-            OSSpinLockUnlock(&PROAssociatedKeyValueObserversLockLock);
-        };
-
-        // try retrieving it again -- another thread might've set one up while
-        // we were blocked on the spin lock
-        lock = objc_getAssociatedObject(self, associatedObjectKey);
-
-        if (!lock) {
-            lock = [[NSLock alloc] init];
-            
-            // associate the lock atomically, so threads don't have to wait on
-            // the spin lock just to retrieve this object
-            objc_setAssociatedObject(self, associatedObjectKey, lock, OBJC_ASSOCIATION_RETAIN);
-        }
-    }
-
-    return lock;
-}
-
-- (void)setOwnedKeyValueObserversLock:(NSLock *)lock {
-    NSParameterAssert(!lock);
+static PROOwnedObserverShard *shardForOwner(const void *owner) {
+    uintptr_t address = (uintptr_t)owner;
 
-    // since the association is atomic, we can just set 'nil' without
-    // obtaining the spin lock
-    objc_setAssociatedObject(self, @selector(ownedKeyValueObserversLock), nil, OBJC_ASSOCIATION_RETAIN);
+    // the low bits of an object's address are always zero, so mix in some
+    // higher ones
+    uintptr_t hash = (address >> 4) ^ (address >> 12);
+    return &PROOwnedObserverShards[hash & (PRO_OWNED_OBSERVER_SHARD_COUNT - 1)];
 }
 
-- (NSMutableArray *)ownedKeyValueObservers {
-    // we can assert on -tryLock because the lock is non-recursive (i.e., this
-    // thread cannot obtain it more than once)
-    NSAssert(![self.ownedKeyValueObserversLock tryLock], @"ownedKeyValueObserversLock should be held before attempting to use %s", __func__);
+/*
+ * A unique key for associating a <PROOwnedObserverRegistration> with an owner.
+ */
+static char * const PROOwnedObserverRegistrationKey = "PROOwnedObserverRegistration";
 
-    // use the selector for this getter as a unique key
-    return objc_getAssociatedObject(self, @selector(ownedKeyValueObservers));
+/*
+ * Associated with an owner the first time it owns an observer, and removes the
+ * owner's observers from its shard when the owner is deallocated.
+ *
+ * The association is only used to tie the lifetime of the owner's entry to the
+ * owner itself. It is set once per owner, and never read.
+ */
+@interface PROOwnedObserverRegistration : NSObject {
+    /*
+     * The address of the owner whose entry should be removed. The owner is
+     * never messaged, since this object is only destroyed along with it.
+     */
+    const void *m_owner;
 }
 
-- (void)setOwnedKeyValueObservers:(NSMutableArray *)array {
-    // we can assert on -tryLock because the lock is non-recursive (i.e., this
-    // thread cannot obtain it more than once)
-    NSAssert(![self.ownedKeyValueObserversLock tryLock], @"ownedKeyValueObserversLock should be held before attempting to use %s", __func__);
-
-    // this association is nonatomic because all operations on the array should
-    // already be synchronized with our lock
-    objc_setAssociatedObject(self, @selector(ownedKeyValueObservers), array, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
-}
+/*
+ * Initializes the receiver to remove the entry for the given owner.
+ */
+- (id)initWithOwner:(id)owner;
+@end
 
+@safecategory (NSObject, PROKeyValueObserverAdditions)
 - (PROKeyValueObserver *)addObserverOwnedByObject:(NSObject *)owner forKeyPath:(NSString *)keyPath usingBlock:(PROKeyValueObserverBlock)block; {
     return [self addObserverOwnedByObject:owner forKeyPath:keyPath options:0 usingBlock:block];
 }
@@ -110,50 +95,120 @@ static OSSpinLock PROAssociatedKeyValueObserversLockLock;
     if (!observer)
         return nil;
 
+    BOOL firstObserver = NO;
+
     {
-        NSLock *observersLock = owner.ownedKeyValueObserversLock;
+        PROOwnedObserverShard *shard = shardForOwner((__bridge void *)owner);
 
-        [observersLock lock];
+        pthread_mutex_lock(&shard->lock);
         @onExit {
-            [observersLock unlock];
+            pthread_mutex_unlock(&shard->lock);
         };
 
-        // store the observer in an array associated with the owner, so we can later
-        // remove it
-        NSMutableArray *ownedObservers = owner.ownedKeyValueObservers;
-        if (!ownedObservers)
-            owner.ownedKeyValueObservers = ownedObservers = [[NSMutableArray alloc] init];
+        if (!shard->observersByOwner) {
+            // compare owners by address, and don't retain them
+            shard->observersByOwner = CFDictionaryCreateMutable(NULL, 0, NULL, &kCFTypeDictionaryValueCallBacks);
+        }
+
+        // store the observer in a set for the owner, so we can later remove it
+        NSMutableSet *ownedObservers = (__bridge id)CFDictionaryGetValue(shard->observersByOwner, (__bridge void *)owner);
+        if (!ownedObservers) {
+            ownedObservers = [[NSMutableSet alloc] init];
+            CFDictionarySetValue(shard->observersByOwner, (__bridge void *)owner, (__bridge void *)ownedObservers);
+
+            firstObserver = YES;
+        }
 
         [ownedObservers addObject:observer];
     }
 
+    if (firstObserver) {
+        // this takes a global runtime lock, so do it after unlocking the shard,
+        // and only once per owner
+        PROOwnedObserverRegistration *registration = [[PROOwnedObserverRegistration alloc] initWithOwner:owner];
+        objc_setAssociatedObject(owner, PROOwnedObserverRegistrationKey, registration, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    }
+
     return observer;
 }
 
 - (void)removeAllOwnedObservers; {
-    NSLock *observersLock = self.ownedKeyValueObserversLock;
+    NSMutableSet *ownedObservers;
 
-    [observersLock lock];
-    @onExit {
-        // we can also destroy the lock now that we've removed all observers
-        self.ownedKeyValueObserversLock = nil;
-        [observersLock unlock];
-    };
+    {
+        PROOwnedObserverShard *shard = shardForOwner((__bridge void *)self);
+
+        pthread_mutex_lock(&shard->lock);
+        @onExit {
+            pthread_mutex_unlock(&shard->lock);
+        };
 
-    // destroy the whole array
-    self.ownedKeyValueObservers = nil;
+        if (!shard->observersByOwner)
+            return;
+
+        ownedObservers = (__bridge id)CFDictionaryGetValue(shard->observersByOwner, (__bridge void *)self);
+        if (!ownedObservers.count)
+            return;
+
+        // detach the whole set, but keep an entry so that the registration
+        // associated with the receiver still owns it
+        CFDictionarySetValue(shard->observersByOwner, (__bridge void *)self, (__bridge void *)[[NSMutableSet alloc] init]);
+    }
+
+    // release the observers (and remove their KVO registrations) after
+    // unlocking, so other owners in this shard aren't blocked
+    ownedObservers = nil;
 }
 
 - (void)removeOwnedObserver:(PROKeyValueObserver *)observer; {
-    NSLock *observersLock = self.ownedKeyValueObserversLock;
+    if (!observer)
+        return;
+
+    PROOwnedObserverShard *shard = shardForOwner((__bridge void *)self);
 
-    [observersLock lock];
+    pthread_mutex_lock(&shard->lock);
     @onExit {
-        [observersLock unlock];
+        pthread_mutex_unlock(&shard->lock);
     };
 
-    NSMutableArray *ownedObservers = self.ownedKeyValueObservers;
-    [ownedObservers removeObjectIdenticalTo:observer];
+    if (!shard->observersByOwner)
+        return;
+
+    NSMutableSet *ownedObservers = (__bridge id)CFDictionaryGetValue(shard->observersByOwner, (__bridge void *)self);
+    [ownedObservers removeObject:observer];
+}
+
+@end
+
+@implementation PROOwnedObserverRegistration
+
+- (id)initWithOwner:(id)owner; {
+    self = [super init];
+    if (!self)
+        return nil;
+
+    m_owner = (__bridge void *)owner;
+    return self;
+}
+
+- (void)dealloc {
+    NSMutableSet *ownedObservers;
+
+    {
+        PROOwnedObserverShard *shard = shardForOwner(m_owner);
+
+        pthread_mutex_lock(&shard->lock);
+        @onExit {
+            pthread_mutex_unlock(&shard->lock);
+        };
+
+        ownedObservers = (__bridge id)CFDictionaryGetValue(shard->observersByOwner, m_owner);
+        CFDictionaryRemoveValue(shard->observersByOwner, m_owner);
+    }
+
+    // release the observers (and remove their KVO registrations) after
+    // unlocking, so other owners in this shard aren't blocked
+    ownedObservers = nil;
 }
 
 @end
@@ -8,11 +8,90 @@
 
 #import <Foundation/Foundation.h>
 
+@class PROLazySequence;
+
 /**
  * Higher-order functions for `NSOrderedSet`.
  */
 @interface NSOrderedSet (HigherOrderAdditions)
 
+/**
+ * Returns whether any object in the receiver passes the given test.
+ *
+ * Enumeration stops as soon as a matching object is found.
+ *
+ * @param predicate The test to apply to each element in the receiver.
+ */
+- (BOOL)anyObjectPassingTest:(BOOL (^)(id obj))predicate;
+
+/**
+ * Returns whether any object in the receiver passes the given test, applying
+ * `opts` while enumerating.
+ *
+ * Enumeration stops as soon as a matching object is found. With
+ * `NSEnumerationConcurrent`, this cancels the work of every other chunk as
+ * well.
+ *
+ * @param opts A mask of `NSEnumerationOptions` to apply when enumerating.
+ * @param predicate The test to apply to each element in the receiver. If `opts`
+ * includes `NSEnumerationConcurrent`, this block may be invoked concurrently,
+ * and must be thread-safe.
+ */
+- (BOOL)anyObjectWithOptions:(NSEnumerationOptions)opts passingTest:(BOOL (^)(id obj))predicate;
+
+/**
+ * Counts the objects in the receiver by the key returned from `block`.
+ *
+ * @param block A block which returns the key to count the given object under.
+ * The key must conform to `NSCopying`. If this block returns `nil`, the object
+ * is not counted.
+ */
+- (NSDictionary *)countByUsingBlock:(id (^)(id obj))block;
+
+/**
+ * Counts the objects in the receiver by the key returned from `block`,
+ * applying `opts` while enumerating.
+ *
+ * With `NSEnumerationConcurrent`, contiguous chunks of the receiver are
+ * counted on the concurrent global `SDQueue` into separate tables, which are
+ * merged once every chunk has finished.
+ *
+ * @param opts A mask of `NSEnumerationOptions` to apply when enumerating.
+ * @param block A block which returns the key to count the given object under.
+ * The key must conform to `NSCopying`. If this block returns `nil`, the object
+ * is not counted. If `opts` includes `NSEnumerationConcurrent`, this block may
+ * be invoked concurrently, and must be thread-safe.
+ *
+ * @return A dictionary mapping each key to an `NSNumber` containing the number
+ * of objects counted under it.
+ */
+- (NSDictionary *)countByWithOptions:(NSEnumerationOptions)opts usingBlock:(id (^)(id obj))block;
+
+/**
+ * Returns whether every object in the receiver passes the given test. If the
+ * receiver is empty, this returns `YES`.
+ *
+ * Enumeration stops as soon as an object fails the test.
+ *
+ * @param predicate The test to apply to each element in the receiver.
+ */
+- (BOOL)everyObjectPassingTest:(BOOL (^)(id obj))predicate;
+
+/**
+ * Returns whether every object in the receiver passes the given test, applying
+ * `opts` while enumerating. If the receiver is empty, this returns `YES`.
+ *
+ * Enumeration stops as soon as an object fails the test. With
+ * `NSEnumerationConcurrent`, this cancels the work of every other chunk as
+ * well.
+ *
+ * @param opts A mask of `NSEnumerationOptions` to apply when enumerating.
+ * @param predicate The test to apply to each element in the receiver. If `opts`
+ * includes `NSEnumerationConcurrent`, this block may be invoked concurrently,
+ * and must be thread-safe.
+ */
+- (BOOL)everyObjectWithOptions:(NSEnumerationOptions)opts passingTest:(BOOL (^)(id obj))predicate;
+
 /**
  * Filters the objects of the receiver with the given predicate, returning a new
  * ordered set built from those objects.
@@ -64,6 +143,29 @@
  */
 - (id)filterWithOptions:(NSEnumerationOptions)opts failedObjects:(NSOrderedSet **)failedObjects usingBlock:(BOOL(^)(id obj))block;
 
+/**
+ * Returns an ordered set of filtered objects for which `block` returns `YES`, and
+ * sets `failedObjects` to an ordered set of the objects for which `block` returned
+ * `NO`, processing contiguous chunks of `grainSize` objects at a time.
+ *
+ * This behaves like the method of the same name on `NSArray`: with
+ * `NSEnumerationConcurrent`, each chunk is filtered on the concurrent global
+ * `SDQueue` without any per-object synchronization. Without
+ * `NSEnumerationConcurrent`, `grainSize` is ignored.
+ *
+ * @param opts A mask of `NSEnumerationOptions` to apply when filtering.
+ * @param grainSize The maximum number of objects to filter in each chunk. If
+ * zero, a grain size is chosen automatically.
+ * @param failedObjects If not `NULL`, this will be a collection of all the
+ * objects for which `block` returned `NO`. If no objects failed, this will be
+ * an empty ordered set.
+ * @param block A predicate with which to filter objects in the receiver. If
+ * this block returns `YES`, the object will be added to the returned
+ * collection. If this block returns `NO`, the object will be added to
+ * `failedObjects`.
+ */
+- (id)filterWithOptions:(NSEnumerationOptions)opts grainSize:(NSUInteger)grainSize failedObjects:(NSOrderedSet **)failedObjects usingBlock:(BOOL(^)(id obj))block;
+
 /**
  * Reduces the receiver to a single value from left to right, using the given
  * block.
@@ -106,6 +208,48 @@
  */
 - (id)foldRightWithValue:(id)startingValue usingBlock:(id (^)(id left, id right))block;
 
+/**
+ * Groups the objects in the receiver by the key returned from `block`.
+ *
+ * @param block A block which returns the key to group the given object under.
+ * The key must conform to `NSCopying`. If this block returns `nil`, the object
+ * is omitted from the result.
+ *
+ * @return A dictionary mapping each key to an ordered set of the objects grouped under
+ * it.
+ */
+- (NSDictionary *)groupByUsingBlock:(id (^)(id obj))block;
+
+/**
+ * Groups the objects in the receiver by the key returned from `block`,
+ * applying `opts` while enumerating.
+ *
+ * With `NSEnumerationConcurrent`, contiguous chunks of the receiver are
+ * grouped on the concurrent global `SDQueue` into separate tables, which are
+ * merged once every chunk has finished. The objects within each
+ * group are always in the order of enumeration.
+ *
+ * @param opts A mask of `NSEnumerationOptions` to apply when enumerating.
+ * @param block A block which returns the key to group the given object under.
+ * The key must conform to `NSCopying`. If this block returns `nil`, the object
+ * is omitted from the result. If `opts` includes `NSEnumerationConcurrent`,
+ * this block may be invoked concurrently, and must be thread-safe.
+ *
+ * @return A dictionary mapping each key to an ordered set of the objects grouped under
+ * it.
+ */
+- (NSDictionary *)groupByWithOptions:(NSEnumerationOptions)opts usingBlock:(id (^)(id obj))block;
+
+/**
+ * Returns a <PROLazySequence> over the objects of the receiver.
+ *
+ * Chaining map, filter, and take stages onto the returned sequence does not
+ * create any intermediate collections. The stages are only evaluated, in
+ * a single pass over the receiver, when a terminal operation is invoked upon the
+ * sequence.
+ */
+- (PROLazySequence *)lazySequence;
+
 /**
  * Transforms each object in the receiver with the given predicate, returning
  * a new ordered set built from the resulting objects.
@@ -134,6 +278,67 @@
  */
 - (id)mapWithOptions:(NSEnumerationOptions)opts usingBlock:(id (^)(id obj))block;
 
+/**
+ * Transforms each object in the receiver with the given predicate, according to
+ * the semantics of `opts`, processing contiguous chunks of `grainSize` objects
+ * at a time.
+ *
+ * This behaves like the method of the same name on `NSArray`: with
+ * `NSEnumerationConcurrent`, each chunk is mapped on the concurrent global
+ * `SDQueue` without any per-object synchronization. Without
+ * `NSEnumerationConcurrent`, `grainSize` is ignored.
+ *
+ * @param opts A mask of `NSEnumerationOptions` to apply when mapping.
+ * @param grainSize The maximum number of objects to map in each chunk. If zero,
+ * a grain size is chosen automatically.
+ * @param block A block with which to transform each element. The element from
+ * the receiver is passed in as the `obj` argument. Returning `nil` from this
+ * block will omit the entry from the resultant ordered set.
+ */
+- (id)mapWithOptions:(NSEnumerationOptions)opts grainSize:(NSUInteger)grainSize usingBlock:(id (^)(id obj))block;
+
+/**
+ * Returns whether no object in the receiver passes the given test. If the
+ * receiver is empty, this returns `YES`.
+ *
+ * Enumeration stops as soon as a matching object is found.
+ *
+ * @param predicate The test to apply to each element in the receiver.
+ */
+- (BOOL)noObjectPassingTest:(BOOL (^)(id obj))predicate;
+
+/**
+ * Returns whether no object in the receiver passes the given test, applying
+ * `opts` while enumerating. If the receiver is empty, this returns `YES`.
+ *
+ * Enumeration stops as soon as a matching object is found. With
+ * `NSEnumerationConcurrent`, this cancels the work of every other chunk as
+ * well.
+ *
+ * @param opts A mask of `NSEnumerationOptions` to apply when enumerating.
+ * @param predicate The test to apply to each element in the receiver. If `opts`
+ * includes `NSEnumerationConcurrent`, this block may be invoked concurrently,
+ * and must be thread-safe.
+ */
+- (BOOL)noObjectWithOptions:(NSEnumerationOptions)opts passingTest:(BOOL (^)(id obj))predicate;
+
+/**
+ * Returns the object that would be at the given index if the receiver were
+ * sorted using the given comparator.
+ *
+ * This performs a quickselect over the receiver, which takes linear time on
+ * average, instead of sorting the entire receiver.
+ *
+ * Objects which `comparator` considers equal are ordered by their index in
+ * the receiver, so the result matches that of a stable sort.
+ *
+ * @param index The index of the object to return, in the sorted order. This
+ * must be less than the number of objects in the receiver. If it is not, `nil`
+ * is returned.
+ * @param comparator A comparator block which defines the sort order.
+ */
+- (id)nthObject:(NSUInteger)index usingComparator:(NSComparator)comparator;
+
 /**
  * Returns the first object in the receiver that passes the given test, or `nil`
  * if no such object exists.
@@ -153,4 +358,126 @@
  */
 - (id)objectWithOptions:(NSEnumerationOptions)opts passingTest:(BOOL (^)(id obj, NSUInteger index, BOOL *stop))predicate;
 
+/**
+ * Returns an ordered set of the first `maximumCount` objects in the receiver
+ * which pass the given test, stopping as soon as that many have been found.
+ *
+ * @param maximumCount The maximum number of objects to return.
+ * @param predicate The test to apply to each element in the receiver.
+ */
+- (id)objectsWithMaximumCount:(NSUInteger)maximumCount passingTest:(BOOL (^)(id obj))predicate;
+
+/**
+ * Returns an ordered set of up to `maximumCount` objects in the receiver which
+ * pass the given test, applying `opts` while enumerating.
+ *
+ * Without `NSEnumerationConcurrent`, the result contains the first matching
+ * objects in the order of enumeration. With `NSEnumerationConcurrent`, the
+ * receiver is searched in chunks on the concurrent global `SDQueue`, and the
+ * result may contain any matching objects (still in the order of enumeration).
+ * Either way, enumeration stops as soon as enough objects have been found.
+ *
+ * @param opts A mask of `NSEnumerationOptions` to apply when enumerating.
+ * @param maximumCount The maximum number of objects to return.
+ * @param predicate The test to apply to each element in the receiver. If `opts`
+ * includes `NSEnumerationConcurrent`, this block may be invoked concurrently,
+ * and must be thread-safe.
+ */
+- (id)objectsWithOptions:(NSEnumerationOptions)opts maximumCount:(NSUInteger)maximumCount passingTest:(BOOL (^)(id obj))predicate;
+
+/**
+ * Returns an array of up to `topCount` objects which would come first if the
+ * receiver were sorted using the given comparator, applying `opts` while
+ * enumerating.
+ *
+ * Objects are selected with a heap that never holds more than `topCount`
+ * objects, which takes O(n log k) time instead of the O(n log n) needed to
+ * sort the entire receiver. With `NSEnumerationConcurrent`, contiguous chunks
+ * of the receiver are selected into separate heaps on the concurrent global
+ * `SDQueue`, and the sorted results of adjacent chunks are then merged.
+ *
+ * Objects which `comparator` considers equal are ordered by their index in
+ * the receiver (or by their reverse index, with `NSEnumerationReverse`), so the
+ * result matches that of a stable sort.
+ *
+ * @param opts A mask of `NSEnumerationOptions` to apply when enumerating.
+ * @param topCount The maximum number of objects to return.
+ * @param comparator A comparator block which defines the sort order. If `opts`
+ * includes `NSEnumerationConcurrent`, this block may be invoked concurrently,
+ * and must be thread-safe.
+ *
+ * @return An array of the selected objects, in sorted order.
+ */
+- (NSArray *)objectsWithOptions:(NSEnumerationOptions)opts topCount:(NSUInteger)topCount usingComparator:(NSComparator)comparator;
+
+/**
+ * Returns an array of up to `topCount` objects which would come first if the
+ * receiver were sorted using the given comparator.
+ *
+ * This is equivalent to sorting the receiver and taking the first `topCount`
+ * objects, but only keeps `topCount` objects in a heap while enumerating,
+ * which takes O(n log k) time.
+ *
+ * Objects which `comparator` considers equal are ordered by their index in
+ * the receiver, so the result matches that of a stable sort.
+ *
+ * @param topCount The maximum number of objects to return.
+ * @param comparator A comparator block which defines the sort order.
+ *
+ * @return An array of the selected objects, in sorted order.
+ */
+- (NSArray *)objectsWithTopCount:(NSUInteger)topCount usingComparator:(NSComparator)comparator;
+
+/**
+ * Distributes the objects in the receiver into numbered buckets.
+ *
+ * @param block A block which returns the index of the bucket for the given
+ * object. If this block returns `NSNotFound`, the object is omitted from the
+ * result.
+ *
+ * @return An array with one element per bucket (up to the highest index
+ * returned from `block`), where each element is an ordered set of the objects in
+ * that bucket. Buckets which received no objects will be empty.
+ */
+- (NSArray *)partitionUsingBlock:(NSUInteger (^)(id obj))block;
+
+/**
+ * Distributes the objects in the receiver into numbered buckets, applying
+ * `opts` while enumerating.
+ *
+ * With `NSEnumerationConcurrent`, contiguous chunks of the receiver are
+ * distributed on the concurrent global `SDQueue` into separate buckets, which
+ * are merged once every chunk has finished. The objects within each
+ * bucket are always in the order of enumeration.
+ *
+ * @param opts A mask of `NSEnumerationOptions` to apply when enumerating.
+ * @param block A block which returns the index of the bucket for the given
+ * object. If this block returns `NSNotFound`, the object is omitted from the
+ * result. If `opts` includes `NSEnumerationConcurrent`, this block may be
+ * invoked concurrently, and must be thread-safe.
+ *
+ * @return An array with one element per bucket (up to the highest index
+ * returned from `block`), where each element is an ordered set of the objects in
+ * that bucket. Buckets which received no objects will be empty.
+ */
+- (NSArray *)partitionWithOptions:(NSEnumerationOptions)opts usingBlock:(NSUInteger (^)(id obj))block;
+
+/**
+ * Reduces the receiver to a single value by folding contiguous chunks of the
+ * receiver concurrently, and then combining the partial results.
+ *
+ * Each chunk is folded from left to right (starting with `identity`) on the
+ * concurrent global `SDQueue`, and the partial results of adjacent chunks are
+ * then combined with `block` in a balanced tree. Because partial results are
+ * always combined in order, the result for an associative `block` is equal to
+ * that of <foldLeftWithValue:usingBlock:> with the same arguments.
+ *
+ * @param identity An identity value for `block`, such that combining
+ * `identity` with any value results in that same value. If the receiver is
+ * empty, this is the value returned.
+ * @param block An associative block that combines two values. This block may be
+ * invoked concurrently, and must be thread-safe.
+ */
+- (id)reduceWithIdentity:(id)identity usingBlock:(id (^)(id left, id right))block;
+
 @end
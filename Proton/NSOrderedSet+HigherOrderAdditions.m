@@ -10,10 +10,42 @@
 #import <Proton/EXTSafeCategory.h>
 #import <Proton/EXTScope.h>
 #import <Proton/NSArray+HigherOrderAdditions.h>
-#import <libkern/OSAtomic.h>
+#import <Proton/NSDictionary+HigherOrderAdditions.h>
+#import <Proton/PROConcurrentFunctions.h>
+#import <Proton/PROLazySequence.h>
 
 @safecategory (NSOrderedSet, HigherOrderAdditions)
 
+/*
+ * Most of these methods forward to the `NSArray` implementation, since any
+ * operation on an ordered set is equivalent to the same operation on that set
+ * represented as an array.
+ */
+
+- (BOOL)anyObjectPassingTest:(BOOL (^)(id obj))predicate; {
+    return [self anyObjectWithOptions:0 passingTest:predicate];
+}
+
+- (BOOL)anyObjectWithOptions:(NSEnumerationOptions)opts passingTest:(BOOL (^)(id obj))predicate; {
+    return [[self array] anyObjectWithOptions:opts passingTest:predicate];
+}
+
+- (NSDictionary *)countByUsingBlock:(id (^)(id obj))block; {
+    return [self countByWithOptions:0 usingBlock:block];
+}
+
+- (NSDictionary *)countByWithOptions:(NSEnumerationOptions)opts usingBlock:(id (^)(id obj))block; {
+    return [[self array] countByWithOptions:opts usingBlock:block];
+}
+
+- (BOOL)everyObjectPassingTest:(BOOL (^)(id obj))predicate; {
+    return [self everyObjectWithOptions:0 passingTest:predicate];
+}
+
+- (BOOL)everyObjectWithOptions:(NSEnumerationOptions)opts passingTest:(BOOL (^)(id obj))predicate; {
+    return [[self array] everyObjectWithOptions:opts passingTest:predicate];
+}
+
 - (id)filterUsingBlock:(BOOL(^)(id obj))block {
     return [self filterWithOptions:0 usingBlock:block];
 }
@@ -27,137 +59,72 @@
 }
 
 - (id)filterWithOptions:(NSEnumerationOptions)opts failedObjects:(NSOrderedSet **)failedObjects usingBlock:(BOOL(^)(id obj))block; {
-    NSIndexSet *successIndexes = [self indexesOfObjectsWithOptions:opts passingTest:^(id obj, NSUInteger idx, BOOL *stop) {
-        return block(obj);
-    }];
+    // share the compaction logic of NSArray, which works on the same indexes
+    __autoreleasing NSArray *failedArray = nil;
+    NSArray *passedArray = [[self array] filterWithOptions:opts failedObjects:(failedObjects ? &failedArray : NULL) usingBlock:block];
 
-    if (opts & NSEnumerationReverse) {
-        NSMutableOrderedSet *mutableSuccess = [[NSMutableOrderedSet alloc] initWithCapacity:[successIndexes count]];
+    if (failedObjects)
+        *failedObjects = [NSOrderedSet orderedSetWithArray:failedArray];
 
-        NSMutableOrderedSet *mutableFailed = nil;
-        if (failedObjects)
-            mutableFailed = [[NSMutableOrderedSet alloc] initWithCapacity:[self count] - [successIndexes count] - 1];
-
-        [self enumerateObjectsWithOptions:NSEnumerationReverse usingBlock:^(id obj, NSUInteger index, BOOL *stop){
-            if ([successIndexes containsIndex:index])
-                [mutableSuccess addObject:obj];
-            else
-                [mutableFailed addObject:obj];
-        }];
-
-        if (failedObjects)
-            *failedObjects = [mutableFailed copy];
-
-        return [mutableSuccess copy];
-    } else {
-        if (failedObjects) {
-            NSUInteger totalCount = self.count;
+    return [NSOrderedSet orderedSetWithArray:passedArray];
+}
 
-            NSMutableIndexSet *failedIndexes = [[NSMutableIndexSet alloc] initWithIndexesInRange:NSMakeRange(0, totalCount)];
-            [failedIndexes removeIndexes:successIndexes];
+- (id)filterWithOptions:(NSEnumerationOptions)opts grainSize:(NSUInteger)grainSize failedObjects:(NSOrderedSet **)failedObjects usingBlock:(BOOL(^)(id obj))block; {
+    __autoreleasing NSArray *failedArray = nil;
+    NSArray *passedArray = [[self array] filterWithOptions:opts grainSize:grainSize failedObjects:(failedObjects ? &failedArray : NULL) usingBlock:block];
 
-            *failedObjects = [NSOrderedSet orderedSetWithArray:[self objectsAtIndexes:failedIndexes]];
-        }
+    if (failedObjects)
+        *failedObjects = [NSOrderedSet orderedSetWithArray:failedArray];
 
-        return [NSOrderedSet orderedSetWithArray:[self objectsAtIndexes:successIndexes]];
-    }
+    return [NSOrderedSet orderedSetWithArray:passedArray];
 }
 
 - (id)foldLeftWithValue:(id)startingValue usingBlock:(id (^)(id left, id right))block; {
-    // a fold on an ordered set is equivalent to a fold on that set represented
-    // as an array
     return [[self array] foldLeftWithValue:startingValue usingBlock:block];
 }
 
 - (id)foldRightWithValue:(id)startingValue usingBlock:(id (^)(id left, id right))block; {
-    // a fold on an ordered set is equivalent to a fold on that set represented
-    // as an array
     return [[self array] foldRightWithValue:startingValue usingBlock:block];
 }
 
+- (NSDictionary *)groupByUsingBlock:(id (^)(id obj))block; {
+    return [self groupByWithOptions:0 usingBlock:block];
+}
+
+- (NSDictionary *)groupByWithOptions:(NSEnumerationOptions)opts usingBlock:(id (^)(id obj))block; {
+    NSDictionary *groups = [[self array] groupByWithOptions:opts usingBlock:block];
+
+    return [groups mapValuesUsingBlock:^(id key, NSArray *group){
+        return [NSOrderedSet orderedSetWithArray:group];
+    }];
+}
+
+- (PROLazySequence *)lazySequence; {
+    return [PROLazySequence sequenceWithCollection:self];
+}
+
 - (id)mapUsingBlock:(id (^)(id obj))block; {
     return [self mapWithOptions:0 usingBlock:block];
 }
 
 - (id)mapWithOptions:(NSEnumerationOptions)opts usingBlock:(id (^)(id obj))block; {
-    NSUInteger originalCount = [self count];
-
-    BOOL concurrent = (opts & NSEnumerationConcurrent);
-    BOOL reverse = (opts & NSEnumerationReverse);
-
-    __strong volatile id *objects = (__strong id *)calloc(originalCount, sizeof(*objects));
-    if (!objects) {
-        return nil;
-    }
+    return [NSOrderedSet orderedSetWithArray:[[self array] mapWithOptions:opts usingBlock:block]];
+}
 
-    // declare this variable way up here so that it can be used in the @onExit
-    // block below (avoiding unnecessary iteration)
-    __block NSUInteger actualCount = originalCount;
+- (id)mapWithOptions:(NSEnumerationOptions)opts grainSize:(NSUInteger)grainSize usingBlock:(id (^)(id obj))block; {
+    return [NSOrderedSet orderedSetWithArray:[[self array] mapWithOptions:opts grainSize:grainSize usingBlock:block]];
+}
 
-    @onExit {
-        for (NSUInteger i = 0;i < actualCount;++i) {
-            // nil out everything in the array to make sure ARC releases
-            // everything appropriately
-            objects[i] = nil;
-        }
+- (BOOL)noObjectPassingTest:(BOOL (^)(id obj))predicate; {
+    return [self noObjectWithOptions:0 passingTest:predicate];
+}
 
-        free((void *)objects);
-    };
+- (BOOL)noObjectWithOptions:(NSEnumerationOptions)opts passingTest:(BOOL (^)(id obj))predicate; {
+    return ![self anyObjectWithOptions:opts passingTest:predicate];
+}
 
-    // if this gets incremented while enumerating, 'objects' contains some
-    // (indeterminate) number of nil values, and must be compacted before
-    // creating an NSOrderedSet
-    volatile int32_t needsCompaction = 0;
-
-    {
-        // create a pointer outside of the block so that we don't have to use the
-        // __block qualifier in order to pass this variable to atomic functions
-        volatile int32_t *needsCompactionPtr = &needsCompaction;
-
-        [self enumerateObjectsWithOptions:opts usingBlock:^(id obj, NSUInteger index, BOOL *stop){
-            id result = block(obj);
-            
-            if (!result) {
-                if (concurrent) {
-                    // indicate that the array will need compaction, because it now has
-                    // nil values in it
-                    OSAtomicIncrement32(needsCompactionPtr);
-                } else {
-                    *needsCompactionPtr = 1;
-                }
-
-                return;
-            }
-
-            if (reverse)
-                index = originalCount - index - 1;
-
-            // only need to store into the array on success, since it was filled
-            // with zeroes on allocation
-            objects[index] = result;
-        }];
-
-        if (concurrent) {
-            // finish all assignments into the 'objects' array and 'needsCompaction'
-            // variable
-            OSMemoryBarrier();
-        }
-    }
-
-    if (needsCompaction) {
-        for (NSUInteger index = 0;index < actualCount;) {
-            if (objects[index]) {
-                ++index;
-                continue;
-            }
-
-            // otherwise, move down everything above
-            memmove((void *)(objects + index), (void *)(objects + index + 1), sizeof(*objects) * (originalCount - index - 1));
-            --actualCount;
-        }
-    }
-
-    return [NSOrderedSet orderedSetWithObjects:(id *)objects count:actualCount];
+- (id)nthObject:(NSUInteger)index usingComparator:(NSComparator)comparator; {
+    return [[self array] nthObject:index usingComparator:comparator];
 }
 
 - (id)objectPassingTest:(BOOL (^)(id obj, NSUInteger index, BOOL *stop))predicate; {
@@ -165,6 +132,11 @@
 }
 
 - (id)objectWithOptions:(NSEnumerationOptions)opts passingTest:(BOOL (^)(id obj, NSUInteger index, BOOL *stop))predicate; {
+    PROAutomaticEnumeration automaticEnumeration = PROBeginAutomaticEnumeration(&opts, [self count], predicate);
+    @onExit {
+        PROEndAutomaticEnumeration(automaticEnumeration);
+    };
+
     NSUInteger index = [self indexOfObjectWithOptions:opts passingTest:predicate];
     if (index == NSNotFound)
         return nil;
@@ -172,4 +144,36 @@
         return [self objectAtIndex:index];
 }
 
+- (id)objectsWithMaximumCount:(NSUInteger)maximumCount passingTest:(BOOL (^)(id obj))predicate; {
+    return [self objectsWithOptions:0 maximumCount:maximumCount passingTest:predicate];
+}
+
+- (id)objectsWithOptions:(NSEnumerationOptions)opts maximumCount:(NSUInteger)maximumCount passingTest:(BOOL (^)(id obj))predicate; {
+    return [NSOrderedSet orderedSetWithArray:[[self array] objectsWithOptions:opts maximumCount:maximumCount passingTest:predicate]];
+}
+
+- (NSArray *)objectsWithOptions:(NSEnumerationOptions)opts topCount:(NSUInteger)topCount usingComparator:(NSComparator)comparator; {
+    return [[self array] objectsWithOptions:opts topCount:topCount usingComparator:comparator];
+}
+
+- (NSArray *)objectsWithTopCount:(NSUInteger)topCount usingComparator:(NSComparator)comparator; {
+    return [self objectsWithOptions:0 topCount:topCount usingComparator:comparator];
+}
+
+- (NSArray *)partitionUsingBlock:(NSUInteger (^)(id obj))block; {
+    return [self partitionWithOptions:0 usingBlock:block];
+}
+
+- (NSArray *)partitionWithOptions:(NSEnumerationOptions)opts usingBlock:(NSUInteger (^)(id obj))block; {
+    NSArray *buckets = [[self array] partitionWithOptions:opts usingBlock:block];
+
+    return [buckets mapUsingBlock:^(NSArray *bucket){
+        return [NSOrderedSet orderedSetWithArray:bucket];
+    }];
+}
+
+- (id)reduceWithIdentity:(id)identity usingBlock:(id (^)(id left, id right))block; {
+    return [[self array] reduceWithIdentity:identity usingBlock:block];
+}
+
 @end
@@ -9,15 +9,84 @@
 #import <Proton/NSSet+HigherOrderAdditions.h>
 #import <Proton/EXTSafeCategory.h>
 #import <Proton/EXTScope.h>
+#import <Proton/NSArray+HigherOrderAdditions.h>
+#import <Proton/NSDictionary+HigherOrderAdditions.h>
+#import <Proton/PROConcurrentFunctions.h>
+#import <Proton/PROLazySequence.h>
 #import <libkern/OSAtomic.h>
 
 @safecategory (NSSet, HigherOrderAdditions)
 
+/*
+ * Many of these methods forward to the `NSArray` implementation, since the
+ * objects need to be indexable in order to be split into chunks (or partially
+ * ordered).
+ */
+
+- (BOOL)anyObjectPassingTest:(BOOL (^)(id obj))predicate; {
+    return [self anyObjectWithOptions:0 passingTest:predicate];
+}
+
+- (BOOL)anyObjectWithOptions:(NSEnumerationOptions)opts passingTest:(BOOL (^)(id obj))predicate; {
+    NSParameterAssert(predicate != nil);
+
+    PROAutomaticEnumeration automaticEnumeration = PROBeginAutomaticEnumeration(&opts, [self count], predicate);
+    @onExit {
+        PROEndAutomaticEnumeration(automaticEnumeration);
+    };
+
+    if (opts & NSEnumerationConcurrent) {
+        return [[self allObjects] anyObjectWithOptions:opts passingTest:predicate];
+    }
+
+    __block BOOL found = NO;
+
+    [self enumerateObjectsUsingBlock:^(id obj, BOOL *stop){
+        if (predicate(obj)) {
+            found = YES;
+            *stop = YES;
+        }
+    }];
+
+    return found;
+}
+
+- (NSDictionary *)countByUsingBlock:(id (^)(id obj))block; {
+    return [self countByWithOptions:0 usingBlock:block];
+}
+
+- (NSDictionary *)countByWithOptions:(NSEnumerationOptions)opts usingBlock:(id (^)(id obj))block; {
+    return [[self allObjects] countByWithOptions:opts usingBlock:block];
+}
+
+- (BOOL)everyObjectPassingTest:(BOOL (^)(id obj))predicate; {
+    return [self everyObjectWithOptions:0 passingTest:predicate];
+}
+
+- (BOOL)everyObjectWithOptions:(NSEnumerationOptions)opts passingTest:(BOOL (^)(id obj))predicate; {
+    NSParameterAssert(predicate != nil);
+
+    PROAutomaticEnumeration automaticEnumeration = PROBeginAutomaticEnumeration(&opts, [self count], predicate);
+    @onExit {
+        PROEndAutomaticEnumeration(automaticEnumeration);
+    };
+
+    // search for a counterexample
+    return ![self anyObjectWithOptions:opts passingTest:^ BOOL (id obj){
+        return !predicate(obj);
+    }];
+}
+
 - (id)filterUsingBlock:(BOOL (^)(id obj))block; {
     return [self filterWithOptions:0 usingBlock:block];
 }
 
 - (id)filterWithOptions:(NSEnumerationOptions)opts usingBlock:(BOOL (^)(id obj))block; {
+    PROAutomaticEnumeration automaticEnumeration = PROBeginAutomaticEnumeration(&opts, [self count], block);
+    @onExit {
+        PROEndAutomaticEnumeration(automaticEnumeration);
+    };
+
     return [self objectsWithOptions:opts passingTest:^(id obj, BOOL *stop){
         return block(obj);
     }];
@@ -29,6 +98,12 @@
 
 - (id)filterWithOptions:(NSEnumerationOptions)opts failedObjects:(NSSet **)failedObjects usingBlock:(BOOL(^)(id obj))block; {
     NSUInteger originalCount = [self count];
+
+    PROAutomaticEnumeration automaticEnumeration = PROBeginAutomaticEnumeration(&opts, originalCount, block);
+    @onExit {
+        PROEndAutomaticEnumeration(automaticEnumeration);
+    };
+
     BOOL concurrent = (opts & NSEnumerationConcurrent);
 
     // this will be used to store both the successful objects (starting from the
@@ -83,6 +158,16 @@
     return [NSSet setWithObjects:(id *)objects count:successCount];
 }
 
+- (id)filterWithOptions:(NSEnumerationOptions)opts grainSize:(NSUInteger)grainSize failedObjects:(NSSet **)failedObjects usingBlock:(BOOL(^)(id obj))block; {
+    __autoreleasing NSArray *failedArray = nil;
+    NSArray *passedArray = [[self allObjects] filterWithOptions:opts grainSize:grainSize failedObjects:(failedObjects ? &failedArray : NULL) usingBlock:block];
+
+    if (failedObjects)
+        *failedObjects = [NSSet setWithArray:failedArray];
+
+    return [NSSet setWithArray:passedArray];
+}
+
 - (id)foldWithValue:(id)startingValue usingBlock:(id (^)(id left, id right))block; {
     __block id value = startingValue;
 
@@ -93,12 +178,34 @@
     return value;
 }
 
+- (NSDictionary *)groupByUsingBlock:(id (^)(id obj))block; {
+    return [self groupByWithOptions:0 usingBlock:block];
+}
+
+- (NSDictionary *)groupByWithOptions:(NSEnumerationOptions)opts usingBlock:(id (^)(id obj))block; {
+    NSDictionary *groups = [[self allObjects] groupByWithOptions:opts usingBlock:block];
+
+    return [groups mapValuesUsingBlock:^(id key, NSArray *group){
+        return [NSSet setWithArray:group];
+    }];
+}
+
+- (PROLazySequence *)lazySequence; {
+    return [PROLazySequence sequenceWithCollection:self];
+}
+
 - (id)mapUsingBlock:(id (^)(id obj))block; {
     return [self mapWithOptions:0 usingBlock:block];
 }
 
 - (id)mapWithOptions:(NSEnumerationOptions)opts usingBlock:(id (^)(id obj))block; {
     NSUInteger originalCount = [self count];
+
+    PROAutomaticEnumeration automaticEnumeration = PROBeginAutomaticEnumeration(&opts, originalCount, block);
+    @onExit {
+        PROEndAutomaticEnumeration(automaticEnumeration);
+    };
+
     BOOL concurrent = (opts & NSEnumerationConcurrent);
 
     __strong volatile id *objects = (__strong id *)calloc(originalCount, sizeof(*objects));
@@ -144,11 +251,32 @@
     return [NSSet setWithObjects:(id *)objects count:(NSUInteger)nextIndex];
 }
 
+- (id)mapWithOptions:(NSEnumerationOptions)opts grainSize:(NSUInteger)grainSize usingBlock:(id (^)(id obj))block; {
+    return [NSSet setWithArray:[[self allObjects] mapWithOptions:opts grainSize:grainSize usingBlock:block]];
+}
+
+- (BOOL)noObjectPassingTest:(BOOL (^)(id obj))predicate; {
+    return [self noObjectWithOptions:0 passingTest:predicate];
+}
+
+- (BOOL)noObjectWithOptions:(NSEnumerationOptions)opts passingTest:(BOOL (^)(id obj))predicate; {
+    return ![self anyObjectWithOptions:opts passingTest:predicate];
+}
+
+- (id)nthObject:(NSUInteger)index usingComparator:(NSComparator)comparator; {
+    return [[self allObjects] nthObject:index usingComparator:comparator];
+}
+
 - (id)objectPassingTest:(BOOL (^)(id obj, BOOL *stop))predicate; {
     return [self objectWithOptions:0 passingTest:predicate];
 }
 
 - (id)objectWithOptions:(NSEnumerationOptions)opts passingTest:(BOOL (^)(id obj, BOOL *stop))predicate; {
+    PROAutomaticEnumeration automaticEnumeration = PROBeginAutomaticEnumeration(&opts, [self count], predicate);
+    @onExit {
+        PROEndAutomaticEnumeration(automaticEnumeration);
+    };
+
     BOOL concurrent = (opts & NSEnumerationConcurrent);
 
     void * volatile match = NULL;
@@ -167,6 +295,10 @@
         } else {
             *matchPtr = (__bridge void *)obj;
         }
+
+        // any match will do, so cancel the enumeration (including any other
+        // concurrent invocations)
+        *stop = YES;
     }];
 
     if (concurrent) {
@@ -179,4 +311,60 @@
     return [(__bridge id)match self];
 }
 
+- (id)objectsWithMaximumCount:(NSUInteger)maximumCount passingTest:(BOOL (^)(id obj))predicate; {
+    return [self objectsWithOptions:0 maximumCount:maximumCount passingTest:predicate];
+}
+
+- (id)objectsWithOptions:(NSEnumerationOptions)opts maximumCount:(NSUInteger)maximumCount passingTest:(BOOL (^)(id obj))predicate; {
+    NSParameterAssert(predicate != nil);
+
+    PROAutomaticEnumeration automaticEnumeration = PROBeginAutomaticEnumeration(&opts, [self count], predicate);
+    @onExit {
+        PROEndAutomaticEnumeration(automaticEnumeration);
+    };
+
+    if (opts & NSEnumerationConcurrent) {
+        return [NSSet setWithArray:[[self allObjects] objectsWithOptions:opts maximumCount:maximumCount passingTest:predicate]];
+    }
+
+    NSMutableSet *matchingObjects = [[NSMutableSet alloc] init];
+
+    if (maximumCount) {
+        [self enumerateObjectsUsingBlock:^(id obj, BOOL *stop){
+            if (!predicate(obj))
+                return;
+
+            [matchingObjects addObject:obj];
+            if (matchingObjects.count >= maximumCount)
+                *stop = YES;
+        }];
+    }
+
+    return [matchingObjects copy];
+}
+
+- (NSArray *)objectsWithOptions:(NSEnumerationOptions)opts topCount:(NSUInteger)topCount usingComparator:(NSComparator)comparator; {
+    return [[self allObjects] objectsWithOptions:opts topCount:topCount usingComparator:comparator];
+}
+
+- (NSArray *)objectsWithTopCount:(NSUInteger)topCount usingComparator:(NSComparator)comparator; {
+    return [self objectsWithOptions:0 topCount:topCount usingComparator:comparator];
+}
+
+- (NSArray *)partitionUsingBlock:(NSUInteger (^)(id obj))block; {
+    return [self partitionWithOptions:0 usingBlock:block];
+}
+
+- (NSArray *)partitionWithOptions:(NSEnumerationOptions)opts usingBlock:(NSUInteger (^)(id obj))block; {
+    NSArray *buckets = [[self allObjects] partitionWithOptions:opts usingBlock:block];
+
+    return [buckets mapUsingBlock:^(NSArray *bucket){
+        return [NSSet setWithArray:bucket];
+    }];
+}
+
+- (id)reduceWithIdentity:(id)identity usingBlock:(id (^)(id left, id right))block; {
+    return [[self allObjects] reduceWithIdentity:identity usingBlock:block];
+}
+
 @end
@@ -8,6 +8,7 @@
 
 #import "PROBinding.h"
 #import "EXTScope.h"
+#import "PROKeyPath.h"
 #import "PROKeyValueObserver.h"
 #import "PROLogging.h"
 #import <objc/runtime.h>
@@ -40,6 +41,16 @@ static char * const PROBindingOwnerAssociatedBindingsKey = "PROBindingOwnerAssoc
  */
 @property (nonatomic, strong) PROKeyValueObserver *boundObjectObserver;
 
+/**
+ * The <ownerKeyPath>, compiled for repeated use.
+ */
+@property (nonatomic, strong, readonly) PROKeyPath *compiledOwnerKeyPath;
+
+/**
+ * The <boundKeyPath>, compiled for repeated use.
+ */
+@property (nonatomic, strong, readonly) PROKeyPath *compiledBoundKeyPath;
+
 /**
  * Whether the <owner> or <boundObject> is currently being updated from a change
  * to the other.
@@ -57,6 +68,8 @@ static char * const PROBindingOwnerAssociatedBindingsKey = "PROBindingOwnerAssoc
 @synthesize ownerKeyPath = m_ownerKeyPath;
 @synthesize boundObject = m_boundObject;
 @synthesize boundKeyPath = m_boundKeyPath;
+@synthesize compiledOwnerKeyPath = m_compiledOwnerKeyPath;
+@synthesize compiledBoundKeyPath = m_compiledBoundKeyPath;
 @synthesize ownerObserver = m_ownerObserver;
 @synthesize boundObjectObserver = m_boundObjectObserver;
 @synthesize boundValueTransformationBlock = m_boundValueTransformationBlock;
@@ -136,6 +149,9 @@ static char * const PROBindingOwnerAssociatedBindingsKey = "PROBindingOwnerAssoc
     m_ownerKeyPath = [ownerKeyPath copy];
     m_boundKeyPath = [boundKeyPath copy];
 
+    m_compiledOwnerKeyPath = [PROKeyPath keyPathWithString:m_ownerKeyPath];
+    m_compiledBoundKeyPath = [PROKeyPath keyPathWithString:m_boundKeyPath];
+
     __weak PROBinding *weakSelf = self;
 
     self.ownerObserver = [[PROKeyValueObserver alloc]
@@ -240,7 +256,7 @@ static char * const PROBindingOwnerAssociatedBindingsKey = "PROBindingOwnerAssoc
     if (!owner)
         return;
 
-    id value = [owner valueForKeyPath:self.ownerKeyPath];
+    id value = [self.compiledOwnerKeyPath valueForObject:owner];
     if (self.ownerValueTransformationBlock)
         value = self.ownerValueTransformationBlock(value);
 
@@ -252,7 +268,7 @@ static char * const PROBindingOwnerAssociatedBindingsKey = "PROBindingOwnerAssoc
         return;
     }
 
-    [self.boundObject setValue:value forKeyPath:self.boundKeyPath];
+    [self.compiledBoundKeyPath setValue:value forObject:self.boundObject];
 }
 
 - (IBAction)boundObjectChanged:(id)sender; {
@@ -264,7 +280,7 @@ static char * const PROBindingOwnerAssociatedBindingsKey = "PROBindingOwnerAssoc
         self.updating = NO;
     };
 
-    id value = [self.boundObject valueForKeyPath:self.boundKeyPath];
+    id value = [self.compiledBoundKeyPath valueForObject:self.boundObject];
     if (self.boundValueTransformationBlock)
         value = self.boundValueTransformationBlock(value);
 
@@ -276,7 +292,7 @@ static char * const PROBindingOwnerAssociatedBindingsKey = "PROBindingOwnerAssoc
         return;
     }
 
-    [self.owner setValue:value forKeyPath:self.ownerKeyPath];
+    [self.compiledOwnerKeyPath setValue:value forObject:self.owner];
 }
 
 #pragma mark NSObject overrides
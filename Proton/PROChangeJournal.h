@@ -0,0 +1,129 @@
+//
+//  PROChangeJournal.h
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * An ordered log of key-value observing changes, which can be replayed onto
+ * another object.
+ *
+ * Changes are stored in a compact binary form (the kind of change, an
+ * identifier for the key path, the affected index ranges, and references to the
+ * objects involved) in a single growable buffer. Unlike queuing change
+ * dictionaries, recording a change does not allocate a dictionary, an
+ * `NSNumber`, or an `NSIndexSet`.
+ *
+ * Positions in the journal are identified by checkpoints, which are simply
+ * counts of changes. The current <count> is a checkpoint for the end of the
+ * journal.
+ *
+ * This class is not thread-safe. If changes are recorded and replayed on
+ * different threads, access to the journal must be synchronized.
+ */
+@interface PROChangeJournal : NSObject
+
+/**
+ * @name Recording Changes
+ */
+
+/**
+ * The number of changes in the journal.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+/**
+ * The number of bytes used to store the changes in the journal, not including
+ * the objects they refer to.
+ */
+@property (nonatomic, readonly) NSUInteger encodedLength;
+
+/**
+ * Appends a change, decoded from a KVO change dictionary, to the journal.
+ *
+ * @param changes A change dictionary that was passed to
+ * `observeValueForKeyPath:ofObject:change:context:` or a <[PROKeyValueObserver
+ * block]>.
+ * @param keyPath The key path to which the change applies, relative to the
+ * object that the journal will be replayed onto.
+ */
+- (void)recordChangeDictionary:(NSDictionary *)changes forKeyPath:(NSString *)keyPath;
+
+/**
+ * Appends a change to the journal, without needing a change dictionary.
+ *
+ * @param kind The kind of change.
+ * @param keyPath The key path to which the change applies, relative to the
+ * object that the journal will be replayed onto.
+ * @param indexes The indexes affected by the change, or `nil` if the change is
+ * to an unordered collection.
+ * @param newValue The value for `NSKeyValueChangeNewKey`, or `nil` if there is
+ * none. The objects in a collection are retained by the journal individually,
+ * but the collection itself is not.
+ * @param oldValue The value for `NSKeyValueChangeOldKey`, or `nil` if there is
+ * none.
+ */
+- (void)recordChange:(NSKeyValueChange)kind forKeyPath:(NSString *)keyPath indexes:(NSIndexSet *)indexes newValue:(id)newValue oldValue:(id)oldValue;
+
+/**
+ * @name Replaying Changes
+ */
+
+/**
+ * Applies every change in the journal to `object`, in the same manner as
+ * `-[NSObject applyKeyValueChangeDictionary:toKeyPath:mappingNewObjectsUsingBlock:]`.
+ *
+ * Consecutive changes to the same key path are applied together, with
+ * `-[NSObject applyKeyValueChangeDictionaries:toKeyPath:mappingNewObjectsUsingBlock:]`.
+ *
+ * @param object The object to modify.
+ * @param block If not `nil`, this block will be invoked to transform new
+ * objects before they're added to the collections of `object`.
+ */
+- (void)replayOntoObject:(id)object mappingNewObjectsUsingBlock:(id (^)(id))block;
+
+/**
+ * Applies the changes in the journal after the given checkpoint to `object`.
+ *
+ * @param object The object to modify.
+ * @param checkpoint The number of changes at the beginning of the journal to
+ * skip. This must not be greater than <count>.
+ * @param block If not `nil`, this block will be invoked to transform new
+ * objects before they're added to the collections of `object`.
+ */
+- (void)replayOntoObject:(id)object fromCheckpoint:(NSUInteger)checkpoint mappingNewObjectsUsingBlock:(id (^)(id))block;
+
+/**
+ * @name Removing Changes
+ */
+
+/**
+ * Removes every change after the given checkpoint.
+ *
+ * @param checkpoint The number of changes to keep. This must not be greater
+ * than <count>.
+ */
+- (void)truncateToCheckpoint:(NSUInteger)checkpoint;
+
+/**
+ * Removes every change before the given checkpoint, such as those that have
+ * already been replayed.
+ *
+ * Afterward, the remaining changes are numbered from zero, so any checkpoints
+ * after this one should have `checkpoint` subtracted from them.
+ *
+ * @param checkpoint The number of changes to remove. This must not be greater
+ * than <count>.
+ */
+- (void)removeChangesBeforeCheckpoint:(NSUInteger)checkpoint;
+
+/**
+ * Removes every change from the journal.
+ */
+- (void)removeAllChanges;
+
+@end
@@ -0,0 +1,460 @@
+//
+//  PROChangeJournal.m
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import "PROChangeJournal.h"
+#import "NSObject+KeyValueCodingAdditions.h"
+#import "PROAssert.h"
+
+/*
+ * Describes how the new or old value of a change was stored.
+ */
+enum {
+    // there was no value
+    PROChangeJournalValueNone = 0,
+
+    // the objects of an NSArray
+    PROChangeJournalValueArray,
+
+    // the objects of an NSSet
+    PROChangeJournalValueSet,
+
+    // the objects of an NSOrderedSet
+    PROChangeJournalValueOrderedSet,
+
+    // NSNull, which KVO uses to represent nil
+    PROChangeJournalValueNull,
+
+    // any other single object
+    PROChangeJournalValueObject
+};
+
+/*
+ * The location of a single change in the journal.
+ */
+typedef struct {
+    /*
+     * The offset of the encoded change in the receiver's buffer.
+     */
+    NSUInteger offset;
+
+    /*
+     * The index of the first object referenced by the change in the receiver's
+     * object table.
+     */
+    NSUInteger objectIndex;
+} PROChangeJournalEntry;
+
+/*
+ * Decodes an unsigned LEB128 value from `*cursor`, and advances it past the
+ * encoded bytes.
+ */
+static NSUInteger readVarint(const uint8_t **cursor) {
+    NSUInteger value = 0;
+    unsigned shift = 0;
+    uint8_t byte;
+
+    do {
+        byte = *(*cursor)++;
+        value |= (NSUInteger)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    return value;
+}
+
+@interface PROChangeJournal () {
+    /*
+     * The encoded changes, each of which has the following form:
+     *
+     *  - one byte for the NSKeyValueChange kind
+     *  - one byte each for how the new and old values are stored
+     *  - the key path identifier, as a varint
+     *  - one more than the number of index ranges, as a varint, or zero if
+     *  the change has no indexes
+     *  - for each index range, its distance from the end of the previous range,
+     *  and its length, as varints
+     *  - the number of objects in the new and old values, as varints
+     *
+     * The objects themselves are stored, in the same order, in `m_objects`.
+     */
+    uint8_t *m_bytes;
+    NSUInteger m_length;
+    NSUInteger m_capacity;
+
+    /*
+     * The location of each change in the journal, of which there are <count>.
+     */
+    PROChangeJournalEntry *m_entries;
+    NSUInteger m_entryCapacity;
+}
+
+/*
+ * The objects referenced by every change, in order.
+ */
+@property (nonatomic, strong, readonly) NSMutableArray *objects;
+
+/*
+ * Every key path that has been recorded, indexed by identifier.
+ */
+@property (nonatomic, strong, readonly) NSMutableArray *keyPaths;
+
+/*
+ * `NSNumber` identifiers for each string in <keyPaths>.
+ */
+@property (nonatomic, strong, readonly) NSMutableDictionary *keyPathIdentifiers;
+
+/*
+ * Appends `value` to the buffer as an unsigned LEB128 value.
+ */
+- (void)appendVarint:(NSUInteger)value;
+
+/*
+ * Appends the objects in `value` to <objects>, returning how it should be
+ * decoded and setting `count` to the number of objects appended.
+ */
+- (uint8_t)appendObjectsInValue:(id)value count:(NSUInteger *)count;
+
+/*
+ * Returns a value of the given type, made from the objects at the given range
+ * of <objects>.
+ */
+- (id)valueWithType:(uint8_t)type objectsInRange:(NSRange)range;
+@end
+
+@implementation PROChangeJournal
+
+#pragma mark Properties
+
+@synthesize count = m_count;
+@synthesize encodedLength = m_length;
+@synthesize objects = m_objects;
+@synthesize keyPaths = m_keyPaths;
+@synthesize keyPathIdentifiers = m_keyPathIdentifiers;
+
+#pragma mark Lifecycle
+
+- (id)init; {
+    self = [super init];
+    if (!self)
+        return nil;
+
+    m_objects = [[NSMutableArray alloc] init];
+    m_keyPaths = [[NSMutableArray alloc] init];
+    m_keyPathIdentifiers = [[NSMutableDictionary alloc] init];
+
+    return self;
+}
+
+- (void)dealloc {
+    free(m_bytes);
+    free(m_entries);
+}
+
+#pragma mark Encoding
+
+- (BOOL)reserveLength:(NSUInteger)length; {
+    if (m_length + length <= m_capacity)
+        return YES;
+
+    NSUInteger capacity = MAX(m_capacity * 2, m_length + length);
+    capacity = MAX(capacity, 64);
+
+    uint8_t *bytes = realloc(m_bytes, capacity);
+    if (!PROAssert(bytes, @"Could not allocate space for %lu bytes", (unsigned long)capacity))
+        return NO;
+
+    m_bytes = bytes;
+    m_capacity = capacity;
+    return YES;
+}
+
+- (void)appendVarint:(NSUInteger)value; {
+    // enough for a 64-bit value
+    if (![self reserveLength:10])
+        return;
+
+    do {
+        uint8_t byte = (uint8_t)(value & 0x7F);
+        value >>= 7;
+
+        if (value)
+            byte |= 0x80;
+
+        m_bytes[m_length++] = byte;
+    } while (value);
+}
+
+- (uint8_t)appendObjectsInValue:(id)value count:(NSUInteger *)count; {
+    NSUInteger originalCount = self.objects.count;
+    uint8_t type;
+
+    if (!value) {
+        type = PROChangeJournalValueNone;
+    } else if ([value isEqual:[NSNull null]]) {
+        type = PROChangeJournalValueNull;
+    } else if ([value isKindOfClass:[NSArray class]]) {
+        type = PROChangeJournalValueArray;
+        [self.objects addObjectsFromArray:value];
+    } else if ([value isKindOfClass:[NSSet class]]) {
+        type = PROChangeJournalValueSet;
+        [self.objects addObjectsFromArray:[value allObjects]];
+    } else if ([value isKindOfClass:[NSOrderedSet class]]) {
+        type = PROChangeJournalValueOrderedSet;
+        [self.objects addObjectsFromArray:[value array]];
+    } else {
+        type = PROChangeJournalValueObject;
+        [self.objects addObject:value];
+    }
+
+    *count = self.objects.count - originalCount;
+    return type;
+}
+
+#pragma mark Recording Changes
+
+- (void)recordChangeDictionary:(NSDictionary *)changes forKeyPath:(NSString *)keyPath; {
+    NSParameterAssert(changes != nil);
+
+    NSKeyValueChange kind = [[changes objectForKey:NSKeyValueChangeKindKey] unsignedIntegerValue];
+    NSIndexSet *indexes = [changes objectForKey:NSKeyValueChangeIndexesKey];
+    id newValue = [changes objectForKey:NSKeyValueChangeNewKey];
+    id oldValue = [changes objectForKey:NSKeyValueChangeOldKey];
+
+    [self recordChange:kind forKeyPath:keyPath indexes:indexes newValue:newValue oldValue:oldValue];
+}
+
+- (void)recordChange:(NSKeyValueChange)kind forKeyPath:(NSString *)keyPath indexes:(NSIndexSet *)indexes newValue:(id)newValue oldValue:(id)oldValue; {
+    NSParameterAssert(keyPath != nil);
+
+    if (m_count == m_entryCapacity) {
+        NSUInteger capacity = MAX(m_entryCapacity * 2, 16);
+
+        PROChangeJournalEntry *entries = realloc(m_entries, capacity * sizeof(*entries));
+        if (!PROAssert(entries, @"Could not allocate space for %lu changes", (unsigned long)capacity))
+            return;
+
+        m_entries = entries;
+        m_entryCapacity = capacity;
+    }
+
+    NSNumber *keyPathIdentifier = [self.keyPathIdentifiers objectForKey:keyPath];
+    if (!keyPathIdentifier) {
+        keyPathIdentifier = [NSNumber numberWithUnsignedInteger:self.keyPaths.count];
+
+        keyPath = [keyPath copy];
+        [self.keyPaths addObject:keyPath];
+        [self.keyPathIdentifiers setObject:keyPathIdentifier forKey:keyPath];
+    }
+
+    PROChangeJournalEntry entry = {
+        .offset = m_length,
+        .objectIndex = self.objects.count
+    };
+
+    NSUInteger newCount = 0;
+    NSUInteger oldCount = 0;
+    uint8_t newType = [self appendObjectsInValue:newValue count:&newCount];
+    uint8_t oldType = [self appendObjectsInValue:oldValue count:&oldCount];
+
+    if (![self reserveLength:3])
+        return;
+
+    m_bytes[m_length++] = (uint8_t)kind;
+    m_bytes[m_length++] = newType;
+    m_bytes[m_length++] = oldType;
+
+    [self appendVarint:[keyPathIdentifier unsignedIntegerValue]];
+
+    if (indexes) {
+        __block NSUInteger rangeCount = 0;
+        [indexes enumerateRangesUsingBlock:^(NSRange range, BOOL *stop){
+            ++rangeCount;
+        }];
+
+        [self appendVarint:rangeCount + 1];
+
+        __block NSUInteger previousEnd = 0;
+        [indexes enumerateRangesUsingBlock:^(NSRange range, BOOL *stop){
+            [self appendVarint:range.location - previousEnd];
+            [self appendVarint:range.length];
+
+            previousEnd = NSMaxRange(range);
+        }];
+    } else {
+        [self appendVarint:0];
+    }
+
+    [self appendVarint:newCount];
+    [self appendVarint:oldCount];
+
+    m_entries[m_count++] = entry;
+}
+
+#pragma mark Replaying Changes
+
+- (id)valueWithType:(uint8_t)type objectsInRange:(NSRange)range; {
+    switch (type) {
+        case PROChangeJournalValueNone:
+            return nil;
+
+        case PROChangeJournalValueNull:
+            return [NSNull null];
+
+        case PROChangeJournalValueArray:
+            return [self.objects subarrayWithRange:range];
+
+        case PROChangeJournalValueSet:
+            return [NSSet setWithArray:[self.objects subarrayWithRange:range]];
+
+        case PROChangeJournalValueOrderedSet:
+            return [NSOrderedSet orderedSetWithArray:[self.objects subarrayWithRange:range]];
+
+        case PROChangeJournalValueObject:
+            return [self.objects objectAtIndex:range.location];
+
+        default:
+            PROAssert(NO, @"Unrecognized value type %i", (int)type);
+            return nil;
+    }
+}
+
+- (void)replayOntoObject:(id)object mappingNewObjectsUsingBlock:(id (^)(id))block; {
+    [self replayOntoObject:object fromCheckpoint:0 mappingNewObjectsUsingBlock:block];
+}
+
+- (void)replayOntoObject:(id)object fromCheckpoint:(NSUInteger)checkpoint mappingNewObjectsUsingBlock:(id (^)(id))block; {
+    NSParameterAssert(checkpoint <= m_count);
+
+    // consecutive changes to the same key path, which haven't been applied yet
+    NSMutableArray *pendingChanges = [[NSMutableArray alloc] init];
+    NSString *pendingKeyPath = nil;
+
+    for (NSUInteger i = checkpoint; i <= m_count; ++i) {
+        NSString *keyPath = nil;
+        NSDictionary *changes = nil;
+
+        if (i < m_count) {
+            PROChangeJournalEntry entry = m_entries[i];
+            const uint8_t *cursor = m_bytes + entry.offset;
+
+            NSKeyValueChange kind = *cursor++;
+            uint8_t newType = *cursor++;
+            uint8_t oldType = *cursor++;
+
+            keyPath = [self.keyPaths objectAtIndex:readVarint(&cursor)];
+
+            NSMutableIndexSet *indexes = nil;
+            NSUInteger rangeCount = readVarint(&cursor);
+
+            if (rangeCount) {
+                indexes = [[NSMutableIndexSet alloc] init];
+                NSUInteger previousEnd = 0;
+
+                for (NSUInteger rangeIndex = 1; rangeIndex < rangeCount; ++rangeIndex) {
+                    NSUInteger location = previousEnd + readVarint(&cursor);
+                    NSUInteger length = readVarint(&cursor);
+
+                    [indexes addIndexesInRange:NSMakeRange(location, length)];
+                    previousEnd = location + length;
+                }
+            }
+
+            NSUInteger newCount = readVarint(&cursor);
+            NSUInteger oldCount = readVarint(&cursor);
+
+            NSMutableDictionary *mutableChanges = [[NSMutableDictionary alloc] initWithCapacity:4];
+            [mutableChanges setObject:[NSNumber numberWithUnsignedInteger:kind] forKey:NSKeyValueChangeKindKey];
+
+            if (indexes)
+                [mutableChanges setObject:indexes forKey:NSKeyValueChangeIndexesKey];
+
+            id newValue = [self valueWithType:newType objectsInRange:NSMakeRange(entry.objectIndex, newCount)];
+            if (newValue)
+                [mutableChanges setObject:newValue forKey:NSKeyValueChangeNewKey];
+
+            id oldValue = [self valueWithType:oldType objectsInRange:NSMakeRange(entry.objectIndex + newCount, oldCount)];
+            if (oldValue)
+                [mutableChanges setObject:oldValue forKey:NSKeyValueChangeOldKey];
+
+            changes = mutableChanges;
+        }
+
+        if (pendingKeyPath && ![keyPath isEqualToString:pendingKeyPath]) {
+            if (pendingChanges.count == 1)
+                [object applyKeyValueChangeDictionary:[pendingChanges lastObject] toKeyPath:pendingKeyPath mappingNewObjectsUsingBlock:block];
+            else
+                [object applyKeyValueChangeDictionaries:pendingChanges toKeyPath:pendingKeyPath mappingNewObjectsUsingBlock:block];
+
+            [pendingChanges removeAllObjects];
+        }
+
+        if (changes)
+            [pendingChanges addObject:changes];
+
+        pendingKeyPath = keyPath;
+    }
+}
+
+#pragma mark Removing Changes
+
+- (void)truncateToCheckpoint:(NSUInteger)checkpoint; {
+    NSParameterAssert(checkpoint <= m_count);
+
+    if (checkpoint == m_count)
+        return;
+
+    PROChangeJournalEntry entry = m_entries[checkpoint];
+
+    [self.objects removeObjectsInRange:NSMakeRange(entry.objectIndex, self.objects.count - entry.objectIndex)];
+    m_length = entry.offset;
+    m_count = checkpoint;
+}
+
+- (void)removeChangesBeforeCheckpoint:(NSUInteger)checkpoint; {
+    NSParameterAssert(checkpoint <= m_count);
+
+    if (!checkpoint)
+        return;
+
+    if (checkpoint == m_count) {
+        [self removeAllChanges];
+        return;
+    }
+
+    PROChangeJournalEntry firstEntry = m_entries[checkpoint];
+
+    memmove(m_bytes, m_bytes + firstEntry.offset, m_length - firstEntry.offset);
+    m_length -= firstEntry.offset;
+
+    [self.objects removeObjectsInRange:NSMakeRange(0, firstEntry.objectIndex)];
+
+    m_count -= checkpoint;
+    memmove(m_entries, m_entries + checkpoint, m_count * sizeof(*m_entries));
+
+    for (NSUInteger i = 0; i < m_count; ++i) {
+        m_entries[i].offset -= firstEntry.offset;
+        m_entries[i].objectIndex -= firstEntry.objectIndex;
+    }
+}
+
+- (void)removeAllChanges; {
+    [self.objects removeAllObjects];
+    [self.keyPaths removeAllObjects];
+    [self.keyPathIdentifiers removeAllObjects];
+
+    m_length = 0;
+    m_count = 0;
+}
+
+#pragma mark NSObject overrides
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p>( count = %lu, encodedLength = %lu, objects = %lu )", [self class], (__bridge void *)self, (unsigned long)m_count, (unsigned long)m_length, (unsigned long)self.objects.count];
+}
+
+@end
@@ -0,0 +1,215 @@
+//
+//  PROConcurrentFunctions.h
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * An option which may be included in the `NSEnumerationOptions` passed to any
+ * method of the `HigherOrderAdditions` categories, to choose between serial and
+ * concurrent enumeration automatically.
+ *
+ * When this option is present, `NSEnumerationConcurrent` (and any explicit
+ * grain size) is ignored. Instead, the cost of each element is estimated from
+ * previous enumerations with the same block (in other words, from the same call
+ * site), and concurrent enumeration is only used when the total estimated cost
+ * is large enough to outweigh the overhead of dispatching chunks to other
+ * threads. The first time a call site is seen, only large collections are
+ * enumerated concurrently.
+ *
+ * Costs are measured from the real work of each enumeration, so blocks are
+ * never invoked more times than they otherwise would be.
+ */
+enum {
+    PROEnumerationAutomatic = (1UL << 16)
+};
+
+/**
+ * Tracks a single enumeration that was started with
+ * <PROBeginAutomaticEnumeration>.
+ *
+ * The fields of this structure are private.
+ */
+typedef struct {
+    const void *callSite;
+    NSUInteger count;
+    BOOL concurrent;
+    uint64_t startTime;
+} PROAutomaticEnumeration;
+
+/**
+ * Returns the number of contiguous chunks that `count` elements will be split
+ * into by <PROConcurrentEnumerateChunks>, given the same grain size.
+ *
+ * @param count The total number of elements to process.
+ * @param grainSize The maximum number of elements to process in each chunk. If
+ * zero, a grain size is chosen automatically based on `count` and the number
+ * of active processors.
+ */
+NSUInteger PROConcurrentChunkCount (NSUInteger count, NSUInteger grainSize);
+
+/**
+ * Splits the range `[0, count)` into contiguous chunks of at most `grainSize`
+ * elements, and invokes `block` once for each chunk, returning only when every
+ * chunk has been processed.
+ *
+ * The first chunk is processed on the calling thread, while the rest are
+ * dispatched to the concurrent global `SDQueue`. If there is only one chunk,
+ * no dispatching occurs at all.
+ *
+ * All memory writes performed by `block` are visible to the caller once this
+ * function returns.
+ *
+ * @param count The total number of elements to process.
+ * @param grainSize The maximum number of elements to process in each chunk. If
+ * zero, a grain size is chosen automatically based on `count` and the number
+ * of active processors.
+ * @param block A block to invoke for each chunk. The block is passed the index
+ * of the chunk (which will be less than the value returned from
+ * <PROConcurrentChunkCount>) and the range of elements it covers. This block
+ * may be invoked concurrently, and must be thread-safe.
+ */
+void PROConcurrentEnumerateChunks (NSUInteger count, NSUInteger grainSize, void (^block)(NSUInteger chunkIndex, NSRange range));
+
+/**
+ * Reduces the range `[0, count)` to a single value by processing contiguous
+ * chunks concurrently, and then combining the partial results of adjacent
+ * chunks in a balanced tree.
+ *
+ * Partial results are always combined in order (the result of a chunk is only
+ * ever combined with the result of the chunk immediately before or after it),
+ * so `combineBlock` need only be associative, not commutative.
+ *
+ * If `count` is zero, `identity` is returned without invoking either block.
+ *
+ * @param count The total number of elements to process.
+ * @param grainSize The maximum number of elements to process in each chunk. If
+ * zero, a grain size is chosen automatically based on `count` and the number
+ * of active processors.
+ * @param identity The value to return if `count` is zero.
+ * @param chunkBlock A block which reduces the given range of elements to
+ * a partial result. This block may be invoked concurrently, and must be
+ * thread-safe.
+ * @param combineBlock An associative block which combines two partial results.
+ * This block may be invoked concurrently, and must be thread-safe.
+ */
+id PROConcurrentReduce (NSUInteger count, NSUInteger grainSize, id identity, id (^chunkBlock)(NSRange range), id (^combineBlock)(id left, id right));
+
+/**
+ * Searches the range `[0, count)` for up to `maximumCount` indexes which pass
+ * the given test, stopping every chunk as soon as enough matches have been
+ * found.
+ *
+ * Each chunk checks a shared match count before testing every index, so once
+ * the search is satisfied, any remaining work is abandoned almost
+ * immediately.
+ *
+ * If there is only one chunk (for instance, if `grainSize` is at least
+ * `count`), indexes are tested in order, and the matches will be the lowest
+ * matching indexes. Otherwise, the matches may be any of the matching indexes.
+ *
+ * @param count The total number of indexes to search.
+ * @param grainSize The maximum number of indexes to search in each chunk. If
+ * zero, a grain size is chosen automatically based on `count` and the number
+ * of active processors.
+ * @param maximumCount The maximum number of matches to find.
+ * @param indexes A buffer with space for at least `maximumCount` indexes (or
+ * `count` indexes, if that is less), which will be filled in with the matching
+ * indexes in ascending order.
+ * @param predicate The test to apply to each index. This block may be invoked
+ * concurrently, and must be thread-safe.
+ */
+NSUInteger PROConcurrentSearch (NSUInteger count, NSUInteger grainSize, NSUInteger maximumCount, NSUInteger *indexes, BOOL (^predicate)(NSUInteger index));
+
+/**
+ * Performs a stream compaction over the range `[0, count)`, returning the total
+ * number of elements kept.
+ *
+ * This proceeds in three phases:
+ *
+ *  1. `countBlock` is invoked concurrently for each chunk, and returns the
+ *  number of elements in that chunk which should be kept.
+ *  2. An exclusive prefix sum over those counts determines the index in the
+ *  output at which each chunk should begin writing.
+ *  3. `scatterBlock` is invoked concurrently for each chunk, and should write
+ *  the kept elements of that chunk, in order, starting at the given output
+ *  index.
+ *
+ * Because every chunk writes to a distinct region of the output, no
+ * synchronization is necessary, and the total work is linear in `count`
+ * regardless of how many elements are dropped.
+ *
+ * @param count The total number of elements to process.
+ * @param grainSize The maximum number of elements to process in each chunk. If
+ * zero, a grain size is chosen automatically based on `count` and the number
+ * of active processors.
+ * @param countBlock A block which returns the number of elements to keep in the
+ * given range. This block may be invoked concurrently, and must be
+ * thread-safe.
+ * @param scatterBlock A block which writes the kept elements in the given range
+ * to the output, starting at `outputIndex`. For any range, this block must
+ * keep exactly the number of elements previously returned from `countBlock`.
+ * This block may be invoked concurrently, and must be thread-safe.
+ */
+NSUInteger PROConcurrentCompact (NSUInteger count, NSUInteger grainSize, NSUInteger (^countBlock)(NSRange range), void (^scatterBlock)(NSRange range, NSUInteger outputIndex));
+
+/**
+ * Compacts the results of multiple chunks within `buffer` so that they are
+ * contiguous, returning the total number of elements.
+ *
+ * This is meant to be used after <PROConcurrentEnumerateChunks>, when each
+ * chunk has written its results into the beginning of its own range of
+ * `buffer` (to avoid any synchronization between chunks). Elements are moved
+ * with `memmove`, so any ownership of objects in `buffer` is transferred to the
+ * new location, and the contents of `buffer` past the returned count should be
+ * considered garbage.
+ *
+ * @param buffer The buffer containing the results of every chunk.
+ * @param elementSize The size of each element in `buffer`.
+ * @param ranges The ranges of `buffer` which contain results, in the order in
+ * which they should be placed.
+ * @param chunkCount The number of ranges in `ranges`.
+ */
+NSUInteger PROConcurrentCompactChunks (void *buffer, size_t elementSize, const NSRange *ranges, NSUInteger chunkCount);
+
+/**
+ * Prepares to enumerate `count` elements using `block`, replacing
+ * <PROEnumerationAutomatic> in `opts` (if present) with a concrete choice of
+ * serial or concurrent enumeration.
+ *
+ * The returned value must be passed to <PROEndAutomaticEnumeration> once
+ * enumeration has finished, in order to record the cost of this call site for
+ * future enumerations. If `opts` did not include <PROEnumerationAutomatic>,
+ * it is left unchanged, and ending the enumeration does nothing.
+ *
+ * @param opts The options which will be used to enumerate. This will be
+ * updated in place.
+ * @param count The number of elements which will be enumerated.
+ * @param block The block which will be invoked for each element. Its code
+ * pointer is used to identify the call site.
+ */
+PROAutomaticEnumeration PROBeginAutomaticEnumeration (NSEnumerationOptions *opts, NSUInteger count, id block);
+
+/**
+ * Records the time taken by an enumeration started with
+ * <PROBeginAutomaticEnumeration>.
+ *
+ * @param enumeration The value returned from <PROBeginAutomaticEnumeration>.
+ */
+void PROEndAutomaticEnumeration (PROAutomaticEnumeration enumeration);
+
+/**
+ * Returns the estimated cost of invoking `block` (or any block created from the
+ * same block literal) once, as measured by automatic enumerations, or zero if
+ * no such enumeration has happened yet.
+ *
+ * This is mostly useful for diagnostics and testing.
+ *
+ * @param block A block that has been passed to a method of the
+ * `HigherOrderAdditions` categories along with <PROEnumerationAutomatic>.
+ */
+NSTimeInterval PROAutomaticEnumerationCostForBlock (id block);
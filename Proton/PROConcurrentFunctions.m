@@ -0,0 +1,407 @@
+//
+//  PROConcurrentFunctions.m
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import "PROConcurrentFunctions.h"
+#import "EXTScope.h"
+#import "PROAssert.h"
+#import "SDQueue.h"
+#import <libkern/OSAtomic.h>
+#import <mach/mach_time.h>
+#import <pthread.h>
+
+/*
+ * The number of chunks to create per active processor when choosing a grain
+ * size automatically. Using more than one chunk per processor helps balance the
+ * load when some elements are more expensive to process than others.
+ */
+#define PROTON_CHUNKS_PER_PROCESSOR 4
+
+/*
+ * The total estimated time, in nanoseconds, that an automatic enumeration must
+ * take before it will be performed concurrently. Below this, the overhead of
+ * dispatching chunks to other threads outweighs any speedup.
+ */
+#define PROTON_AUTOMATIC_CONCURRENCY_THRESHOLD 50000
+
+/*
+ * The number of elements above which an automatic enumeration from a call site
+ * with no measurements will be performed concurrently.
+ */
+#define PROTON_AUTOMATIC_UNMEASURED_COUNT 4096
+
+/*
+ * The weight given to the newest measurement when updating the estimated cost
+ * of a call site.
+ */
+#define PROTON_AUTOMATIC_SMOOTHING 0.25
+
+/**
+ * The in-memory layout of a block, up to the pointer to its code.
+ */
+struct PROBlockLiteral {
+    void *isa;
+    int flags;
+    int reserved;
+    void (*invoke)(void *, ...);
+};
+
+/**
+ * Measurements for a single call site, used by automatic enumeration.
+ */
+typedef struct {
+    /**
+     * The estimated time, in nanoseconds, to process a single element.
+     */
+    double nanosecondsPerElement;
+} PROCallSiteStatistics;
+
+/**
+ * A dictionary mapping call sites (the code pointers of blocks) to
+ * `PROCallSiteStatistics` structures.
+ *
+ * This should only be accessed while holding `PROCallSiteStatisticsLock`.
+ */
+static CFMutableDictionaryRef PROCallSiteStatisticsByCallSite;
+
+/**
+ * Synchronizes access to `PROCallSiteStatisticsByCallSite`.
+ *
+ * Every automatic enumeration reads the statistics for its call site, so
+ * readers share this lock, and only recording a measurement takes it
+ * exclusively.
+ */
+static pthread_rwlock_t PROCallSiteStatisticsLock = PTHREAD_RWLOCK_INITIALIZER;
+
+/**
+ * Returns `grainSize`, or an automatically chosen grain size if `grainSize` is
+ * zero.
+ */
+static NSUInteger resolvedGrainSize (NSUInteger count, NSUInteger grainSize) {
+    if (grainSize)
+        return grainSize;
+
+    NSUInteger maximumChunks = [[NSProcessInfo processInfo] activeProcessorCount] * PROTON_CHUNKS_PER_PROCESSOR;
+    if (!maximumChunks)
+        maximumChunks = 1;
+
+    return MAX((NSUInteger)1, (count + maximumChunks - 1) / maximumChunks);
+}
+
+/**
+ * Compares two `NSUInteger` values for `qsort()`.
+ */
+static int compareIndexes (const void *left, const void *right) {
+    NSUInteger leftIndex = *(const NSUInteger *)left;
+    NSUInteger rightIndex = *(const NSUInteger *)right;
+
+    if (leftIndex < rightIndex)
+        return -1;
+    else if (leftIndex > rightIndex)
+        return 1;
+    else
+        return 0;
+}
+
+/**
+ * Returns the call site identifying `block`, which is the pointer to its code.
+ */
+static const void *callSiteForBlock (id block) {
+    return ((__bridge struct PROBlockLiteral *)block)->invoke;
+}
+
+/**
+ * Returns the estimated time, in nanoseconds, to process a single element at
+ * the given call site, or zero if it has never been measured.
+ */
+static double measuredCost (const void *callSite) {
+    double nanosecondsPerElement = 0;
+
+    pthread_rwlock_rdlock(&PROCallSiteStatisticsLock);
+
+    if (PROCallSiteStatisticsByCallSite) {
+        const PROCallSiteStatistics *statistics = CFDictionaryGetValue(PROCallSiteStatisticsByCallSite, callSite);
+        if (statistics)
+            nanosecondsPerElement = statistics->nanosecondsPerElement;
+    }
+
+    pthread_rwlock_unlock(&PROCallSiteStatisticsLock);
+
+    return nanosecondsPerElement;
+}
+
+/**
+ * Converts a difference in `mach_absolute_time()` to nanoseconds.
+ */
+static double nanosecondsFromAbsoluteTime (uint64_t absoluteTime) {
+    static mach_timebase_info_data_t timebase;
+
+    if (!timebase.denom)
+        mach_timebase_info(&timebase);
+
+    return (double)absoluteTime * timebase.numer / timebase.denom;
+}
+
+NSUInteger PROConcurrentChunkCount (NSUInteger count, NSUInteger grainSize) {
+    grainSize = resolvedGrainSize(count, grainSize);
+    return (count + grainSize - 1) / grainSize;
+}
+
+void PROConcurrentEnumerateChunks (NSUInteger count, NSUInteger grainSize, void (^block)(NSUInteger chunkIndex, NSRange range)) {
+    NSCParameterAssert(block != nil);
+
+    grainSize = resolvedGrainSize(count, grainSize);
+
+    NSUInteger chunkCount = (count + grainSize - 1) / grainSize;
+    if (!chunkCount)
+        return;
+
+    if (chunkCount == 1) {
+        block(0, NSMakeRange(0, count));
+        return;
+    }
+
+    dispatch_group_t group = dispatch_group_create();
+    @onExit {
+        dispatch_release(group);
+    };
+
+    SDQueue *queue = [SDQueue concurrentGlobalQueue];
+
+    for (NSUInteger chunkIndex = 1; chunkIndex < chunkCount; ++chunkIndex) {
+        NSUInteger location = chunkIndex * grainSize;
+        NSRange range = NSMakeRange(location, MIN(grainSize, count - location));
+
+        dispatch_group_enter(group);
+        [queue runAsynchronously:^{
+            block(chunkIndex, range);
+            dispatch_group_leave(group);
+        }];
+    }
+
+    // do useful work on this thread instead of just waiting
+    block(0, NSMakeRange(0, grainSize));
+
+    // this also acts as a memory barrier for everything written by the chunks
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+}
+
+id PROConcurrentReduce (NSUInteger count, NSUInteger grainSize, id identity, id (^chunkBlock)(NSRange range), id (^combineBlock)(id left, id right)) {
+    NSCParameterAssert(chunkBlock != nil);
+    NSCParameterAssert(combineBlock != nil);
+
+    NSUInteger chunkCount = PROConcurrentChunkCount(count, grainSize);
+    if (!chunkCount)
+        return identity;
+
+    __strong id *partials = (__strong id *)calloc(chunkCount, sizeof(*partials));
+    if (!PROAssert(partials, @"Could not allocate space for %lu partial results", (unsigned long)chunkCount))
+        return nil;
+
+    @onExit {
+        // nil out everything in the array to make sure ARC releases
+        // everything appropriately
+        for (NSUInteger i = 0; i < chunkCount; ++i) {
+            partials[i] = nil;
+        }
+
+        free(partials);
+    };
+
+    PROConcurrentEnumerateChunks(count, grainSize, ^(NSUInteger chunkIndex, NSRange range){
+        partials[chunkIndex] = chunkBlock(range);
+    });
+
+    // combine adjacent pairs of partial results until only one remains, storing
+    // each combined result into the position of the left element
+    for (NSUInteger stride = 1; stride < chunkCount; stride *= 2) {
+        NSUInteger pairCount = (chunkCount + 2 * stride - 1) / (2 * stride);
+
+        PROConcurrentEnumerateChunks(pairCount, 1, ^(NSUInteger pairIndex, NSRange range){
+            NSUInteger leftIndex = pairIndex * 2 * stride;
+            NSUInteger rightIndex = leftIndex + stride;
+
+            // an unpaired result just moves up to the next level unchanged
+            if (rightIndex >= chunkCount)
+                return;
+
+            partials[leftIndex] = combineBlock(partials[leftIndex], partials[rightIndex]);
+        });
+    }
+
+    return partials[0];
+}
+
+NSUInteger PROConcurrentSearch (NSUInteger count, NSUInteger grainSize, NSUInteger maximumCount, NSUInteger *indexes, BOOL (^predicate)(NSUInteger index)) {
+    NSCParameterAssert(predicate != nil);
+    NSCParameterAssert(indexes != NULL || !maximumCount);
+
+    maximumCount = MIN(maximumCount, count);
+    if (!maximumCount)
+        return 0;
+
+    // the number of matches found so far, which may temporarily exceed
+    // 'maximumCount' when multiple chunks find a match at the same time
+    volatile int64_t matchCount = 0;
+    volatile int64_t *matchCountPtr = &matchCount;
+
+    PROConcurrentEnumerateChunks(count, grainSize, ^(NSUInteger chunkIndex, NSRange range){
+        for (NSUInteger index = range.location; index < NSMaxRange(range); ++index) {
+            // stop as soon as any chunk has found the last match
+            if (*matchCountPtr >= (int64_t)maximumCount)
+                return;
+
+            if (!predicate(index))
+                continue;
+
+            int64_t matchIndex = OSAtomicIncrement64Barrier(matchCountPtr) - 1;
+            if (matchIndex >= (int64_t)maximumCount)
+                return;
+
+            indexes[matchIndex] = index;
+        }
+    });
+
+    NSUInteger foundCount = MIN((NSUInteger)matchCount, maximumCount);
+
+    // chunks may have found their matches in any order
+    qsort(indexes, foundCount, sizeof(*indexes), &compareIndexes);
+
+    return foundCount;
+}
+
+NSUInteger PROConcurrentCompact (NSUInteger count, NSUInteger grainSize, NSUInteger (^countBlock)(NSRange range), void (^scatterBlock)(NSRange range, NSUInteger outputIndex)) {
+    NSCParameterAssert(countBlock != nil);
+    NSCParameterAssert(scatterBlock != nil);
+
+    NSUInteger chunkCount = PROConcurrentChunkCount(count, grainSize);
+    if (!chunkCount)
+        return 0;
+
+    NSUInteger *offsets = calloc(chunkCount, sizeof(*offsets));
+    if (!PROAssert(offsets, @"Could not allocate space for %lu chunk offsets", (unsigned long)chunkCount))
+        return 0;
+
+    @onExit {
+        free(offsets);
+    };
+
+    PROConcurrentEnumerateChunks(count, grainSize, ^(NSUInteger chunkIndex, NSRange range){
+        offsets[chunkIndex] = countBlock(range);
+    });
+
+    // convert the counts into starting indexes with an exclusive prefix sum
+    NSUInteger totalCount = 0;
+
+    for (NSUInteger chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex) {
+        NSUInteger chunkSize = offsets[chunkIndex];
+
+        offsets[chunkIndex] = totalCount;
+        totalCount += chunkSize;
+    }
+
+    PROConcurrentEnumerateChunks(count, grainSize, ^(NSUInteger chunkIndex, NSRange range){
+        scatterBlock(range, offsets[chunkIndex]);
+    });
+
+    return totalCount;
+}
+
+NSUInteger PROConcurrentCompactChunks (void *buffer, size_t elementSize, const NSRange *ranges, NSUInteger chunkCount) {
+    unsigned char *bytes = buffer;
+    NSUInteger totalCount = 0;
+
+    for (NSUInteger chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex) {
+        NSRange range = ranges[chunkIndex];
+
+        if (range.location != totalCount)
+            memmove(bytes + totalCount * elementSize, bytes + range.location * elementSize, range.length * elementSize);
+
+        totalCount += range.length;
+    }
+
+    return totalCount;
+}
+
+PROAutomaticEnumeration PROBeginAutomaticEnumeration (NSEnumerationOptions *opts, NSUInteger count, id block) {
+    NSCParameterAssert(opts != NULL);
+
+    PROAutomaticEnumeration enumeration = { .callSite = NULL };
+
+    if (!(*opts & PROEnumerationAutomatic))
+        return enumeration;
+
+    NSCParameterAssert(block != nil);
+
+    double nanosecondsPerElement = measuredCost(callSiteForBlock(block));
+
+    BOOL concurrent;
+    if (nanosecondsPerElement > 0)
+        concurrent = (count * nanosecondsPerElement >= PROTON_AUTOMATIC_CONCURRENCY_THRESHOLD);
+    else
+        concurrent = (count > PROTON_AUTOMATIC_UNMEASURED_COUNT);
+
+    // a single chunk can't be enumerated concurrently anyways
+    if (PROConcurrentChunkCount(count, 0) < 2)
+        concurrent = NO;
+
+    *opts &= ~(PROEnumerationAutomatic | NSEnumerationConcurrent);
+    if (concurrent)
+        *opts |= NSEnumerationConcurrent;
+
+    enumeration.callSite = callSiteForBlock(block);
+    enumeration.count = count;
+    enumeration.concurrent = concurrent;
+    enumeration.startTime = mach_absolute_time();
+
+    return enumeration;
+}
+
+void PROEndAutomaticEnumeration (PROAutomaticEnumeration enumeration) {
+    if (!enumeration.callSite || !enumeration.count)
+        return;
+
+    double elapsed = nanosecondsFromAbsoluteTime(mach_absolute_time() - enumeration.startTime);
+
+    // with concurrent enumeration, the elapsed time only reflects the work of
+    // one processor, so scale it up to estimate the total
+    if (enumeration.concurrent) {
+        NSUInteger parallelism = MIN([[NSProcessInfo processInfo] activeProcessorCount], PROConcurrentChunkCount(enumeration.count, 0));
+        elapsed *= MAX(parallelism, (NSUInteger)1);
+    }
+
+    double nanosecondsPerElement = elapsed / enumeration.count;
+
+    pthread_rwlock_wrlock(&PROCallSiteStatisticsLock);
+    @onExit {
+        pthread_rwlock_unlock(&PROCallSiteStatisticsLock);
+    };
+
+    if (!PROCallSiteStatisticsByCallSite)
+        PROCallSiteStatisticsByCallSite = CFDictionaryCreateMutable(NULL, 0, NULL, NULL);
+
+    PROCallSiteStatistics *statistics = (PROCallSiteStatistics *)CFDictionaryGetValue(PROCallSiteStatisticsByCallSite, enumeration.callSite);
+
+    if (!statistics) {
+        // statistics are kept for the lifetime of the process, since there are
+        // only as many of them as there are call sites
+        statistics = calloc(1, sizeof(*statistics));
+        if (!PROAssert(statistics, @"Could not allocate space for call site statistics"))
+            return;
+
+        statistics->nanosecondsPerElement = nanosecondsPerElement;
+        CFDictionarySetValue(PROCallSiteStatisticsByCallSite, enumeration.callSite, statistics);
+    } else {
+        statistics->nanosecondsPerElement += PROTON_AUTOMATIC_SMOOTHING * (nanosecondsPerElement - statistics->nanosecondsPerElement);
+    }
+}
+
+NSTimeInterval PROAutomaticEnumerationCostForBlock (id block) {
+    NSCParameterAssert(block != nil);
+
+    return measuredCost(callSiteForBlock(block)) / NSEC_PER_SEC;
+}
@@ -0,0 +1,166 @@
+//
+//  PROIndexPath.h
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * An immutable index path, optimized for recursive algorithms which repeatedly
+ * add or remove one index at either end of a path.
+ *
+ * Short paths are stored inline in the object, without any additional
+ * allocation. Longer paths are stored in a buffer which is shared between paths
+ * derived from one another, so that removing indexes from either end of a path
+ * (or taking any other subpath) never copies the indexes. Adding an index to
+ * either end of a path also avoids copying, as long as the shared buffer has
+ * room for it and the slot hasn't been taken by a different index.
+ *
+ * Use <indexes> with `-[NSArray objectAtIndexes:length:nodeKeyPath:]` to look
+ * up an object in a tree of arrays without converting to an `NSIndexPath`.
+ */
+@interface PROIndexPath : NSObject <NSCopying>
+
+/**
+ * @name Initialization
+ */
+
+/**
+ * Returns an empty index path.
+ */
++ (id)indexPath;
+
+/**
+ * Returns an index path containing a single index.
+ *
+ * @param index The index for the path.
+ */
++ (id)indexPathWithIndex:(NSUInteger)index;
+
+/**
+ * Returns an index path containing a copy of the given indexes.
+ *
+ * @param indexes The indexes for the path. This may be `NULL` if `length` is
+ * zero.
+ * @param length The number of indexes in `indexes`.
+ */
++ (id)indexPathWithIndexes:(const NSUInteger *)indexes length:(NSUInteger)length;
+
+/**
+ * Returns an index path containing the indexes of the given `NSIndexPath`.
+ *
+ * @param indexPath The index path to convert.
+ */
++ (id)indexPathWithIndexPath:(NSIndexPath *)indexPath;
+
+/**
+ * Initializes the receiver with a copy of the given indexes.
+ *
+ * This is the designated initializer.
+ *
+ * @param indexes The indexes for the path. This may be `NULL` if `length` is
+ * zero.
+ * @param length The number of indexes in `indexes`.
+ */
+- (id)initWithIndexes:(const NSUInteger *)indexes length:(NSUInteger)length;
+
+/**
+ * @name Accessing Indexes
+ */
+
+/**
+ * The number of indexes in the receiver.
+ */
+@property (nonatomic, readonly) NSUInteger length;
+
+/**
+ * The contiguous storage of the receiver, which contains <length> indexes.
+ *
+ * This pointer remains valid for the lifetime of the receiver. The indexes must
+ * not be modified.
+ */
+@property (nonatomic, readonly) const NSUInteger *indexes;
+
+/**
+ * Returns the index at the given position in the receiver.
+ *
+ * @param position The position of the index to return. This must be less than
+ * <length>.
+ */
+- (NSUInteger)indexAtPosition:(NSUInteger)position;
+
+/**
+ * Copies the indexes of the receiver into the given buffer, which must have
+ * room for <length> indexes.
+ *
+ * @param indexes A buffer to fill with the indexes of the receiver.
+ */
+- (void)getIndexes:(NSUInteger *)indexes;
+
+/**
+ * Returns an `NSIndexPath` containing the indexes of the receiver.
+ */
+- (NSIndexPath *)indexPath;
+
+/**
+ * @name Deriving Index Paths
+ */
+
+/**
+ * Returns an index path with the indexes of the receiver, followed by `index`.
+ *
+ * @param index The last index for the new path.
+ */
+- (PROIndexPath *)indexPathByAddingIndex:(NSUInteger)index;
+
+/**
+ * Returns an index path beginning with `index`, followed by the indexes of the
+ * receiver.
+ *
+ * @param index The first index for the new path.
+ */
+- (PROIndexPath *)indexPathByPrependingIndex:(NSUInteger)index;
+
+/**
+ * Returns an index path with the indexes of the receiver, excluding the first
+ * one.
+ *
+ * If the receiver has one index or less, this method returns an empty index
+ * path.
+ */
+- (PROIndexPath *)indexPathByRemovingFirstIndex;
+
+/**
+ * Returns an index path with the indexes of the receiver, excluding the last
+ * one.
+ *
+ * If the receiver has one index or less, this method returns an empty index
+ * path.
+ */
+- (PROIndexPath *)indexPathByRemovingLastIndex;
+
+/**
+ * Returns an index path containing the indexes of the receiver in the given
+ * range.
+ *
+ * @param range The range of positions to include. This range must not extend
+ * past the end of the receiver.
+ */
+- (PROIndexPath *)subpathWithRange:(NSRange)range;
+
+/**
+ * @name Comparing Index Paths
+ */
+
+/**
+ * Compares the receiver to another index path, in the same manner as
+ * `-[NSIndexPath compare:]`.
+ *
+ * @param indexPath The index path to compare to.
+ */
+- (NSComparisonResult)compare:(PROIndexPath *)indexPath;
+
+@end
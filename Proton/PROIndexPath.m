@@ -0,0 +1,373 @@
+//
+//  PROIndexPath.m
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import "PROIndexPath.h"
+#import "EXTScope.h"
+#import "PROAssert.h"
+#import <pthread.h>
+
+/**
+ * The number of indexes which can be stored inline in a <PROIndexPath>.
+ */
+#define PROIndexPathInlineCapacity 4
+
+/**
+ * A buffer of indexes shared between <PROIndexPath> objects.
+ *
+ * Only the slots between `m_start` and `m_end` have been written. Once a slot
+ * has been written, it never changes, so paths only need to take the lock when
+ * claiming new slots.
+ */
+@interface PROIndexPathStorage : NSObject {
+@public
+    NSUInteger *m_indexes;
+    NSUInteger m_capacity;
+
+    NSUInteger m_start;
+    NSUInteger m_end;
+
+    pthread_mutex_t m_lock;
+}
+
+/**
+ * Initializes a buffer containing a copy of the given indexes, with room to
+ * add as many indexes again to either end.
+ *
+ * @param indexes The indexes to copy.
+ * @param length The number of indexes in `indexes`.
+ */
+- (id)initWithIndexes:(const NSUInteger *)indexes length:(NSUInteger)length;
+
+/**
+ * Atomically writes `index` into the slot before `position`, if it is free, and
+ * returns whether the slot contains `index` afterward.
+ */
+- (BOOL)claimSlotBeforePosition:(NSUInteger)position forIndex:(NSUInteger)index;
+
+/**
+ * Atomically writes `index` into the slot at `position`, if it is free, and
+ * returns whether the slot contains `index` afterward.
+ */
+- (BOOL)claimSlotAtPosition:(NSUInteger)position forIndex:(NSUInteger)index;
+@end
+
+@interface PROIndexPath () {
+    /**
+     * The buffer containing the indexes of this path, or `nil` if they are
+     * stored in `m_inlineIndexes`.
+     */
+    PROIndexPathStorage *m_storage;
+
+    /**
+     * The position of the first index of this path in `m_storage`.
+     */
+    NSUInteger m_offset;
+
+    /**
+     * The indexes of this path, if `m_storage` is `nil`.
+     */
+    NSUInteger m_inlineIndexes[PROIndexPathInlineCapacity];
+}
+
+/**
+ * Initializes the receiver with a range of indexes from the given buffer.
+ *
+ * If the range is short enough to be stored inline, the indexes are copied
+ * instead of sharing `storage`.
+ */
+- (id)initWithStorage:(PROIndexPathStorage *)storage offset:(NSUInteger)offset length:(NSUInteger)length;
+@end
+
+@implementation PROIndexPath
+
+#pragma mark Properties
+
+@synthesize length = m_length;
+
+- (const NSUInteger *)indexes {
+    if (m_storage)
+        return m_storage->m_indexes + m_offset;
+    else
+        return m_inlineIndexes;
+}
+
+#pragma mark Lifecycle
+
++ (id)indexPath; {
+    return [[self alloc] initWithIndexes:NULL length:0];
+}
+
++ (id)indexPathWithIndex:(NSUInteger)index; {
+    return [[self alloc] initWithIndexes:&index length:1];
+}
+
++ (id)indexPathWithIndexes:(const NSUInteger *)indexes length:(NSUInteger)length; {
+    return [[self alloc] initWithIndexes:indexes length:length];
+}
+
++ (id)indexPathWithIndexPath:(NSIndexPath *)indexPath; {
+    NSParameterAssert(indexPath != nil);
+
+    NSUInteger length = indexPath.length;
+
+    NSUInteger indexes[length + 1];
+    [indexPath getIndexes:indexes];
+
+    return [[self alloc] initWithIndexes:indexes length:length];
+}
+
+- (id)init; {
+    return [self initWithIndexes:NULL length:0];
+}
+
+- (id)initWithIndexes:(const NSUInteger *)indexes length:(NSUInteger)length; {
+    NSParameterAssert(indexes != NULL || !length);
+
+    self = [super init];
+    if (!self)
+        return nil;
+
+    if (length > PROIndexPathInlineCapacity) {
+        m_storage = [[PROIndexPathStorage alloc] initWithIndexes:indexes length:length];
+        if (!m_storage)
+            return nil;
+
+        m_offset = m_storage->m_start;
+    } else if (length) {
+        memcpy(m_inlineIndexes, indexes, length * sizeof(*indexes));
+    }
+
+    m_length = length;
+    return self;
+}
+
+- (id)initWithStorage:(PROIndexPathStorage *)storage offset:(NSUInteger)offset length:(NSUInteger)length; {
+    if (length <= PROIndexPathInlineCapacity)
+        return [self initWithIndexes:storage->m_indexes + offset length:length];
+
+    self = [super init];
+    if (!self)
+        return nil;
+
+    m_storage = storage;
+    m_offset = offset;
+    m_length = length;
+
+    return self;
+}
+
+#pragma mark Accessing Indexes
+
+- (NSUInteger)indexAtPosition:(NSUInteger)position; {
+    NSParameterAssert(position < m_length);
+
+    return self.indexes[position];
+}
+
+- (void)getIndexes:(NSUInteger *)indexes; {
+    NSParameterAssert(indexes != NULL || !m_length);
+
+    if (m_length)
+        memcpy(indexes, self.indexes, m_length * sizeof(*indexes));
+}
+
+- (NSIndexPath *)indexPath; {
+    return [NSIndexPath indexPathWithIndexes:(NSUInteger *)self.indexes length:m_length];
+}
+
+#pragma mark Deriving Index Paths
+
+- (PROIndexPath *)indexPathByAddingIndex:(NSUInteger)index; {
+    NSUInteger length = m_length + 1;
+
+    if (m_storage && [m_storage claimSlotAtPosition:m_offset + m_length forIndex:index])
+        return [[PROIndexPath alloc] initWithStorage:m_storage offset:m_offset length:length];
+
+    NSUInteger indexes[length];
+    [self getIndexes:indexes];
+    indexes[m_length] = index;
+
+    return [[PROIndexPath alloc] initWithIndexes:indexes length:length];
+}
+
+- (PROIndexPath *)indexPathByPrependingIndex:(NSUInteger)index; {
+    NSUInteger length = m_length + 1;
+
+    if (m_storage && [m_storage claimSlotBeforePosition:m_offset forIndex:index])
+        return [[PROIndexPath alloc] initWithStorage:m_storage offset:m_offset - 1 length:length];
+
+    NSUInteger indexes[length];
+    [self getIndexes:indexes + 1];
+    indexes[0] = index;
+
+    return [[PROIndexPath alloc] initWithIndexes:indexes length:length];
+}
+
+- (PROIndexPath *)indexPathByRemovingFirstIndex; {
+    if (m_length <= 1)
+        return [PROIndexPath indexPath];
+
+    return [self subpathWithRange:NSMakeRange(1, m_length - 1)];
+}
+
+- (PROIndexPath *)indexPathByRemovingLastIndex; {
+    if (m_length <= 1)
+        return [PROIndexPath indexPath];
+
+    return [self subpathWithRange:NSMakeRange(0, m_length - 1)];
+}
+
+- (PROIndexPath *)subpathWithRange:(NSRange)range; {
+    NSParameterAssert(NSMaxRange(range) <= m_length);
+
+    if (range.location == 0 && range.length == m_length)
+        return self;
+
+    if (m_storage)
+        return [[PROIndexPath alloc] initWithStorage:m_storage offset:m_offset + range.location length:range.length];
+    else
+        return [[PROIndexPath alloc] initWithIndexes:m_inlineIndexes + range.location length:range.length];
+}
+
+#pragma mark Comparing Index Paths
+
+- (NSComparisonResult)compare:(PROIndexPath *)indexPath; {
+    NSParameterAssert(indexPath != nil);
+
+    const NSUInteger *indexes = self.indexes;
+    const NSUInteger *otherIndexes = indexPath.indexes;
+
+    NSUInteger otherLength = indexPath.length;
+    NSUInteger commonLength = MIN(m_length, otherLength);
+
+    for (NSUInteger i = 0; i < commonLength; ++i) {
+        if (indexes[i] < otherIndexes[i])
+            return NSOrderedAscending;
+        else if (indexes[i] > otherIndexes[i])
+            return NSOrderedDescending;
+    }
+
+    if (m_length < otherLength)
+        return NSOrderedAscending;
+    else if (m_length > otherLength)
+        return NSOrderedDescending;
+    else
+        return NSOrderedSame;
+}
+
+#pragma mark NSCopying
+
+- (id)copyWithZone:(NSZone *)zone {
+    // index paths are immutable
+    return self;
+}
+
+#pragma mark NSObject overrides
+
+- (NSUInteger)hash {
+    const NSUInteger *indexes = self.indexes;
+    NSUInteger hash = m_length;
+
+    for (NSUInteger i = 0; i < m_length; ++i) {
+        hash = hash * 31 + indexes[i];
+    }
+
+    return hash;
+}
+
+- (BOOL)isEqual:(PROIndexPath *)indexPath {
+    if (self == indexPath)
+        return YES;
+
+    if (![indexPath isKindOfClass:[PROIndexPath class]])
+        return NO;
+
+    if (indexPath.length != m_length)
+        return NO;
+
+    return !m_length || memcmp(self.indexes, indexPath.indexes, m_length * sizeof(NSUInteger)) == 0;
+}
+
+- (NSString *)description {
+    NSMutableArray *indexStrings = [NSMutableArray arrayWithCapacity:m_length];
+
+    const NSUInteger *indexes = self.indexes;
+    for (NSUInteger i = 0; i < m_length; ++i) {
+        [indexStrings addObject:[NSString stringWithFormat:@"%lu", (unsigned long)indexes[i]]];
+    }
+
+    return [NSString stringWithFormat:@"<%@: %p>( %@ )", [self class], (__bridge void *)self, [indexStrings componentsJoinedByString:@"."]];
+}
+
+@end
+
+@implementation PROIndexPathStorage
+
+- (id)initWithIndexes:(const NSUInteger *)indexes length:(NSUInteger)length; {
+    self = [super init];
+    if (!self)
+        return nil;
+
+    pthread_mutex_init(&m_lock, NULL);
+
+    // leave as much room on either side as the path itself, so that a series
+    // of additions or removals at one end doesn't immediately need a new buffer
+    m_capacity = length * 3;
+    m_indexes = malloc(m_capacity * sizeof(*m_indexes));
+    if (!PROAssert(m_indexes, @"Could not allocate space for %lu indexes", (unsigned long)m_capacity))
+        return nil;
+
+    m_start = length;
+    m_end = length * 2;
+
+    memcpy(m_indexes + m_start, indexes, length * sizeof(*indexes));
+    return self;
+}
+
+- (void)dealloc {
+    free(m_indexes);
+    pthread_mutex_destroy(&m_lock);
+}
+
+- (BOOL)claimSlotBeforePosition:(NSUInteger)position forIndex:(NSUInteger)index; {
+    if (!position)
+        return NO;
+
+    pthread_mutex_lock(&m_lock);
+    @onExit {
+        pthread_mutex_unlock(&m_lock);
+    };
+
+    if (m_start == position) {
+        m_indexes[--m_start] = index;
+        return YES;
+    }
+
+    // the slot has already been written, but another path may have used the
+    // same index
+    return m_start < position && m_indexes[position - 1] == index;
+}
+
+- (BOOL)claimSlotAtPosition:(NSUInteger)position forIndex:(NSUInteger)index; {
+    if (position >= m_capacity)
+        return NO;
+
+    pthread_mutex_lock(&m_lock);
+    @onExit {
+        pthread_mutex_unlock(&m_lock);
+    };
+
+    if (m_end == position) {
+        m_indexes[m_end++] = index;
+        return YES;
+    }
+
+    return m_end > position && m_indexes[position] == index;
+}
+
+@end
@@ -0,0 +1,108 @@
+//
+//  PROKeyPath.h
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * An immutable key path which has been split into its components ahead of
+ * time, for repeatedly reading or writing the same key path on many objects.
+ *
+ * `-valueForKeyPath:` and `-setValue:forKeyPath:` parse the key path string
+ * and search for accessor methods on every call. A `PROKeyPath` parses its
+ * string once, and remembers the getter and setter implementations found for
+ * each component on the most recently seen class, invoking them directly
+ * whenever the same class is seen again.
+ *
+ * Key-value coding is still used for any component that this class cannot
+ * safely shortcut, including:
+ *
+ *  - Collection operators (for example, `@count`), which cause the whole key
+ *  path to be evaluated with key-value coding.
+ *  - Properties with non-object types, which require boxing and unboxing.
+ *  - Objects which override `-valueForKey:` or `-setValue:forKey:`, like
+ *  `NSDictionary` and `NSArray`.
+ *  - Properties without a simple `<key>` getter or `set<Key>:` setter.
+ *
+ * Setter implementations are looked up on the receiver's actual class, so
+ * objects that are being observed with KVO will still post change
+ * notifications.
+ */
+@interface PROKeyPath : NSObject <NSCopying>
+
+/**
+ * @name Initialization
+ */
+
+/**
+ * Returns a key path compiled from the given string.
+ *
+ * Compiled key paths are cached, so repeatedly calling this method with equal
+ * strings will usually return the same object.
+ *
+ * @param string The key path to compile. This must not be empty.
+ */
++ (id)keyPathWithString:(NSString *)string;
+
+/**
+ * Initializes the receiver with the components of the given string.
+ *
+ * This is the designated initializer.
+ *
+ * @param string The key path to compile. This must not be empty.
+ */
+- (id)initWithString:(NSString *)string;
+
+/**
+ * @name Key Path Information
+ */
+
+/**
+ * The key path string that the receiver was compiled from.
+ */
+@property (nonatomic, copy, readonly) NSString *string;
+
+/**
+ * The keys which make up the receiver, in the order that they are followed.
+ */
+@property (nonatomic, copy, readonly) NSArray *components;
+
+/**
+ * Returns a key path which follows the receiver, then `key`.
+ *
+ * This is the compiled equivalent of
+ * `-[NSString stringByAppendingKeyPathComponent:]`.
+ *
+ * @param key The key or key path to append to the receiver. This must not be
+ * empty.
+ */
+- (PROKeyPath *)keyPathByAppendingKeyPathComponent:(NSString *)key;
+
+/**
+ * @name Getting and Setting Values
+ */
+
+/**
+ * Returns the value of the receiver on `object`, in the same manner as
+ * `-[object valueForKeyPath:]`.
+ *
+ * @param object The object from which to read the value. If this is `nil`,
+ * `nil` is returned.
+ */
+- (id)valueForObject:(id)object;
+
+/**
+ * Sets the receiver on `object` to `value`, in the same manner as `-[object
+ * setValue:value forKeyPath:]`.
+ *
+ * @param value The value to set.
+ * @param object The object to modify. If this is `nil`, or any intermediate
+ * key resolves to `nil`, nothing happens.
+ */
+- (void)setValue:(id)value forObject:(id)object;
+
+@end
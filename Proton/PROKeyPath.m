@@ -0,0 +1,384 @@
+//
+//  PROKeyPath.m
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import "PROKeyPath.h"
+#import "NSString+KeyPathAdditions.h"
+#import "PROAssert.h"
+#import <libkern/OSAtomic.h>
+#import <objc/runtime.h>
+
+/*
+ * The implementations of `-valueForKey:` and `-setValue:forKey:` inherited from
+ * `NSObject`. Classes which use anything else get key-value coding.
+ */
+static IMP PROKeyValueCodingGetterIMP;
+static IMP PROKeyValueCodingSetterIMP;
+
+/*
+ * Returns whether the first argument or return type encoded in `type` is an
+ * object.
+ */
+static BOOL isObjectType(const char *type) {
+    return (type[0] == _C_ID);
+}
+
+/**
+ * The getter and setter implementations to use for one class, or `NULL` if
+ * key-value coding must be used for that operation.
+ */
+typedef struct PROKeyPathAccessors {
+    __unsafe_unretained Class cls;
+    IMP getterIMP;
+    IMP setterIMP;
+
+    /**
+     * The entry that was published before this one, if any.
+     */
+    struct PROKeyPathAccessors *next;
+} PROKeyPathAccessors;
+
+/**
+ * A single key of a <PROKeyPath>, which caches the accessors of each class it
+ * has been used with.
+ */
+@interface PROKeyPathComponent : NSObject {
+    /**
+     * The selectors for the `<key>` getter and `set<Key>:` setter.
+     */
+    SEL m_getterSelector;
+    SEL m_setterSelector;
+
+    /**
+     * The selector for a `get<Key>` getter, which key-value coding would use
+     * in preference to `<key>`.
+     */
+    SEL m_prefixedGetterSelector;
+
+    /**
+     * A linked list of the accessors found for every class seen so far.
+     *
+     * Entries are immutable once published, and are only freed when the
+     * receiver is deallocated, so they can be read without a lock.
+     */
+    PROKeyPathAccessors * volatile m_accessors;
+
+    /**
+     * The entry in `m_accessors` which was most recently used.
+     */
+    PROKeyPathAccessors * volatile m_lastAccessors;
+}
+
+/**
+ * The key that the receiver reads and writes.
+ */
+@property (nonatomic, copy, readonly) NSString *key;
+
+/**
+ * Initializes the receiver to access the given key.
+ */
+- (id)initWithKey:(NSString *)key;
+
+/**
+ * Returns the value for <key> on `object`, which must not be `nil`.
+ */
+- (id)valueForObject:(id)object;
+
+/**
+ * Sets <key> on `object`, which must not be `nil`, to `value`.
+ */
+- (void)setValue:(id)value forObject:(id)object;
+@end
+
+@interface PROKeyPath () {
+    /**
+     * Whether the string contains a collection operator, in which case the
+     * whole key path is passed to key-value coding.
+     */
+    BOOL m_usesKeyValueCoding;
+}
+
+/**
+ * A <PROKeyPathComponent> for each of the <components>.
+ */
+@property (nonatomic, copy, readonly) NSArray *compiledComponents;
+@end
+
+@implementation PROKeyPath
+
+#pragma mark Properties
+
+@synthesize string = m_string;
+@synthesize components = m_components;
+@synthesize compiledComponents = m_compiledComponents;
+
+#pragma mark Lifecycle
+
++ (id)keyPathWithString:(NSString *)string; {
+    NSParameterAssert(string.length);
+
+    static NSCache *cache = nil;
+    static dispatch_once_t onceToken;
+
+    dispatch_once(&onceToken, ^{
+        cache = [[NSCache alloc] init];
+        cache.name = @"com.bitswift.Proton.PROKeyPath";
+    });
+
+    PROKeyPath *keyPath = [cache objectForKey:string];
+    if (!keyPath) {
+        keyPath = [[self alloc] initWithString:string];
+        [cache setObject:keyPath forKey:keyPath.string];
+    }
+
+    return keyPath;
+}
+
+- (id)init; {
+    NSAssert(NO, @"Use -initWithString: to initialize instances of %@", [self class]);
+    return nil;
+}
+
+- (id)initWithString:(NSString *)string; {
+    NSParameterAssert(string.length);
+
+    self = [super init];
+    if (!self)
+        return nil;
+
+    m_string = [string copy];
+    m_components = [m_string componentsSeparatedByString:@"."];
+    m_usesKeyValueCoding = ([m_string rangeOfString:@"@"].location != NSNotFound);
+
+    NSMutableArray *compiledComponents = [[NSMutableArray alloc] initWithCapacity:m_components.count];
+    for (NSString *key in m_components) {
+        [compiledComponents addObject:[[PROKeyPathComponent alloc] initWithKey:key]];
+    }
+
+    m_compiledComponents = [compiledComponents copy];
+    return self;
+}
+
+#pragma mark Key Paths
+
+- (PROKeyPath *)keyPathByAppendingKeyPathComponent:(NSString *)key; {
+    return [PROKeyPath keyPathWithString:[self.string stringByAppendingKeyPathComponent:key]];
+}
+
+#pragma mark Getting and Setting Values
+
+- (id)valueForObject:(id)object; {
+    if (m_usesKeyValueCoding)
+        return [object valueForKeyPath:m_string];
+
+    for (PROKeyPathComponent *component in m_compiledComponents) {
+        if (!object)
+            return nil;
+
+        object = [component valueForObject:object];
+    }
+
+    return object;
+}
+
+- (void)setValue:(id)value forObject:(id)object; {
+    if (m_usesKeyValueCoding) {
+        [object setValue:value forKeyPath:m_string];
+        return;
+    }
+
+    NSUInteger count = m_compiledComponents.count;
+
+    for (NSUInteger i = 0; i < count; ++i) {
+        if (!object)
+            return;
+
+        PROKeyPathComponent *component = [m_compiledComponents objectAtIndex:i];
+
+        if (i + 1 < count)
+            object = [component valueForObject:object];
+        else
+            [component setValue:value forObject:object];
+    }
+}
+
+#pragma mark NSCopying
+
+- (id)copyWithZone:(NSZone *)zone {
+    // key paths are immutable
+    return self;
+}
+
+#pragma mark NSObject overrides
+
+- (NSUInteger)hash {
+    return [m_string hash];
+}
+
+- (BOOL)isEqual:(PROKeyPath *)keyPath {
+    if (self == keyPath)
+        return YES;
+
+    if (![keyPath isKindOfClass:[PROKeyPath class]])
+        return NO;
+
+    return [m_string isEqualToString:keyPath.string];
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p>( %@ )", [self class], (__bridge void *)self, m_string];
+}
+
+@end
+
+@implementation PROKeyPathComponent
+
+#pragma mark Properties
+
+@synthesize key = m_key;
+
+#pragma mark Lifecycle
+
++ (void)initialize {
+    if (self != [PROKeyPathComponent class])
+        return;
+
+    PROKeyValueCodingGetterIMP = class_getMethodImplementation([NSObject class], @selector(valueForKey:));
+    PROKeyValueCodingSetterIMP = class_getMethodImplementation([NSObject class], @selector(setValue:forKey:));
+}
+
+- (id)initWithKey:(NSString *)key; {
+    NSParameterAssert(key.length);
+
+    self = [super init];
+    if (!self)
+        return nil;
+
+    m_key = [key copy];
+
+    NSString *capitalizedKey = [[[key substringToIndex:1] uppercaseString] stringByAppendingString:[key substringFromIndex:1]];
+
+    m_getterSelector = NSSelectorFromString(key);
+    m_setterSelector = NSSelectorFromString([NSString stringWithFormat:@"set%@:", capitalizedKey]);
+    m_prefixedGetterSelector = NSSelectorFromString([@"get" stringByAppendingString:capitalizedKey]);
+
+    return self;
+}
+
+- (void)dealloc {
+    PROKeyPathAccessors *accessors = m_accessors;
+
+    while (accessors) {
+        PROKeyPathAccessors *next = accessors->next;
+        free(accessors);
+
+        accessors = next;
+    }
+}
+
+#pragma mark Accessor Lookup
+
+/**
+ * Returns the cached getter or setter for `aClass`, looking up and publishing
+ * both if `aClass` has not been seen before.
+ */
+- (IMP)implementationForClass:(Class)aClass setter:(BOOL)setter; {
+    PROKeyPathAccessors *accessors = m_lastAccessors;
+
+    if (!accessors || accessors->cls != aClass) {
+        accessors = m_accessors;
+
+        while (accessors && accessors->cls != aClass) {
+            accessors = accessors->next;
+        }
+
+        if (!accessors) {
+            accessors = [self publishAccessorsForClass:aClass];
+
+            // fall back to key-value coding
+            if (!accessors)
+                return NULL;
+        }
+
+        m_lastAccessors = accessors;
+    }
+
+    return (setter ? accessors->setterIMP : accessors->getterIMP);
+}
+
+/**
+ * Looks up the accessors for `aClass`, and adds them to the front of
+ * `m_accessors`. Returns `NULL` if memory could not be allocated.
+ */
+- (PROKeyPathAccessors *)publishAccessorsForClass:(Class)aClass; {
+    PROKeyPathAccessors *accessors = malloc(sizeof(*accessors));
+    if (!PROAssert(accessors, @"Could not allocate space for accessors of %@", aClass))
+        return NULL;
+
+    accessors->cls = aClass;
+    accessors->getterIMP = NULL;
+    accessors->setterIMP = NULL;
+
+    char type[16];
+
+    // key-value coding prefers -get<Key> over -<key>, so don't bypass it if
+    // both are present
+    if (class_getMethodImplementation(aClass, @selector(valueForKey:)) == PROKeyValueCodingGetterIMP && !class_getInstanceMethod(aClass, m_prefixedGetterSelector)) {
+        Method getter = class_getInstanceMethod(aClass, m_getterSelector);
+
+        if (getter && method_getNumberOfArguments(getter) == 2) {
+            method_getReturnType(getter, type, sizeof(type));
+
+            if (isObjectType(type))
+                accessors->getterIMP = method_getImplementation(getter);
+        }
+    }
+
+    if (class_getMethodImplementation(aClass, @selector(setValue:forKey:)) == PROKeyValueCodingSetterIMP) {
+        Method setter = class_getInstanceMethod(aClass, m_setterSelector);
+
+        if (setter && method_getNumberOfArguments(setter) == 3) {
+            method_getArgumentType(setter, 2, type, sizeof(type));
+
+            if (isObjectType(type))
+                accessors->setterIMP = method_getImplementation(setter);
+        }
+    }
+
+    // the barrier makes the fields above visible before the entry itself;
+    // if another thread published first, the same class may appear twice,
+    // which is harmless
+    do {
+        accessors->next = m_accessors;
+    } while (!OSAtomicCompareAndSwapPtrBarrier(accessors->next, accessors, (void * volatile *)&m_accessors));
+
+    return accessors;
+}
+
+#pragma mark Getting and Setting Values
+
+- (id)valueForObject:(id)object; {
+    // use the actual class, instead of -class, so that KVO subclasses are
+    // looked up separately
+    IMP getter = [self implementationForClass:object_getClass(object) setter:NO];
+    if (!getter)
+        return [object valueForKey:m_key];
+
+    return ((id (*)(id, SEL))getter)(object, m_getterSelector);
+}
+
+- (void)setValue:(id)value forObject:(id)object; {
+    IMP setter = [self implementationForClass:object_getClass(object) setter:YES];
+    if (!setter) {
+        [object setValue:value forKey:m_key];
+        return;
+    }
+
+    ((void (*)(id, SEL, id))setter)(object, m_setterSelector, value);
+}
+
+@end
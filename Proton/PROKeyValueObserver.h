@@ -19,6 +19,14 @@
  */
 typedef void (^PROKeyValueObserverBlock)(NSDictionary *);
 
+/**
+ * In a change dictionary passed to a <PROKeyValueObserver> that
+ * <[PROKeyValueObserver coalescesChanges]>, this key is associated with an
+ * `NSArray` of every change dictionary that was coalesced into it, in the order
+ * they were received.
+ */
+extern NSString * const PROKeyValueObserverCoalescedChangesKey;
+
 /**
  * Implements support for key-value observation using blocks.
  */
@@ -119,4 +127,42 @@ typedef void (^PROKeyValueObserverBlock)(NSDictionary *);
  * occurring as part of a KVO callback.
  */
 @property (getter = isExecuting, readonly) BOOL executing;
+
+/**
+ * @name Coalescing Changes
+ */
+
+/**
+ * Whether changes which occur off of the <queue> should be merged together,
+ * instead of dispatching <block> once for each.
+ *
+ * When this is `YES`, changes which arrive before <block> has been dispatched
+ * are queued up, and <block> is invoked once with a single change dictionary,
+ * which is the last change received, with these differences:
+ *
+ *  - If every change was an `NSKeyValueChangeSetting`, the
+ *  `NSKeyValueChangeOldKey` is taken from the first change, so it describes the
+ *  value before any of the coalesced changes.
+ *  - The <PROKeyValueObserverCoalescedChangesKey> is set to an array of every
+ *  change received. Observers of to-many properties can pass this array to
+ *  `-[NSObject applyKeyValueChangeDictionaries:toKeyPath:mappingNewObjectsUsingBlock:]`.
+ *
+ * If a change occurs on the <queue> while others are pending, all of them are
+ * delivered immediately, so that changes are never reordered.
+ *
+ * This property defaults to `NO`.
+ */
+@property (assign) BOOL coalescesChanges;
+
+/**
+ * If <coalescesChanges> is `YES`, the number of seconds to wait after the first
+ * of a group of changes before delivering them.
+ *
+ * When this is zero, changes are delivered on the next turn of the <queue>,
+ * after any blocks which had already been enqueued. A larger value merges more
+ * changes into each invocation of <block>, at the cost of latency.
+ *
+ * This property defaults to zero.
+ */
+@property (assign) NSTimeInterval coalescingInterval;
 @end
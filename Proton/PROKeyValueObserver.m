@@ -9,6 +9,9 @@
 #import "PROKeyValueObserver.h"
 #import "EXTScope.h"
 #import "SDQueue.h"
+#import <pthread.h>
+
+NSString * const PROKeyValueObserverCoalescedChangesKey = @"PROKeyValueObserverCoalescedChanges";
 
 /*
  * A unique context pointer for our class, so that we can uniquely identify
@@ -16,8 +19,66 @@
  */
 static void * const PROKeyValueObserverContext = "PROKeyValueObserverContext";
 
-@interface PROKeyValueObserver ()
+/*
+ * Merges the given change dictionaries, in the order they were received, into
+ * a single dictionary, as described by <[PROKeyValueObserver
+ * coalescesChanges]>.
+ */
+static NSDictionary *coalescedChangeDictionary(NSArray *changeDictionaries) {
+    NSMutableDictionary *changes = [[changeDictionaries lastObject] mutableCopy];
+
+    BOOL onlySetting = YES;
+    for (NSDictionary *change in changeDictionaries) {
+        if ([[change objectForKey:NSKeyValueChangeKindKey] unsignedIntegerValue] != NSKeyValueChangeSetting) {
+            onlySetting = NO;
+            break;
+        }
+    }
+
+    if (onlySetting) {
+        id oldValue = [[changeDictionaries objectAtIndex:0] objectForKey:NSKeyValueChangeOldKey];
+
+        if (oldValue)
+            [changes setObject:oldValue forKey:NSKeyValueChangeOldKey];
+        else
+            [changes removeObjectForKey:NSKeyValueChangeOldKey];
+    }
+
+    [changes setObject:changeDictionaries forKey:PROKeyValueObserverCoalescedChangesKey];
+    return changes;
+}
+
+@interface PROKeyValueObserver () {
+    /*
+     * Synchronizes access to `m_pendingChanges` and
+     * `m_deliveryScheduled`.
+     */
+    pthread_mutex_t m_pendingChangesLock;
+
+    /*
+     * Change dictionaries which have been received but not yet delivered, if
+     * <coalescesChanges> is enabled.
+     */
+    NSMutableArray *m_pendingChanges;
+
+    /*
+     * Whether <deliverPendingChanges> has been scheduled on the <queue>, and
+     * has not yet started.
+     */
+    BOOL m_deliveryScheduled;
+}
+
 @property (getter = isExecuting, readwrite) BOOL executing;
+
+/*
+ * Invokes <block> with the given changes, setting <executing> for the duration.
+ */
+- (void)performBlockWithChanges:(NSDictionary *)changes;
+
+/*
+ * Coalesces any pending changes and invokes <block> with the result.
+ */
+- (void)deliverPendingChanges;
 @end
 
 @implementation PROKeyValueObserver
@@ -30,6 +91,8 @@ static void * const PROKeyValueObserverContext = "PROKeyValueObserverContext";
 @synthesize options = m_options;
 @synthesize queue = m_queue;
 @synthesize executing = m_executing;
+@synthesize coalescesChanges = m_coalescesChanges;
+@synthesize coalescingInterval = m_coalescingInterval;
 
 #pragma mark Initialization
 
@@ -50,6 +113,7 @@ static void * const PROKeyValueObserverContext = "PROKeyValueObserverContext";
     m_keyPath = [keyPath copy];
     m_options = options;
     m_block = [block copy];
+    pthread_mutex_init(&m_pendingChangesLock, NULL);
 
     self.queue = [SDQueue mainQueue];
     [self.target addObserver:self forKeyPath:self.keyPath options:self.options context:PROKeyValueObserverContext];
@@ -59,6 +123,7 @@ static void * const PROKeyValueObserverContext = "PROKeyValueObserverContext";
 
 - (void)dealloc {
     [self.target removeObserver:self forKeyPath:self.keyPath context:PROKeyValueObserverContext];
+    pthread_mutex_destroy(&m_pendingChangesLock);
 }
 
 #pragma mark NSObject overrides
@@ -73,26 +138,92 @@ static void * const PROKeyValueObserverContext = "PROKeyValueObserverContext";
     NSAssert([keyPath isEqualToString:self.keyPath], @"%@ should not be receiving change notifications for a key path other than its own", self);
     NSAssert(context == PROKeyValueObserverContext, @"%@ should not be receiving change notifications for a context other than its own", self);
 
-    PROKeyValueObserverBlock block = self.block;
+    SDQueue *queue = self.queue;
+    BOOL onQueue = (!queue || [queue isCurrentQueue]);
+
+    if (!self.coalescesChanges) {
+        PROKeyValueObserverBlock block = self.block;
 
-    void (^trampoline)(void) = ^{
-        self.executing = YES;
+        void (^trampoline)(void) = ^{
+            self.executing = YES;
 
-        // using @onExit ensures that we set the flag back to NO even in the
-        // face of an exception
-        @onExit {
-            self.executing = NO;
+            // using @onExit ensures that we set the flag back to NO even in the
+            // face of an exception
+            @onExit {
+                self.executing = NO;
+            };
+
+            block(changes);
         };
 
-        block(changes);
+        if (onQueue)
+            trampoline();
+        else
+            [queue runAsynchronously:trampoline];
+
+        return;
+    }
+
+    pthread_mutex_lock(&m_pendingChangesLock);
+
+    if (!m_pendingChanges)
+        m_pendingChanges = [[NSMutableArray alloc] init];
+
+    [m_pendingChanges addObject:changes];
+
+    BOOL scheduleDelivery = (!onQueue && !m_deliveryScheduled);
+    if (scheduleDelivery)
+        m_deliveryScheduled = YES;
+
+    pthread_mutex_unlock(&m_pendingChangesLock);
+
+    if (onQueue) {
+        // deliver this change along with anything still pending, so that
+        // changes are never reordered
+        [self deliverPendingChanges];
+    } else if (scheduleDelivery) {
+        NSTimeInterval interval = self.coalescingInterval;
+
+        if (interval > 0) {
+            [queue afterDelay:interval runAsynchronously:^{
+                [self deliverPendingChanges];
+            }];
+        } else {
+            [queue runAsynchronously:^{
+                [self deliverPendingChanges];
+            }];
+        }
+    }
+}
+
+#pragma mark Delivering Changes
+
+- (void)performBlockWithChanges:(NSDictionary *)changes; {
+    self.executing = YES;
+
+    // using @onExit ensures that we set the flag back to NO even in the
+    // face of an exception
+    @onExit {
+        self.executing = NO;
     };
 
-    SDQueue *queue = self.queue;
+    self.block(changes);
+}
+
+- (void)deliverPendingChanges; {
+    pthread_mutex_lock(&m_pendingChangesLock);
+
+    NSArray *pendingChanges = m_pendingChanges;
+    m_pendingChanges = nil;
+    m_deliveryScheduled = NO;
+
+    pthread_mutex_unlock(&m_pendingChangesLock);
+
+    // a change on the queue may have already delivered everything
+    if (!pendingChanges.count)
+        return;
 
-    if (!queue || [queue isCurrentQueue])
-        trampoline();
-    else
-        [queue runAsynchronously:trampoline];
+    [self performBlockWithChanges:coalescedChangeDictionary(pendingChanges)];
 }
 
 @end
@@ -0,0 +1,156 @@
+//
+//  PROLazySequence.h
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * Represents a pipeline of map, filter, and take operations over a collection,
+ * which is only evaluated when a terminal operation (such as <array> or
+ * <foldLeftWithValue:usingBlock:>) is invoked.
+ *
+ * Unlike chaining the methods of the `HigherOrderAdditions` categories, no
+ * intermediate collections are created. Every object from the source
+ * collection flows through all the stages of the pipeline in a single pass.
+ *
+ * Sequences are immutable. Adding a stage returns a new sequence, leaving the
+ * receiver unmodified, so a sequence can be safely evaluated any number of
+ * times and from any thread.
+ */
+@interface PROLazySequence : NSObject <NSCopying>
+
+/**
+ * @name Initialization
+ */
+
+/**
+ * Returns a sequence over the objects of the given collection, without any
+ * stages.
+ *
+ * @param collection The collection to retrieve objects from.
+ */
++ (id)sequenceWithCollection:(id<NSFastEnumeration>)collection;
+
+/**
+ * Initializes a sequence over the objects of the given collection, without any
+ * stages.
+ *
+ * This is the designated initializer.
+ *
+ * @param collection The collection to retrieve objects from. The order of
+ * objects in the sequence will match the enumeration order of this collection.
+ * The collection should not be mutated while the sequence is being evaluated.
+ */
+- (id)initWithCollection:(id<NSFastEnumeration>)collection;
+
+/**
+ * @name Execution Mode
+ */
+
+/**
+ * Whether the stages of the receiver will be evaluated on multiple threads.
+ *
+ * Map and filter stages are always invoked in an indeterminate order when
+ * concurrent, but the order of the results still matches the order of the
+ * source collection.
+ */
+@property (nonatomic, getter = isConcurrent, readonly) BOOL concurrent;
+
+/**
+ * Returns a sequence with the stages of the receiver, which will be evaluated
+ * concurrently.
+ *
+ * Map and filter stages before the first <takeCount:> stage are evaluated
+ * concurrently, in batches of one chunk per processor if there is such a stage.
+ * The take stage and everything after it are evaluated serially.
+ */
+- (PROLazySequence *)concurrentSequence;
+
+/**
+ * @name Adding Stages
+ */
+
+/**
+ * Returns a sequence which only includes the objects of the receiver for which
+ * `block` returns `YES`.
+ *
+ * @param block A predicate block that determines whether to include or exclude
+ * a given object.
+ */
+- (PROLazySequence *)filterUsingBlock:(BOOL (^)(id obj))block;
+
+/**
+ * Returns a sequence which transforms each object of the receiver with the
+ * given block.
+ *
+ * @param block A block with which to transform each element.
+ *
+ * @warning **Important:** As with `-[NSArray mapUsingBlock:]`, it is
+ * permissible to return `nil` from `block`, but doing so will omit the object
+ * from the sequence.
+ */
+- (PROLazySequence *)mapUsingBlock:(id (^)(id obj))block;
+
+/**
+ * Returns a sequence which includes at most the first `count` objects of the
+ * receiver.
+ *
+ * Once `count` objects have passed through this stage, enumeration of the
+ * source collection stops early.
+ *
+ * In a <concurrentSequence>, the stages before this one are evaluated over one
+ * chunk of the collection per processor at a time, so enumeration can only stop
+ * at the end of such a batch. Objects after the `count`th may still be passed
+ * to the blocks of earlier stages.
+ *
+ * @param count The maximum number of objects to include.
+ */
+- (PROLazySequence *)takeCount:(NSUInteger)count;
+
+/**
+ * @name Evaluating the Sequence
+ */
+
+/**
+ * Evaluates the sequence, returning an array of the resulting objects.
+ */
+- (NSArray *)array;
+
+/**
+ * Evaluates the sequence, returning an ordered set of the resulting objects.
+ */
+- (NSOrderedSet *)orderedSet;
+
+/**
+ * Evaluates the sequence, returning a set of the resulting objects.
+ */
+- (NSSet *)set;
+
+/**
+ * Evaluates the sequence, reducing the resulting objects to a single value from
+ * left to right.
+ *
+ * This follows the semantics of `-[NSArray foldLeftWithValue:usingBlock:]`.
+ * `block` is always invoked serially, even when the receiver is concurrent.
+ *
+ * @param startingValue The value to be combined with the first resulting
+ * object. If the sequence is empty, this is the value returned.
+ * @param block A block that describes how to combine objects of the sequence.
+ */
+- (id)foldLeftWithValue:(id)startingValue usingBlock:(id (^)(id left, id right))block;
+
+/**
+ * Evaluates the sequence, invoking `block` with each resulting object in order.
+ *
+ * `block` is always invoked serially, even when the receiver is concurrent.
+ *
+ * @param block A block to invoke with each object. Setting `stop` to `YES` will
+ * end evaluation early.
+ */
+- (void)enumerateObjectsUsingBlock:(void (^)(id obj, BOOL *stop))block;
+
+@end
@@ -0,0 +1,416 @@
+//
+//  PROLazySequence.m
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import "PROLazySequence.h"
+#import "EXTScope.h"
+#import "PROAssert.h"
+#import "PROConcurrentFunctions.h"
+
+/**
+ * The kinds of stages that can be added to a <PROLazySequence>.
+ */
+typedef enum {
+    PROLazySequenceStageMap,
+    PROLazySequenceStageFilter,
+    PROLazySequenceStageTake
+} PROLazySequenceStageType;
+
+/**
+ * The state of a single stage during one evaluation of a sequence.
+ */
+typedef struct {
+    PROLazySequenceStageType type;
+
+    /**
+     * The block for a map or filter stage. This is retained by the
+     * corresponding <PROLazySequenceStage>.
+     */
+    __unsafe_unretained id block;
+
+    /**
+     * For a take stage, the number of objects which may still pass through.
+     */
+    NSUInteger remaining;
+} PROLazySequenceStageState;
+
+/**
+ * A single stage of a <PROLazySequence>.
+ */
+@interface PROLazySequenceStage : NSObject
+
+/**
+ * The kind of this stage.
+ */
+@property (nonatomic, assign) PROLazySequenceStageType type;
+
+/**
+ * The block to invoke for a map or filter stage.
+ */
+@property (nonatomic, copy) id block;
+
+/**
+ * The maximum number of objects to include, for a take stage.
+ */
+@property (nonatomic, assign) NSUInteger count;
+@end
+
+@interface PROLazySequence ()
+@property (nonatomic, strong, readonly) id<NSFastEnumeration> collection;
+@property (nonatomic, copy) NSArray *stages;
+@property (nonatomic, getter = isConcurrent, readwrite) BOOL concurrent;
+
+/**
+ * Returns a new sequence with the stages of the receiver and the given stage
+ * appended.
+ */
+- (PROLazySequence *)sequenceByAddingStage:(PROLazySequenceStage *)stage;
+@end
+
+/**
+ * Passes `obj` through the given stages, returning the resulting object, or
+ * `nil` if the object was dropped by one of the stages.
+ *
+ * If a take stage has been exhausted, such that no further objects could make
+ * it through the pipeline, `exhausted` is set to `YES`.
+ */
+static id applyStages (id obj, PROLazySequenceStageState *stages, NSUInteger stageCount, BOOL *exhausted) {
+    for (NSUInteger i = 0; i < stageCount; ++i) {
+        PROLazySequenceStageState *stage = stages + i;
+
+        switch (stage->type) {
+            case PROLazySequenceStageMap:
+                obj = ((id (^)(id))stage->block)(obj);
+                if (!obj)
+                    return nil;
+
+                break;
+
+            case PROLazySequenceStageFilter:
+                if (!((BOOL (^)(id))stage->block)(obj))
+                    return nil;
+
+                break;
+
+            case PROLazySequenceStageTake:
+                if (!stage->remaining) {
+                    *exhausted = YES;
+                    return nil;
+                }
+
+                if (--stage->remaining == 0)
+                    *exhausted = YES;
+
+                break;
+        }
+    }
+
+    return obj;
+}
+
+/**
+ * Returns the objects of the given collection as an array, avoiding a copy
+ * whenever possible.
+ */
+static NSArray *arrayFromCollection (id<NSFastEnumeration> collection) {
+    if ([(id)collection isKindOfClass:[NSArray class]])
+        return (NSArray *)collection;
+    else if ([(id)collection isKindOfClass:[NSOrderedSet class]])
+        return [(NSOrderedSet *)collection array];
+    else if ([(id)collection isKindOfClass:[NSSet class]])
+        return [(NSSet *)collection allObjects];
+
+    NSMutableArray *array = [NSMutableArray array];
+    for (id obj in collection) {
+        [array addObject:obj];
+    }
+
+    return array;
+}
+
+@implementation PROLazySequenceStage
+@synthesize type = m_type;
+@synthesize block = m_block;
+@synthesize count = m_count;
+@end
+
+@implementation PROLazySequence
+
+#pragma mark Properties
+
+@synthesize collection = m_collection;
+@synthesize stages = m_stages;
+@synthesize concurrent = m_concurrent;
+
+#pragma mark Lifecycle
+
++ (id)sequenceWithCollection:(id<NSFastEnumeration>)collection; {
+    return [[self alloc] initWithCollection:collection];
+}
+
+- (id)init; {
+    return [self initWithCollection:[NSArray array]];
+}
+
+- (id)initWithCollection:(id<NSFastEnumeration>)collection; {
+    NSParameterAssert(collection != nil);
+
+    self = [super init];
+    if (!self)
+        return nil;
+
+    m_collection = collection;
+    m_stages = [NSArray array];
+
+    return self;
+}
+
+#pragma mark Execution Mode
+
+- (PROLazySequence *)concurrentSequence; {
+    if (self.concurrent)
+        return self;
+
+    PROLazySequence *sequence = [[[self class] alloc] initWithCollection:self.collection];
+    sequence.stages = self.stages;
+    sequence.concurrent = YES;
+
+    return sequence;
+}
+
+#pragma mark Adding Stages
+
+- (PROLazySequence *)sequenceByAddingStage:(PROLazySequenceStage *)stage; {
+    PROLazySequence *sequence = [[[self class] alloc] initWithCollection:self.collection];
+    sequence.stages = [self.stages arrayByAddingObject:stage];
+    sequence.concurrent = self.concurrent;
+
+    return sequence;
+}
+
+- (PROLazySequence *)filterUsingBlock:(BOOL (^)(id obj))block; {
+    NSParameterAssert(block != nil);
+
+    PROLazySequenceStage *stage = [[PROLazySequenceStage alloc] init];
+    stage.type = PROLazySequenceStageFilter;
+    stage.block = block;
+
+    return [self sequenceByAddingStage:stage];
+}
+
+- (PROLazySequence *)mapUsingBlock:(id (^)(id obj))block; {
+    NSParameterAssert(block != nil);
+
+    PROLazySequenceStage *stage = [[PROLazySequenceStage alloc] init];
+    stage.type = PROLazySequenceStageMap;
+    stage.block = block;
+
+    return [self sequenceByAddingStage:stage];
+}
+
+- (PROLazySequence *)takeCount:(NSUInteger)count; {
+    PROLazySequenceStage *stage = [[PROLazySequenceStage alloc] init];
+    stage.type = PROLazySequenceStageTake;
+    stage.count = count;
+
+    return [self sequenceByAddingStage:stage];
+}
+
+#pragma mark Evaluation
+
+- (void)enumerateObjectsUsingBlock:(void (^)(id obj, BOOL *stop))block; {
+    NSParameterAssert(block != nil);
+
+    NSArray *stageObjects = self.stages;
+    NSUInteger stageCount = stageObjects.count;
+
+    PROLazySequenceStageState *stages = calloc(stageCount + 1, sizeof(*stages));
+    if (!PROAssert(stages, @"Could not allocate space for %lu sequence stages", (unsigned long)stageCount))
+        return;
+
+    @onExit {
+        free(stages);
+    };
+
+    // the index of the first take stage, before which all stages can be safely
+    // evaluated concurrently
+    NSUInteger firstTakeIndex = stageCount;
+
+    for (NSUInteger i = 0; i < stageCount; ++i) {
+        PROLazySequenceStage *stage = [stageObjects objectAtIndex:i];
+
+        stages[i].type = stage.type;
+        stages[i].block = stage.block;
+        stages[i].remaining = stage.count;
+
+        if (stage.type == PROLazySequenceStageTake && firstTakeIndex == stageCount)
+            firstTakeIndex = i;
+    }
+
+    BOOL stop = NO;
+    BOOL exhausted = NO;
+
+    if (!self.concurrent || firstTakeIndex == 0) {
+        for (id obj in self.collection) {
+            id result = applyStages(obj, stages, stageCount, &exhausted);
+
+            if (result) {
+                block(result, &stop);
+                if (stop)
+                    break;
+            }
+
+            if (exhausted)
+                break;
+        }
+
+        return;
+    }
+
+    NSArray *objects = arrayFromCollection(self.collection);
+    NSUInteger count = objects.count;
+
+    NSUInteger totalChunkCount = PROConcurrentChunkCount(count, 0);
+    NSUInteger grainSize = MAX((NSUInteger)1, (count + totalChunkCount - 1) / MAX(totalChunkCount, (NSUInteger)1));
+
+    // if there's a take stage, evaluate one chunk per processor at a time, so
+    // that enumeration can stop without evaluating the rest of the collection
+    NSUInteger waveSize = count;
+    if (firstTakeIndex < stageCount)
+        waveSize = MIN(count, grainSize * MAX([[NSProcessInfo processInfo] activeProcessorCount], (NSUInteger)1));
+
+    NSUInteger maximumChunkCount = PROConcurrentChunkCount(waveSize, grainSize);
+
+    // the results of the concurrent stages, where the results of each chunk are
+    // compacted into the beginning of that chunk's range
+    __strong id *results = (__strong id *)calloc(waveSize, sizeof(*results));
+    if (!PROAssert(results || !waveSize, @"Could not allocate space for %lu objects", (unsigned long)waveSize))
+        return;
+
+    @onExit {
+        // nil out everything in the array to make sure ARC releases
+        // everything appropriately
+        for (NSUInteger i = 0; i < waveSize; ++i) {
+            results[i] = nil;
+        }
+
+        free(results);
+    };
+
+    NSRange *resultRanges = calloc(maximumChunkCount + 1, sizeof(*resultRanges));
+    if (!PROAssert(resultRanges, @"Could not allocate space for %lu ranges", (unsigned long)maximumChunkCount))
+        return;
+
+    @onExit {
+        free(resultRanges);
+    };
+
+    NSUInteger waveStart = 0;
+
+    while (waveStart < count && !stop && !exhausted) {
+        NSUInteger waveLength = MIN(waveSize, count - waveStart);
+        NSUInteger chunkCount = PROConcurrentChunkCount(waveLength, grainSize);
+
+        PROConcurrentEnumerateChunks(waveLength, grainSize, ^(NSUInteger chunkIndex, NSRange range){
+            NSUInteger nextIndex = range.location;
+
+            // map and filter stages never become exhausted
+            BOOL unused = NO;
+
+            for (NSUInteger i = range.location; i < NSMaxRange(range); ++i) {
+                id result = applyStages([objects objectAtIndex:waveStart + i], stages, firstTakeIndex, &unused);
+                if (result)
+                    results[nextIndex++] = result;
+            }
+
+            resultRanges[chunkIndex] = NSMakeRange(range.location, nextIndex - range.location);
+        });
+
+        // the remaining stages are stateful, so they must run serially and in
+        // order
+        for (NSUInteger chunkIndex = 0; chunkIndex < chunkCount && !stop && !exhausted; ++chunkIndex) {
+            NSRange range = resultRanges[chunkIndex];
+
+            for (NSUInteger i = range.location; i < NSMaxRange(range); ++i) {
+                id result = applyStages(results[i], stages + firstTakeIndex, stageCount - firstTakeIndex, &exhausted);
+
+                if (result) {
+                    block(result, &stop);
+                    if (stop)
+                        break;
+                }
+
+                if (exhausted)
+                    break;
+            }
+        }
+
+        // release the results of this wave before starting the next
+        for (NSUInteger i = 0; i < waveLength; ++i) {
+            results[i] = nil;
+        }
+
+        waveStart += waveLength;
+    }
+}
+
+- (NSArray *)array; {
+    NSMutableArray *array = [NSMutableArray array];
+
+    [self enumerateObjectsUsingBlock:^(id obj, BOOL *stop){
+        [array addObject:obj];
+    }];
+
+    return array;
+}
+
+- (NSOrderedSet *)orderedSet; {
+    NSMutableOrderedSet *orderedSet = [NSMutableOrderedSet orderedSet];
+
+    [self enumerateObjectsUsingBlock:^(id obj, BOOL *stop){
+        [orderedSet addObject:obj];
+    }];
+
+    return orderedSet;
+}
+
+- (NSSet *)set; {
+    NSMutableSet *set = [NSMutableSet set];
+
+    [self enumerateObjectsUsingBlock:^(id obj, BOOL *stop){
+        [set addObject:obj];
+    }];
+
+    return set;
+}
+
+- (id)foldLeftWithValue:(id)startingValue usingBlock:(id (^)(id left, id right))block; {
+    NSParameterAssert(block != nil);
+
+    __block id value = startingValue;
+
+    [self enumerateObjectsUsingBlock:^(id obj, BOOL *stop){
+        value = block(value, obj);
+    }];
+
+    return value;
+}
+
+#pragma mark NSCopying
+
+- (id)copyWithZone:(NSZone *)zone {
+    // sequences are immutable
+    return self;
+}
+
+#pragma mark NSObject overrides
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p>( collection = %@, stages = %lu, concurrent = %i )", [self class], (__bridge void *)self, self.collection, (unsigned long)self.stages.count, (int)self.concurrent];
+}
+
+@end
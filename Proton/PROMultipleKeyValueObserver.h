@@ -0,0 +1,141 @@
+//
+//  PROMultipleKeyValueObserver.h
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <Proton/PROKeyValueObserver.h>
+
+@class SDQueue;
+
+/**
+ * Observes any number of key paths on a single target, invoking a separate
+ * block for each.
+ *
+ * Unlike creating one <PROKeyValueObserver> per key path, this class registers
+ * only one observer object with the target, keeps one table of blocks, and
+ * delivers every change that arrives off of its <queue> in a shared dispatch
+ * to that queue. This makes it much cheaper to observe many properties of the
+ * same object.
+ *
+ * Changes are always delivered in the order they were received, regardless of
+ * which key path they apply to.
+ *
+ * This class is thread-safe.
+ */
+@interface PROMultipleKeyValueObserver : NSObject
+
+/**
+ * @name Initialization
+ */
+
+/**
+ * Initializes the receiver to observe key paths on the given target, invoking
+ * blocks on the main dispatch queue when a change occurs.
+ *
+ * No key paths are observed until <addKeyPath:options:usingBlock:> is invoked.
+ * Observation of all key paths will stop when the receiver is destroyed.
+ *
+ * This is the designated initializer.
+ *
+ * @param target The object to observe.
+ *
+ * @warning **Important:** It is undefined behavior for the receiver to remain
+ * alive longer than the target object. The `<NSKeyValueObserving>` protocol
+ * specifies that observations must cease before the observed object is
+ * deallocated.
+ */
+- (id)initWithTarget:(id)target;
+
+/**
+ * @name Observing Key Paths
+ */
+
+/**
+ * Invokes <addKeyPath:options:usingBlock:> without any options.
+ *
+ * @param keyPath The key path, relative to the <target>, to observe for
+ * changes.
+ * @param block The block to invoke when a change notification is sent.
+ */
+- (void)addKeyPath:(NSString *)keyPath usingBlock:(PROKeyValueObserverBlock)block;
+
+/**
+ * Begins observing the given key path on the <target>, invoking `block` when
+ * it changes.
+ *
+ * If `keyPath` is already being observed, its existing block is replaced.
+ *
+ * @param keyPath The key path, relative to the <target>, to observe for
+ * changes.
+ * @param options A bitmask of options controlling the information that will be
+ * provided in the KVO change dictionary.
+ * @param block The block to invoke when a change notification is sent.
+ */
+- (void)addKeyPath:(NSString *)keyPath options:(NSKeyValueObservingOptions)options usingBlock:(PROKeyValueObserverBlock)block;
+
+/**
+ * Stops observing the given key path.
+ *
+ * If changes to `keyPath` were received off of the <queue> and have not yet
+ * been delivered, its block may still be invoked once more.
+ *
+ * @param keyPath A key path previously passed to
+ * <addKeyPath:options:usingBlock:>. If it is not being observed, nothing
+ * happens.
+ */
+- (void)removeKeyPath:(NSString *)keyPath;
+
+/**
+ * Stops observing every key path.
+ */
+- (void)removeAllKeyPaths;
+
+/**
+ * @name Key-Value Observation Properties
+ */
+
+/**
+ * The object being observed.
+ *
+ * @warning **Important:** It is undefined behavior for the receiver to remain
+ * alive longer than the target object. The `<NSKeyValueObserving>` protocol
+ * specifies that observations must cease before the observed object is
+ * deallocated.
+ */
+@property (nonatomic, unsafe_unretained, readonly) id target;
+
+/**
+ * The key paths, relative to the <target>, currently being observed.
+ */
+@property (copy, readonly) NSSet *keyPaths;
+
+/**
+ * The dispatch queue upon which blocks will be invoked.
+ *
+ * If a change occurs on this dispatch queue (directly or indirectly), or this
+ * property is `nil`, the block for the changed key path is invoked
+ * synchronously on the thread that caused the change. Otherwise, changes are
+ * collected and delivered together in a single asynchronous dispatch to this
+ * queue.
+ *
+ * This property defaults to the main dispatch queue.
+ *
+ * @warning Changes to this property will not affect any currently executing
+ * blocks.
+ */
+@property (strong) SDQueue *queue;
+
+/**
+ * Whether the receiver is currently executing one of its blocks on the
+ * <queue>.
+ *
+ * This can be used to conditionalize actions based on whether they are
+ * occurring as part of a KVO callback.
+ */
+@property (getter = isExecuting, readonly) BOOL executing;
+
+@end
@@ -0,0 +1,332 @@
+//
+//  PROMultipleKeyValueObserver.m
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import "PROMultipleKeyValueObserver.h"
+#import "EXTScope.h"
+#import "SDQueue.h"
+#import <pthread.h>
+
+/*
+ * A unique context pointer for our class, so that we can uniquely identify
+ * observations that we set up.
+ */
+static void * const PROMultipleKeyValueObserverContext = "PROMultipleKeyValueObserverContext";
+
+@interface PROMultipleKeyValueObserver () {
+    /*
+     * Serializes adding and removing key paths, including the calls to
+     * register and unregister with the <target>, so that those calls always
+     * match up with `m_blocksByKeyPath`.
+     *
+     * This must be acquired before `m_lock`, and must never be held while
+     * invoking a block.
+     */
+    pthread_mutex_t m_registrationLock;
+
+    /*
+     * Synchronizes access to `m_blocksByKeyPath`, `m_pendingBlocks`,
+     * `m_pendingChanges`, `m_deliveryScheduled`, `m_registering`, and
+     * `m_registeringThread`.
+     */
+    pthread_mutex_t m_lock;
+
+    /*
+     * The block to invoke for each observed key path, keyed by key path.
+     */
+    NSMutableDictionary *m_blocksByKeyPath;
+
+    /*
+     * Blocks which need to be invoked on the <queue>, and the change
+     * dictionary to invoke each one with, at the same index.
+     */
+    NSMutableArray *m_pendingBlocks;
+    NSMutableArray *m_pendingChanges;
+
+    /*
+     * Whether <deliverPendingChanges> has been scheduled on the <queue>, and
+     * has not yet started.
+     */
+    BOOL m_deliveryScheduled;
+
+    /*
+     * Whether `m_registeringThread` is currently registering with the
+     * <target>. Changes it receives in the meantime (such as those for
+     * `NSKeyValueObservingOptionInitial`) are queued up instead of being
+     * delivered while `m_registrationLock` is held.
+     */
+    BOOL m_registering;
+    pthread_t m_registeringThread;
+}
+
+@property (getter = isExecuting, readwrite) BOOL executing;
+
+/*
+ * Invokes every pending block with its change dictionary, in the order they
+ * were received.
+ */
+- (void)deliverPendingChanges;
+@end
+
+@implementation PROMultipleKeyValueObserver
+
+#pragma mark Properties
+
+@synthesize target = m_target;
+@synthesize queue = m_queue;
+@synthesize executing = m_executing;
+
+- (NSSet *)keyPaths {
+    pthread_mutex_lock(&m_lock);
+    @onExit {
+        pthread_mutex_unlock(&m_lock);
+    };
+
+    return [NSSet setWithArray:m_blocksByKeyPath.allKeys];
+}
+
+#pragma mark Initialization
+
+- (id)init {
+    return [self initWithTarget:nil];
+}
+
+- (id)initWithTarget:(id)target; {
+    self = [super init];
+    if (!self)
+        return nil;
+
+    pthread_mutex_init(&m_registrationLock, NULL);
+    pthread_mutex_init(&m_lock, NULL);
+
+    m_target = target;
+    m_blocksByKeyPath = [[NSMutableDictionary alloc] init];
+
+    self.queue = [SDQueue mainQueue];
+    return self;
+}
+
+- (void)dealloc {
+    for (NSString *keyPath in m_blocksByKeyPath) {
+        [self.target removeObserver:self forKeyPath:keyPath context:PROMultipleKeyValueObserverContext];
+    }
+
+    pthread_mutex_destroy(&m_lock);
+    pthread_mutex_destroy(&m_registrationLock);
+}
+
+#pragma mark Observing Key Paths
+
+- (void)addKeyPath:(NSString *)keyPath usingBlock:(PROKeyValueObserverBlock)block; {
+    [self addKeyPath:keyPath options:0 usingBlock:block];
+}
+
+- (void)addKeyPath:(NSString *)keyPath options:(NSKeyValueObservingOptions)options usingBlock:(PROKeyValueObserverBlock)block; {
+    NSParameterAssert(keyPath);
+    NSParameterAssert(block);
+
+    keyPath = [keyPath copy];
+    block = [block copy];
+
+    {
+        pthread_mutex_lock(&m_registrationLock);
+        @onExit {
+            pthread_mutex_unlock(&m_registrationLock);
+        };
+
+        BOOL observing;
+
+        pthread_mutex_lock(&m_lock);
+        observing = ([m_blocksByKeyPath objectForKey:keyPath] != nil);
+        [m_blocksByKeyPath setObject:block forKey:keyPath];
+        pthread_mutex_unlock(&m_lock);
+
+        // the options might be different, so re-register from scratch
+        if (observing)
+            [self.target removeObserver:self forKeyPath:keyPath context:PROMultipleKeyValueObserverContext];
+
+        pthread_mutex_lock(&m_lock);
+        m_registering = YES;
+        m_registeringThread = pthread_self();
+        pthread_mutex_unlock(&m_lock);
+
+        @onExit {
+            pthread_mutex_lock(&m_lock);
+            m_registering = NO;
+            pthread_mutex_unlock(&m_lock);
+        };
+
+        // this must be done without holding `m_lock`, since
+        // NSKeyValueObservingOptionInitial will notify us immediately
+        [self.target addObserver:self forKeyPath:keyPath options:options context:PROMultipleKeyValueObserverContext];
+    }
+
+    // deliver anything that arrived while registering, now that no locks are
+    // held
+    SDQueue *queue = self.queue;
+    if (!queue || [queue isCurrentQueue])
+        [self deliverPendingChanges];
+}
+
+- (void)removeKeyPath:(NSString *)keyPath; {
+    NSParameterAssert(keyPath);
+
+    pthread_mutex_lock(&m_registrationLock);
+    @onExit {
+        pthread_mutex_unlock(&m_registrationLock);
+    };
+
+    BOOL observing;
+
+    {
+        pthread_mutex_lock(&m_lock);
+        @onExit {
+            pthread_mutex_unlock(&m_lock);
+        };
+
+        observing = ([m_blocksByKeyPath objectForKey:keyPath] != nil);
+        if (observing)
+            [m_blocksByKeyPath removeObjectForKey:keyPath];
+    }
+
+    if (observing)
+        [self.target removeObserver:self forKeyPath:keyPath context:PROMultipleKeyValueObserverContext];
+}
+
+- (void)removeAllKeyPaths; {
+    pthread_mutex_lock(&m_registrationLock);
+    @onExit {
+        pthread_mutex_unlock(&m_registrationLock);
+    };
+
+    NSArray *keyPaths;
+
+    {
+        pthread_mutex_lock(&m_lock);
+        @onExit {
+            pthread_mutex_unlock(&m_lock);
+        };
+
+        keyPaths = m_blocksByKeyPath.allKeys;
+        [m_blocksByKeyPath removeAllObjects];
+    }
+
+    for (NSString *keyPath in keyPaths) {
+        [self.target removeObserver:self forKeyPath:keyPath context:PROMultipleKeyValueObserverContext];
+    }
+}
+
+#pragma mark NSObject overrides
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p>( target = %@, keyPaths = %@ )", [self class], (__bridge void *)self, self.target, self.keyPaths];
+}
+
+#pragma mark NSKeyValueObserving
+
+- (void)observeValueForKeyPath:(NSString *)keyPath ofObject:(id)object change:(NSDictionary *)changes context:(void *)context {
+    NSAssert(context == PROMultipleKeyValueObserverContext, @"%@ should not be receiving change notifications for a context other than its own", self);
+
+    SDQueue *queue = self.queue;
+    BOOL onQueue = (!queue || [queue isCurrentQueue]);
+
+    PROKeyValueObserverBlock block;
+    BOOL invokeImmediately = NO;
+    BOOL scheduleDelivery = NO;
+    BOOL registering;
+
+    {
+        pthread_mutex_lock(&m_lock);
+        @onExit {
+            pthread_mutex_unlock(&m_lock);
+        };
+
+        block = [m_blocksByKeyPath objectForKey:keyPath];
+
+        // the key path may have been removed on another thread
+        if (!block)
+            return;
+
+        // this thread may be holding `m_registrationLock`, in which case
+        // <addKeyPath:options:usingBlock:> will deliver the change afterward
+        registering = (m_registering && pthread_equal(m_registeringThread, pthread_self()));
+
+        if (onQueue && !registering && !m_pendingBlocks.count) {
+            // nothing to reorder with, so skip the queue entirely
+            invokeImmediately = YES;
+        } else {
+            if (!m_pendingBlocks) {
+                m_pendingBlocks = [[NSMutableArray alloc] init];
+                m_pendingChanges = [[NSMutableArray alloc] init];
+            }
+
+            [m_pendingBlocks addObject:block];
+            [m_pendingChanges addObject:changes];
+
+            scheduleDelivery = (!onQueue && !m_deliveryScheduled);
+            if (scheduleDelivery)
+                m_deliveryScheduled = YES;
+        }
+    }
+
+    if (invokeImmediately) {
+        self.executing = YES;
+
+        // using @onExit ensures that we set the flag back to NO even in the
+        // face of an exception
+        @onExit {
+            self.executing = NO;
+        };
+
+        block(changes);
+    } else if (onQueue && !registering) {
+        // deliver this change along with anything still pending, so that
+        // changes are never reordered
+        [self deliverPendingChanges];
+    } else if (scheduleDelivery) {
+        // every change that arrives before this runs will share the same hop
+        // to the queue
+        [queue runAsynchronously:^{
+            [self deliverPendingChanges];
+        }];
+    }
+}
+
+#pragma mark Delivering Changes
+
+- (void)deliverPendingChanges; {
+    NSArray *pendingBlocks;
+    NSArray *pendingChanges;
+
+    pthread_mutex_lock(&m_lock);
+
+    pendingBlocks = m_pendingBlocks;
+    pendingChanges = m_pendingChanges;
+    m_pendingBlocks = nil;
+    m_pendingChanges = nil;
+    m_deliveryScheduled = NO;
+
+    pthread_mutex_unlock(&m_lock);
+
+    // a change on the queue may have already delivered everything
+    if (!pendingBlocks.count)
+        return;
+
+    self.executing = YES;
+
+    // using @onExit ensures that we set the flag back to NO even in the
+    // face of an exception
+    @onExit {
+        self.executing = NO;
+    };
+
+    [pendingBlocks enumerateObjectsUsingBlock:^(PROKeyValueObserverBlock block, NSUInteger index, BOOL *stop){
+        block([pendingChanges objectAtIndex:index]);
+    }];
+}
+
+@end
@@ -0,0 +1,223 @@
+//
+//  PRONumericArray.h
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * An immutable array of `double` values, stored contiguously.
+ *
+ * This class mirrors the methods of `NSArray+HigherOrderAdditions.h`, but works
+ * directly with unboxed values, avoiding an `NSNumber` allocation and message
+ * send for every element. The aggregate operations (like <sum> and
+ * <prefixSums>) are simple loops over the underlying storage, which the
+ * compiler can vectorize.
+ */
+@interface PRONumericArray : NSObject <NSCopying>
+
+/**
+ * @name Initialization
+ */
+
+/**
+ * Returns a numeric array containing the `doubleValue` of each `NSNumber` in
+ * the given array.
+ *
+ * @param array An array of `NSNumber` objects.
+ */
++ (id)numericArrayWithArray:(NSArray *)array;
+
+/**
+ * Returns a numeric array containing a copy of the given values.
+ *
+ * @param values The values to copy into the numeric array. This may be `NULL`
+ * if `count` is zero.
+ * @param count The number of values in `values`.
+ */
++ (id)numericArrayWithValues:(const double *)values count:(NSUInteger)count;
+
+/**
+ * Initializes the receiver with the `doubleValue` of each `NSNumber` in the
+ * given array.
+ *
+ * @param array An array of `NSNumber` objects.
+ */
+- (id)initWithArray:(NSArray *)array;
+
+/**
+ * Initializes the receiver with a copy of the given values.
+ *
+ * This is the designated initializer.
+ *
+ * @param values The values to copy into the numeric array. This may be `NULL`
+ * if `count` is zero.
+ * @param count The number of values in `values`.
+ */
+- (id)initWithValues:(const double *)values count:(NSUInteger)count;
+
+/**
+ * @name Accessing Values
+ */
+
+/**
+ * The number of values in the receiver.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+/**
+ * The contiguous storage of the receiver, which contains <count> values.
+ *
+ * This pointer remains valid for the lifetime of the receiver. The values must
+ * not be modified.
+ */
+@property (nonatomic, readonly) const double *values;
+
+/**
+ * Returns the value at the given index.
+ *
+ * @param index The index of the value to return. This must be less than
+ * <count>.
+ */
+- (double)valueAtIndex:(NSUInteger)index;
+
+/**
+ * Returns an array of `NSNumber` objects corresponding to the values of the
+ * receiver.
+ */
+- (NSArray *)array;
+
+/**
+ * @name Higher-Order Functions
+ */
+
+/**
+ * Returns a numeric array of the values for which `block` returns `YES`.
+ *
+ * @param block A predicate block that determines whether to include or exclude
+ * a given value.
+ */
+- (PRONumericArray *)filterUsingBlock:(BOOL (^)(double value))block;
+
+/**
+ * Returns a numeric array of the values for which `block` returns `YES`,
+ * applying `opts` while filtering.
+ *
+ * @param opts A mask of `NSEnumerationOptions` to apply when filtering. With
+ * `NSEnumerationConcurrent`, contiguous chunks of the receiver are filtered on
+ * the concurrent global `SDQueue`.
+ * @param block A predicate block that determines whether to include or exclude
+ * a given value.
+ */
+- (PRONumericArray *)filterWithOptions:(NSEnumerationOptions)opts usingBlock:(BOOL (^)(double value))block;
+
+/**
+ * Reduces the receiver to a single value from left to right, using the given
+ * block, in the same manner as `-[NSArray foldLeftWithValue:usingBlock:]`.
+ *
+ * @param startingValue The value to be combined with the first value of the
+ * receiver. If the receiver is empty, this is the value returned.
+ * @param block A block that describes how to combine values of the receiver.
+ */
+- (double)foldLeftWithValue:(double)startingValue usingBlock:(double (^)(double left, double right))block;
+
+/**
+ * Reduces the receiver to a single value from right to left, using the given
+ * block, in the same manner as `-[NSArray foldRightWithValue:usingBlock:]`.
+ *
+ * @param startingValue The value to be combined with the last value of the
+ * receiver. If the receiver is empty, this is the value returned.
+ * @param block A block that describes how to combine values of the receiver.
+ */
+- (double)foldRightWithValue:(double)startingValue usingBlock:(double (^)(double left, double right))block;
+
+/**
+ * Transforms each value in the receiver with the given block, returning a new
+ * numeric array of the same size.
+ *
+ * @param block A block with which to transform each value.
+ */
+- (PRONumericArray *)mapUsingBlock:(double (^)(double value))block;
+
+/**
+ * Transforms each value in the receiver with the given block, according to the
+ * semantics of `opts`, returning a new numeric array of the same size.
+ *
+ * @param opts A mask of `NSEnumerationOptions` to apply when mapping. With
+ * `NSEnumerationConcurrent`, contiguous chunks of the receiver are mapped on
+ * the concurrent global `SDQueue`.
+ * @param block A block with which to transform each value.
+ */
+- (PRONumericArray *)mapWithOptions:(NSEnumerationOptions)opts usingBlock:(double (^)(double value))block;
+
+/**
+ * Reduces the receiver to a single value by folding contiguous chunks
+ * concurrently, in the same manner as `-[NSArray
+ * reduceWithIdentity:usingBlock:]`.
+ *
+ * @param identity An identity value for `block`. If the receiver is empty, this
+ * is the value returned.
+ * @param block An associative block that combines two values. This block may be
+ * invoked concurrently, and must be thread-safe.
+ */
+- (double)reduceWithIdentity:(double)identity usingBlock:(double (^)(double left, double right))block;
+
+/**
+ * @name Aggregate Operations
+ */
+
+/**
+ * The sum of all the values in the receiver, or zero if the receiver is empty.
+ *
+ * Because partial sums are accumulated separately (to allow vectorization), the
+ * result may differ from a strict left-to-right sum in the last few bits.
+ */
+- (double)sum;
+
+/**
+ * The smallest value in the receiver, or `NAN` if the receiver is empty.
+ */
+- (double)minimum;
+
+/**
+ * The largest value in the receiver, or `NAN` if the receiver is empty.
+ */
+- (double)maximum;
+
+/**
+ * Returns a numeric array where each value is the sum of the values of the
+ * receiver up to and including the same index.
+ */
+- (PRONumericArray *)prefixSums;
+
+/**
+ * Returns a numeric array with `value` added to every value of the receiver.
+ *
+ * @param value The value to add.
+ */
+- (PRONumericArray *)numericArrayByAddingValue:(double)value;
+
+/**
+ * Returns a numeric array with every value of the receiver multiplied by
+ * `value`.
+ *
+ * @param value The value to multiply by.
+ */
+- (PRONumericArray *)numericArrayByMultiplyingByValue:(double)value;
+
+/**
+ * Returns a numeric array of the values of the receiver which are greater than
+ * or equal to `minimum` and less than or equal to `maximum`.
+ *
+ * This is equivalent to using <filterUsingBlock:> with the same comparison,
+ * but without invoking a block for each value.
+ *
+ * @param minimum The smallest value to include.
+ * @param maximum The largest value to include.
+ */
+- (PRONumericArray *)filterValuesFromMinimum:(double)minimum toMaximum:(double)maximum;
+
+@end
@@ -0,0 +1,404 @@
+//
+//  PRONumericArray.m
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import "PRONumericArray.h"
+#import "EXTScope.h"
+#import "PROAssert.h"
+#import "PROConcurrentFunctions.h"
+
+@interface PRONumericArray () {
+    /**
+     * The storage for <values>, which is owned by the receiver.
+     */
+    double *m_values;
+}
+
+/**
+ * Returns a numeric array which takes ownership of the given buffer, instead
+ * of copying it.
+ *
+ * @param values A buffer allocated with `malloc()`, or `NULL` if `count` is
+ * zero.
+ * @param count The number of values in `values`.
+ */
++ (id)numericArrayWithValuesNoCopy:(double *)values count:(NSUInteger)count;
+@end
+
+@implementation PRONumericArray
+
+#pragma mark Properties
+
+@synthesize count = m_count;
+
+- (const double *)values {
+    return m_values;
+}
+
+#pragma mark Lifecycle
+
++ (id)numericArrayWithArray:(NSArray *)array; {
+    return [[self alloc] initWithArray:array];
+}
+
++ (id)numericArrayWithValues:(const double *)values count:(NSUInteger)count; {
+    return [[self alloc] initWithValues:values count:count];
+}
+
++ (id)numericArrayWithValuesNoCopy:(double *)values count:(NSUInteger)count; {
+    PRONumericArray *numericArray = [[self alloc] initWithValues:NULL count:0];
+
+    numericArray->m_values = values;
+    numericArray->m_count = count;
+
+    return numericArray;
+}
+
+- (id)init; {
+    return [self initWithValues:NULL count:0];
+}
+
+- (id)initWithArray:(NSArray *)array; {
+    NSUInteger count = array.count;
+
+    double *values = malloc((count + 1) * sizeof(*values));
+    if (!PROAssert(values, @"Could not allocate space for %lu values", (unsigned long)count))
+        return nil;
+
+    @onExit {
+        free(values);
+    };
+
+    [array enumerateObjectsUsingBlock:^(NSNumber *number, NSUInteger index, BOOL *stop){
+        values[index] = [number doubleValue];
+    }];
+
+    return [self initWithValues:values count:count];
+}
+
+- (id)initWithValues:(const double *)values count:(NSUInteger)count; {
+    NSParameterAssert(values != NULL || !count);
+
+    self = [super init];
+    if (!self)
+        return nil;
+
+    if (count) {
+        m_values = malloc(count * sizeof(*m_values));
+        if (!PROAssert(m_values, @"Could not allocate space for %lu values", (unsigned long)count))
+            return nil;
+
+        memcpy(m_values, values, count * sizeof(*m_values));
+        m_count = count;
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    free(m_values);
+}
+
+#pragma mark Accessing Values
+
+- (double)valueAtIndex:(NSUInteger)index; {
+    NSParameterAssert(index < m_count);
+
+    return m_values[index];
+}
+
+- (NSArray *)array; {
+    NSMutableArray *array = [[NSMutableArray alloc] initWithCapacity:m_count];
+
+    for (NSUInteger i = 0; i < m_count; ++i) {
+        [array addObject:[NSNumber numberWithDouble:m_values[i]]];
+    }
+
+    return [array copy];
+}
+
+#pragma mark Higher-Order Functions
+
+- (PRONumericArray *)filterUsingBlock:(BOOL (^)(double value))block; {
+    return [self filterWithOptions:0 usingBlock:block];
+}
+
+- (PRONumericArray *)filterWithOptions:(NSEnumerationOptions)opts usingBlock:(BOOL (^)(double value))block; {
+    NSParameterAssert(block != nil);
+
+    NSUInteger count = m_count;
+    const double *values = m_values;
+
+    BOOL concurrent = (opts & NSEnumerationConcurrent);
+    BOOL reverse = (opts & NSEnumerationReverse);
+
+    // whether each value passed the test, indexed by its position in the
+    // result order
+    BOOL *passed = malloc((count + 1) * sizeof(*passed));
+    if (!PROAssert(passed, @"Could not allocate space for %lu flags", (unsigned long)count))
+        return nil;
+
+    @onExit {
+        free(passed);
+    };
+
+    double *filteredValues = malloc((count + 1) * sizeof(*filteredValues));
+    if (!PROAssert(filteredValues, @"Could not allocate space for %lu values", (unsigned long)count))
+        return nil;
+
+    NSUInteger filteredCount = PROConcurrentCompact(count, (concurrent ? 0 : count), ^(NSRange range){
+        NSUInteger passedCount = 0;
+
+        for (NSUInteger position = range.location; position < NSMaxRange(range); ++position) {
+            passed[position] = (block(values[reverse ? count - position - 1 : position]) ? YES : NO);
+            passedCount += passed[position];
+        }
+
+        return passedCount;
+    }, ^(NSRange range, NSUInteger outputIndex){
+        for (NSUInteger position = range.location; position < NSMaxRange(range); ++position) {
+            if (passed[position])
+                filteredValues[outputIndex++] = values[reverse ? count - position - 1 : position];
+        }
+    });
+
+    return [PRONumericArray numericArrayWithValuesNoCopy:filteredValues count:filteredCount];
+}
+
+- (double)foldLeftWithValue:(double)startingValue usingBlock:(double (^)(double left, double right))block; {
+    NSParameterAssert(block != nil);
+
+    double value = startingValue;
+
+    for (NSUInteger i = 0; i < m_count; ++i) {
+        value = block(value, m_values[i]);
+    }
+
+    return value;
+}
+
+- (double)foldRightWithValue:(double)startingValue usingBlock:(double (^)(double left, double right))block; {
+    NSParameterAssert(block != nil);
+
+    double value = startingValue;
+
+    for (NSUInteger i = m_count; i > 0; --i) {
+        value = block(m_values[i - 1], value);
+    }
+
+    return value;
+}
+
+- (PRONumericArray *)mapUsingBlock:(double (^)(double value))block; {
+    return [self mapWithOptions:0 usingBlock:block];
+}
+
+- (PRONumericArray *)mapWithOptions:(NSEnumerationOptions)opts usingBlock:(double (^)(double value))block; {
+    NSParameterAssert(block != nil);
+
+    NSUInteger count = m_count;
+    const double *values = m_values;
+
+    BOOL concurrent = (opts & NSEnumerationConcurrent);
+    BOOL reverse = (opts & NSEnumerationReverse);
+
+    double *mappedValues = malloc((count + 1) * sizeof(*mappedValues));
+    if (!PROAssert(mappedValues, @"Could not allocate space for %lu values", (unsigned long)count))
+        return nil;
+
+    PROConcurrentEnumerateChunks(count, (concurrent ? 0 : count), ^(NSUInteger chunkIndex, NSRange range){
+        for (NSUInteger position = range.location; position < NSMaxRange(range); ++position) {
+            mappedValues[position] = block(values[reverse ? count - position - 1 : position]);
+        }
+    });
+
+    return [PRONumericArray numericArrayWithValuesNoCopy:mappedValues count:count];
+}
+
+- (double)reduceWithIdentity:(double)identity usingBlock:(double (^)(double left, double right))block; {
+    NSParameterAssert(block != nil);
+
+    const double *values = m_values;
+
+    NSNumber *result = PROConcurrentReduce(m_count, 0, [NSNumber numberWithDouble:identity], ^ id (NSRange range){
+        double value = identity;
+
+        for (NSUInteger i = range.location; i < NSMaxRange(range); ++i) {
+            value = block(value, values[i]);
+        }
+
+        return [NSNumber numberWithDouble:value];
+    }, ^(NSNumber *left, NSNumber *right){
+        return [NSNumber numberWithDouble:block([left doubleValue], [right doubleValue])];
+    });
+
+    return [result doubleValue];
+}
+
+#pragma mark Aggregate Operations
+
+- (double)sum; {
+    const double *values = m_values;
+    NSUInteger count = m_count;
+
+    // use independent accumulators, so that the additions can be vectorized
+    // without needing to reassociate them
+    double partialSums[4] = { 0, 0, 0, 0 };
+    NSUInteger i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        partialSums[0] += values[i];
+        partialSums[1] += values[i + 1];
+        partialSums[2] += values[i + 2];
+        partialSums[3] += values[i + 3];
+    }
+
+    double sum = (partialSums[0] + partialSums[1]) + (partialSums[2] + partialSums[3]);
+
+    for (; i < count; ++i) {
+        sum += values[i];
+    }
+
+    return sum;
+}
+
+- (double)minimum; {
+    if (!m_count)
+        return NAN;
+
+    const double *values = m_values;
+    NSUInteger count = m_count;
+
+    double minimum = values[0];
+    for (NSUInteger i = 1; i < count; ++i) {
+        minimum = (values[i] < minimum ? values[i] : minimum);
+    }
+
+    return minimum;
+}
+
+- (double)maximum; {
+    if (!m_count)
+        return NAN;
+
+    const double *values = m_values;
+    NSUInteger count = m_count;
+
+    double maximum = values[0];
+    for (NSUInteger i = 1; i < count; ++i) {
+        maximum = (values[i] > maximum ? values[i] : maximum);
+    }
+
+    return maximum;
+}
+
+- (PRONumericArray *)prefixSums; {
+    const double *values = m_values;
+    NSUInteger count = m_count;
+
+    double *sums = malloc((count + 1) * sizeof(*sums));
+    if (!PROAssert(sums, @"Could not allocate space for %lu values", (unsigned long)count))
+        return nil;
+
+    double sum = 0;
+    for (NSUInteger i = 0; i < count; ++i) {
+        sum += values[i];
+        sums[i] = sum;
+    }
+
+    return [PRONumericArray numericArrayWithValuesNoCopy:sums count:count];
+}
+
+- (PRONumericArray *)numericArrayByAddingValue:(double)value; {
+    const double * restrict values = m_values;
+    NSUInteger count = m_count;
+
+    double * restrict results = malloc((count + 1) * sizeof(*results));
+    if (!PROAssert(results, @"Could not allocate space for %lu values", (unsigned long)count))
+        return nil;
+
+    for (NSUInteger i = 0; i < count; ++i) {
+        results[i] = values[i] + value;
+    }
+
+    return [PRONumericArray numericArrayWithValuesNoCopy:results count:count];
+}
+
+- (PRONumericArray *)numericArrayByMultiplyingByValue:(double)value; {
+    const double * restrict values = m_values;
+    NSUInteger count = m_count;
+
+    double * restrict results = malloc((count + 1) * sizeof(*results));
+    if (!PROAssert(results, @"Could not allocate space for %lu values", (unsigned long)count))
+        return nil;
+
+    for (NSUInteger i = 0; i < count; ++i) {
+        results[i] = values[i] * value;
+    }
+
+    return [PRONumericArray numericArrayWithValuesNoCopy:results count:count];
+}
+
+- (PRONumericArray *)filterValuesFromMinimum:(double)minimum toMaximum:(double)maximum; {
+    const double * restrict values = m_values;
+    NSUInteger count = m_count;
+
+    double * restrict results = malloc((count + 1) * sizeof(*results));
+    if (!PROAssert(results, @"Could not allocate space for %lu values", (unsigned long)count))
+        return nil;
+
+    NSUInteger resultCount = 0;
+
+    for (NSUInteger i = 0; i < count; ++i) {
+        double value = values[i];
+
+        // always store the value, but only advance past it if it's in range,
+        // which avoids an unpredictable branch
+        results[resultCount] = value;
+        resultCount += (value >= minimum && value <= maximum);
+    }
+
+    return [PRONumericArray numericArrayWithValuesNoCopy:results count:resultCount];
+}
+
+#pragma mark NSCopying
+
+- (id)copyWithZone:(NSZone *)zone {
+    // numeric arrays are immutable
+    return self;
+}
+
+#pragma mark NSObject overrides
+
+- (NSUInteger)hash {
+    return m_count;
+}
+
+- (BOOL)isEqual:(PRONumericArray *)numericArray {
+    if (self == numericArray)
+        return YES;
+
+    if (![numericArray isKindOfClass:[PRONumericArray class]])
+        return NO;
+
+    if (numericArray.count != m_count)
+        return NO;
+
+    const double *otherValues = numericArray.values;
+    for (NSUInteger i = 0; i < m_count; ++i) {
+        if (m_values[i] != otherValues[i])
+            return NO;
+    }
+
+    return YES;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p>( count = %lu, values = %@ )", [self class], (__bridge void *)self, (unsigned long)m_count, [[self array] componentsJoinedByString:@", "]];
+}
+
+@end
@@ -0,0 +1,137 @@
+//
+//  PROSearchIndex.h
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * An immutable index over an array, for answering many subarray queries against
+ * the same array.
+ *
+ * Building the index takes time and space linear in the size of the indexed
+ * array. Afterward, each query takes time linear in the size of the probe array
+ * only, rather than redoing the work of
+ * `-[NSArray longestSubarrayCommonWithArray:]` each time.
+ *
+ * Search indexes are never mutated after initialization, so they can be queried
+ * from multiple threads at once.
+ */
+@interface PROSearchIndex : NSObject <NSCopying>
+
+/**
+ * @name Initialization
+ */
+
+/**
+ * Returns a search index over the given array, which compares objects with
+ * `isEqual:`.
+ *
+ * @param array The array to index.
+ */
++ (id)searchIndexWithArray:(NSArray *)array;
+
+/**
+ * Initializes the receiver with the given array, comparing objects with
+ * `isEqual:`.
+ *
+ * @param array The array to index.
+ */
+- (id)initWithArray:(NSArray *)array;
+
+/**
+ * Initializes the receiver with the given array.
+ *
+ * This is the designated initializer.
+ *
+ * @param array The array to index.
+ * @param comparesIdentity Whether to compare objects with pointer equality,
+ * instead of `isEqual:`.
+ */
+- (id)initWithArray:(NSArray *)array comparesIdentity:(BOOL)comparesIdentity;
+
+/**
+ * @name Index Attributes
+ */
+
+/**
+ * The array which was indexed.
+ */
+@property (nonatomic, copy, readonly) NSArray *array;
+
+/**
+ * Whether objects are compared with pointer equality, instead of `isEqual:`.
+ */
+@property (nonatomic, readonly) BOOL comparesIdentity;
+
+/**
+ * @name Searching
+ */
+
+/**
+ * Returns whether the given subarray occurs anywhere in <array>.
+ *
+ * An empty subarray is always considered to occur.
+ *
+ * @param subarray The subarray to search for.
+ */
+- (BOOL)containsSubarray:(NSArray *)subarray;
+
+/**
+ * Returns the number of times that the given subarray occurs in <array>,
+ * including overlapping occurrences.
+ *
+ * @param subarray The subarray to search for.
+ */
+- (NSUInteger)countOfSubarray:(NSArray *)subarray;
+
+/**
+ * Returns the range of the first occurrence of the given subarray in <array>.
+ *
+ * If the subarray does not occur, the `location` of the returned range will be
+ * `NSNotFound`.
+ *
+ * @param subarray The subarray to search for.
+ */
+- (NSRange)rangeOfSubarray:(NSArray *)subarray;
+
+/**
+ * Invokes <longestSubarrayCommonWithArray:rangeInArray:rangeInIndexedArray:>
+ * with `NULL` range pointers.
+ */
+- (NSArray *)longestSubarrayCommonWithArray:(NSArray *)array;
+
+/**
+ * Returns the longest subarray that the given array has in common with <array>,
+ * or `nil` if the two arrays have nothing in common.
+ *
+ * If there are multiple common subarrays of the longest length, the one which
+ * ends first in `array` is returned, and its range in <array> is that of its
+ * first occurrence.
+ *
+ * @param array The array to compare with the indexed array.
+ * @param rangeInArray If not `NULL`, this will be set to the range in `array`
+ * at which the returned subarray exists. If this method returns `nil`, the
+ * `location` of the range will be `NSNotFound`.
+ * @param rangeInIndexedArray If not `NULL`, this will be set to the range in
+ * <array> at which the returned subarray exists. If this method returns `nil`,
+ * the `location` of the range will be `NSNotFound`.
+ */
+- (NSArray *)longestSubarrayCommonWithArray:(NSArray *)array rangeInArray:(NSRangePointer)rangeInArray rangeInIndexedArray:(NSRangePointer)rangeInIndexedArray;
+
+/**
+ * Invokes <longestSubarrayCommonWithArray:> for each array in `arrays`,
+ * according to the semantics of `opts`, and returns an array of the results in
+ * the same order. For any array which has nothing in common with <array>, the
+ * corresponding result is `NSNull`.
+ *
+ * @param arrays The arrays to compare with the indexed array.
+ * @param opts A mask of `NSEnumerationOptions` to apply when querying. With
+ * `NSEnumerationConcurrent`, the arrays are compared concurrently.
+ */
+- (NSArray *)longestSubarraysCommonWithArrays:(NSArray *)arrays options:(NSEnumerationOptions)opts;
+
+@end
@@ -0,0 +1,538 @@
+//
+//  PROSearchIndex.m
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import "PROSearchIndex.h"
+#import "EXTScope.h"
+#import "NSArray+HigherOrderAdditions.h"
+#import "PROAssert.h"
+
+/**
+ * A transition between two states of a <PROSuffixAutomaton>.
+ */
+typedef struct {
+    /**
+     * The state that this transition leaves from.
+     */
+    NSUInteger source;
+
+    /**
+     * The symbol that this transition is taken upon.
+     */
+    NSUInteger symbol;
+
+    /**
+     * The state that this transition leads to.
+     */
+    NSUInteger target;
+
+    /**
+     * The index of the next transition leaving from the same state, or
+     * `NSNotFound` if this is the last one.
+     */
+    NSUInteger nextTransition;
+} PROSuffixAutomatonTransition;
+
+/**
+ * A state of a <PROSuffixAutomaton>, which represents a set of substrings that
+ * all end at the same positions.
+ */
+typedef struct {
+    /**
+     * The length of the longest substring represented by this state.
+     */
+    NSUInteger length;
+
+    /**
+     * The state representing the longest suffix of this state's substrings
+     * which ends at other positions as well, or `NSNotFound` for the initial
+     * state.
+     */
+    NSUInteger suffixLink;
+
+    /**
+     * The index at which the first occurrence of this state's substrings ends.
+     */
+    NSUInteger firstEnd;
+
+    /**
+     * The index of the first transition leaving from this state, or
+     * `NSNotFound` if there are none.
+     */
+    NSUInteger firstTransition;
+
+    /**
+     * The number of positions at which this state's substrings end, which is
+     * the number of times that each of them occurs.
+     */
+    NSUInteger occurrenceCount;
+} PROSuffixAutomatonState;
+
+/**
+ * A suffix automaton, which recognizes every substring of a sequence of
+ * symbols, and can be built in time linear in the length of that sequence.
+ *
+ * Because the alphabet of symbols may be as large as the sequence itself,
+ * transitions are looked up in a single open-addressed hash table (keyed by the
+ * source state and symbol), rather than in an array for each state.
+ */
+typedef struct {
+    PROSuffixAutomatonState *states;
+    NSUInteger stateCount;
+
+    PROSuffixAutomatonTransition *transitions;
+    NSUInteger transitionCount;
+
+    /**
+     * The hash table of transitions. Each bucket contains one more than the
+     * index of a transition, or zero if the bucket is empty.
+     */
+    NSUInteger *buckets;
+
+    /**
+     * One less than the number of buckets, which is always a power of two.
+     */
+    NSUInteger bucketMask;
+} PROSuffixAutomaton;
+
+/**
+ * Returns the starting bucket for the transition from `state` upon `symbol`.
+ */
+static NSUInteger bucketForTransition (const PROSuffixAutomaton *automaton, NSUInteger state, NSUInteger symbol) {
+    uint64_t hash = ((uint64_t)state * 0x9E3779B97F4A7C15ULL) ^ ((uint64_t)symbol * 0xC2B2AE3D27D4EB4FULL);
+    hash ^= hash >> 29;
+
+    return (NSUInteger)hash & automaton->bucketMask;
+}
+
+/**
+ * Returns the index of the transition from `state` upon `symbol`, or
+ * `NSNotFound` if there is no such transition.
+ */
+static NSUInteger findTransition (const PROSuffixAutomaton *automaton, NSUInteger state, NSUInteger symbol) {
+    NSUInteger bucket = bucketForTransition(automaton, state, symbol);
+
+    for (;;) {
+        NSUInteger entry = automaton->buckets[bucket];
+        if (!entry)
+            return NSNotFound;
+
+        const PROSuffixAutomatonTransition *transition = automaton->transitions + entry - 1;
+        if (transition->source == state && transition->symbol == symbol)
+            return entry - 1;
+
+        bucket = (bucket + 1) & automaton->bucketMask;
+    }
+}
+
+/**
+ * Adds a transition from `source` upon `symbol` to `target`, which must not
+ * already exist.
+ */
+static void addTransition (PROSuffixAutomaton *automaton, NSUInteger source, NSUInteger symbol, NSUInteger target) {
+    NSUInteger index = automaton->transitionCount++;
+
+    automaton->transitions[index] = (PROSuffixAutomatonTransition){
+        .source = source,
+        .symbol = symbol,
+        .target = target,
+        .nextTransition = automaton->states[source].firstTransition
+    };
+
+    automaton->states[source].firstTransition = index;
+
+    NSUInteger bucket = bucketForTransition(automaton, source, symbol);
+    while (automaton->buckets[bucket]) {
+        bucket = (bucket + 1) & automaton->bucketMask;
+    }
+
+    automaton->buckets[bucket] = index + 1;
+}
+
+/**
+ * Frees the memory used by `automaton`.
+ */
+static void destroySuffixAutomaton (PROSuffixAutomaton *automaton) {
+    free(automaton->states);
+    free(automaton->transitions);
+    free(automaton->buckets);
+}
+
+/**
+ * Initializes `automaton` to recognize every substring of `symbols`, returning
+ * whether it could be built.
+ *
+ * If this function returns `YES`, the automaton must later be destroyed with
+ * <destroySuffixAutomaton>.
+ */
+static BOOL buildSuffixAutomaton (PROSuffixAutomaton *automaton, const NSUInteger *symbols, NSUInteger count) {
+    // a suffix automaton has at most 2n states and 3n transitions
+    NSUInteger maximumStates = count * 2 + 1;
+    NSUInteger maximumTransitions = count * 3 + 1;
+
+    NSUInteger bucketCount = 16;
+    while (bucketCount < maximumTransitions * 2) {
+        bucketCount *= 2;
+    }
+
+    *automaton = (PROSuffixAutomaton){
+        .states = malloc(maximumStates * sizeof(PROSuffixAutomatonState)),
+        .transitions = malloc(maximumTransitions * sizeof(PROSuffixAutomatonTransition)),
+        .buckets = calloc(bucketCount, sizeof(NSUInteger)),
+        .bucketMask = bucketCount - 1
+    };
+
+    if (!PROAssert(automaton->states && automaton->transitions && automaton->buckets, @"Could not allocate space for a suffix automaton of %lu symbols", (unsigned long)count)) {
+        destroySuffixAutomaton(automaton);
+        return NO;
+    }
+
+    PROSuffixAutomatonState *states = automaton->states;
+
+    states[0] = (PROSuffixAutomatonState){
+        .length = 0,
+        .suffixLink = NSNotFound,
+        .firstEnd = NSNotFound,
+        .firstTransition = NSNotFound,
+        .occurrenceCount = 0
+    };
+
+    automaton->stateCount = 1;
+
+    // the state representing the entire sequence so far
+    NSUInteger lastState = 0;
+
+    for (NSUInteger index = 0; index < count; ++index) {
+        NSUInteger symbol = symbols[index];
+
+        NSUInteger newState = automaton->stateCount++;
+        states[newState] = (PROSuffixAutomatonState){
+            .length = states[lastState].length + 1,
+            .suffixLink = 0,
+            .firstEnd = index,
+            .firstTransition = NSNotFound,
+            .occurrenceCount = 1
+        };
+
+        // every suffix without a transition upon this symbol gets one to the new
+        // state
+        NSUInteger state = lastState;
+        while (state != NSNotFound && findTransition(automaton, state, symbol) == NSNotFound) {
+            addTransition(automaton, state, symbol, newState);
+            state = states[state].suffixLink;
+        }
+
+        if (state != NSNotFound) {
+            NSUInteger nextState = automaton->transitions[findTransition(automaton, state, symbol)].target;
+
+            if (states[state].length + 1 == states[nextState].length) {
+                states[newState].suffixLink = nextState;
+            } else {
+                // 'nextState' represents substrings which now end at
+                // different positions, so split off the shorter ones into
+                // a clone
+                NSUInteger clone = automaton->stateCount++;
+                states[clone] = (PROSuffixAutomatonState){
+                    .length = states[state].length + 1,
+                    .suffixLink = states[nextState].suffixLink,
+                    .firstEnd = states[nextState].firstEnd,
+                    .firstTransition = NSNotFound,
+                    .occurrenceCount = 0
+                };
+
+                for (NSUInteger transition = states[nextState].firstTransition; transition != NSNotFound; transition = automaton->transitions[transition].nextTransition) {
+                    addTransition(automaton, clone, automaton->transitions[transition].symbol, automaton->transitions[transition].target);
+                }
+
+                while (state != NSNotFound) {
+                    NSUInteger transition = findTransition(automaton, state, symbol);
+                    if (transition == NSNotFound || automaton->transitions[transition].target != nextState)
+                        break;
+
+                    automaton->transitions[transition].target = clone;
+                    state = states[state].suffixLink;
+                }
+
+                states[nextState].suffixLink = clone;
+                states[newState].suffixLink = clone;
+            }
+        }
+
+        lastState = newState;
+    }
+
+    // every position at which a state's substrings end is also an ending
+    // position for the substrings of its suffix link, so accumulate the counts
+    // from the longest states to the shortest (sorting by length with
+    // a counting sort)
+    NSUInteger stateCount = automaton->stateCount;
+
+    NSUInteger *lengthCounts = calloc(count + 1, sizeof(*lengthCounts));
+    NSUInteger *statesByLength = malloc(stateCount * sizeof(*statesByLength));
+
+    @onExit {
+        free(lengthCounts);
+        free(statesByLength);
+    };
+
+    if (!PROAssert(lengthCounts && statesByLength, @"Could not allocate space to sort %lu states", (unsigned long)stateCount)) {
+        destroySuffixAutomaton(automaton);
+        return NO;
+    }
+
+    for (NSUInteger state = 0; state < stateCount; ++state) {
+        ++lengthCounts[states[state].length];
+    }
+
+    for (NSUInteger length = 1; length <= count; ++length) {
+        lengthCounts[length] += lengthCounts[length - 1];
+    }
+
+    for (NSUInteger state = stateCount; state > 0; --state) {
+        statesByLength[--lengthCounts[states[state - 1].length]] = state - 1;
+    }
+
+    for (NSUInteger i = stateCount; i > 1; --i) {
+        NSUInteger state = statesByLength[i - 1];
+        states[states[state].suffixLink].occurrenceCount += states[state].occurrenceCount;
+    }
+
+    return YES;
+}
+
+@interface PROSearchIndex () {
+    /**
+     * Maps each distinct object in <array> to a unique symbol, using either
+     * `-hash` and `-isEqual:` or pointer identity.
+     */
+    CFMutableDictionaryRef m_symbolsByObject;
+
+    /**
+     * A suffix automaton built over the symbols of <array>.
+     */
+    PROSuffixAutomaton m_automaton;
+}
+
+/**
+ * Returns the automaton state reached by following the symbols of `subarray`
+ * from the initial state, or `NSNotFound` if `subarray` does not occur in
+ * <array>.
+ */
+- (NSUInteger)stateForSubarray:(NSArray *)subarray;
+@end
+
+@implementation PROSearchIndex
+
+#pragma mark Properties
+
+@synthesize array = m_array;
+@synthesize comparesIdentity = m_comparesIdentity;
+
+#pragma mark Lifecycle
+
++ (id)searchIndexWithArray:(NSArray *)array; {
+    return [[self alloc] initWithArray:array];
+}
+
+- (id)init; {
+    return [self initWithArray:[NSArray array]];
+}
+
+- (id)initWithArray:(NSArray *)array; {
+    return [self initWithArray:array comparesIdentity:NO];
+}
+
+- (id)initWithArray:(NSArray *)array comparesIdentity:(BOOL)comparesIdentity; {
+    NSParameterAssert(array != nil);
+
+    self = [super init];
+    if (!self)
+        return nil;
+
+    m_array = [array copy];
+    m_comparesIdentity = comparesIdentity;
+    m_symbolsByObject = CFDictionaryCreateMutable(NULL, 0, (comparesIdentity ? NULL : &kCFTypeDictionaryKeyCallBacks), NULL);
+
+    NSUInteger count = m_array.count;
+
+    NSUInteger *symbols = malloc((count + 1) * sizeof(*symbols));
+    if (!PROAssert(symbols, @"Could not allocate space for %lu integers", (unsigned long)count))
+        return nil;
+
+    @onExit {
+        free(symbols);
+    };
+
+    NSUInteger index = 0;
+    for (id obj in m_array) {
+        const void *symbolValue = NULL;
+
+        if (!CFDictionaryGetValueIfPresent(m_symbolsByObject, (__bridge void *)obj, &symbolValue)) {
+            symbolValue = (const void *)(uintptr_t)CFDictionaryGetCount(m_symbolsByObject);
+            CFDictionarySetValue(m_symbolsByObject, (__bridge void *)obj, symbolValue);
+        }
+
+        symbols[index++] = (NSUInteger)symbolValue;
+    }
+
+    if (!buildSuffixAutomaton(&m_automaton, symbols, count)) {
+        // make sure that -dealloc doesn't free anything twice
+        m_automaton = (PROSuffixAutomaton){ .states = NULL };
+        return nil;
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    destroySuffixAutomaton(&m_automaton);
+
+    if (m_symbolsByObject)
+        CFRelease(m_symbolsByObject);
+}
+
+#pragma mark Searching
+
+- (NSUInteger)stateForSubarray:(NSArray *)subarray; {
+    NSUInteger state = 0;
+
+    for (id obj in subarray) {
+        const void *symbolValue = NULL;
+        if (!CFDictionaryGetValueIfPresent(m_symbolsByObject, (__bridge void *)obj, &symbolValue))
+            return NSNotFound;
+
+        NSUInteger transition = findTransition(&m_automaton, state, (NSUInteger)symbolValue);
+        if (transition == NSNotFound)
+            return NSNotFound;
+
+        state = m_automaton.transitions[transition].target;
+    }
+
+    return state;
+}
+
+- (BOOL)containsSubarray:(NSArray *)subarray; {
+    return [self stateForSubarray:subarray] != NSNotFound;
+}
+
+- (NSUInteger)countOfSubarray:(NSArray *)subarray; {
+    NSUInteger state = [self stateForSubarray:subarray];
+    if (state == NSNotFound)
+        return 0;
+
+    return m_automaton.states[state].occurrenceCount;
+}
+
+- (NSRange)rangeOfSubarray:(NSArray *)subarray; {
+    NSUInteger state = [self stateForSubarray:subarray];
+    if (state == NSNotFound)
+        return NSMakeRange(NSNotFound, 0);
+
+    NSUInteger length = subarray.count;
+    if (!length)
+        return NSMakeRange(0, 0);
+
+    return NSMakeRange(m_automaton.states[state].firstEnd + 1 - length, length);
+}
+
+- (NSArray *)longestSubarrayCommonWithArray:(NSArray *)array; {
+    return [self longestSubarrayCommonWithArray:array rangeInArray:NULL rangeInIndexedArray:NULL];
+}
+
+- (NSArray *)longestSubarrayCommonWithArray:(NSArray *)array rangeInArray:(NSRangePointer)rangeInArray rangeInIndexedArray:(NSRangePointer)rangeInIndexedArray; {
+    if (rangeInArray)
+        *rangeInArray = NSMakeRange(NSNotFound, 0);
+
+    if (rangeInIndexedArray)
+        *rangeInIndexedArray = NSMakeRange(NSNotFound, 0);
+
+    const PROSuffixAutomatonState *states = m_automaton.states;
+
+    // the state and length of the longest suffix of 'array' (up to the current
+    // index) which also appears in the indexed array
+    NSUInteger state = 0;
+    NSUInteger length = 0;
+
+    NSUInteger longestLength = 0;
+    NSUInteger longestEnd = NSNotFound;
+    NSUInteger longestState = NSNotFound;
+
+    NSUInteger index = 0;
+    for (id obj in array) {
+        const void *symbolValue = NULL;
+
+        if (!CFDictionaryGetValueIfPresent(m_symbolsByObject, (__bridge void *)obj, &symbolValue)) {
+            // this object doesn't appear in the indexed array at all
+            state = 0;
+            length = 0;
+            ++index;
+            continue;
+        }
+
+        NSUInteger symbol = (NSUInteger)symbolValue;
+
+        // follow suffix links until a shorter match can be extended (which
+        // will always happen at the initial state, since the symbol appears in
+        // the indexed array)
+        NSUInteger transition;
+        while ((transition = findTransition(&m_automaton, state, symbol)) == NSNotFound) {
+            state = states[state].suffixLink;
+            length = states[state].length;
+        }
+
+        state = m_automaton.transitions[transition].target;
+        ++length;
+
+        if (length > longestLength) {
+            longestLength = length;
+            longestEnd = index;
+            longestState = state;
+        }
+
+        ++index;
+    }
+
+    if (!longestLength)
+        return nil;
+
+    NSRange range = NSMakeRange(longestEnd + 1 - longestLength, longestLength);
+
+    if (rangeInArray)
+        *rangeInArray = range;
+
+    if (rangeInIndexedArray)
+        *rangeInIndexedArray = NSMakeRange(states[longestState].firstEnd + 1 - longestLength, longestLength);
+
+    return [array subarrayWithRange:range];
+}
+
+- (NSArray *)longestSubarraysCommonWithArrays:(NSArray *)arrays options:(NSEnumerationOptions)opts; {
+    // the index is never mutated after initialization, so it can be queried
+    // from multiple threads at once
+    return [arrays mapWithOptions:opts usingBlock:^ id (NSArray *array){
+        NSArray *subarray = [self longestSubarrayCommonWithArray:array];
+        if (!subarray)
+            return [NSNull null];
+
+        return subarray;
+    }];
+}
+
+#pragma mark NSCopying
+
+- (id)copyWithZone:(NSZone *)zone {
+    // search indexes are immutable
+    return self;
+}
+
+#pragma mark NSObject overrides
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p>( count = %lu, states = %lu, comparesIdentity = %i )", [self class], (__bridge void *)self, (unsigned long)m_array.count, (unsigned long)m_automaton.stateCount, (int)m_comparesIdentity];
+}
+
+@end
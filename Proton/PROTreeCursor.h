@@ -0,0 +1,80 @@
+//
+//  PROTreeCursor.h
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * Looks up objects at index paths in a tree of nested arrays, in the same
+ * manner as `-[NSArray objectAtIndexPath:nodeKeyPath:]`, but remembering the
+ * nodes along the most recently used path.
+ *
+ * Each lookup only needs to resolve the part of its index path that differs
+ * from the previous one, so looking up siblings (or any paths in sorted order)
+ * resolves each node and invokes `valueForKeyPath:` on it only once.
+ *
+ * Because nodes are remembered between lookups, the cursor will return stale
+ * results if the tree is modified. After any change to the tree, invoke
+ * <reset> before performing any more lookups.
+ *
+ * This class is not thread-safe.
+ */
+@interface PROTreeCursor : NSObject
+
+/**
+ * @name Initialization
+ */
+
+/**
+ * Initializes the receiver to look up objects in the given tree.
+ *
+ * This is the designated initializer.
+ *
+ * @param rootArray The array at the root of the tree.
+ * @param nodeKeyPath If not `nil`, each object prior to the last index of a path
+ * will receive a `valueForKeyPath:` message with this key path, and the result
+ * will be used for further indexing.
+ */
+- (id)initWithRootArray:(NSArray *)rootArray nodeKeyPath:(NSString *)nodeKeyPath;
+
+/**
+ * @name Tree Attributes
+ */
+
+/**
+ * The array at the root of the tree.
+ */
+@property (nonatomic, strong, readonly) NSArray *rootArray;
+
+/**
+ * The key path used to get from a node to its array of children, or `nil` if
+ * nodes are themselves arrays.
+ */
+@property (nonatomic, copy, readonly) NSString *nodeKeyPath;
+
+/**
+ * @name Retrieving Objects at Index Paths
+ */
+
+/**
+ * Returns the object at the given index path relative to <rootArray>, with the
+ * same semantics as `-[NSArray objectAtIndexPath:nodeKeyPath:]`.
+ *
+ * @param indexPath The index path from which to return an object. If any index
+ * in the path is out of range, or refers to a node without children, `nil` is
+ * returned.
+ */
+- (id)objectAtIndexPath:(NSIndexPath *)indexPath;
+
+/**
+ * Forgets all of the nodes remembered from previous lookups.
+ *
+ * This must be invoked after any change to the tree.
+ */
+- (void)reset;
+
+@end
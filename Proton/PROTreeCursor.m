@@ -0,0 +1,150 @@
+//
+//  PROTreeCursor.m
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import "PROTreeCursor.h"
+#import "PROAssert.h"
+#import "PROKeyPath.h"
+
+@interface PROTreeCursor () {
+    /**
+     * The indexes of the most recently resolved path, of which the first
+     * `m_resolvedNodes.count - 1` are valid.
+     */
+    NSUInteger *m_indexes;
+
+    /**
+     * The capacity of `m_indexes`.
+     */
+    NSUInteger m_indexCapacity;
+}
+
+/**
+ * The arrays of children resolved along the most recently used path, starting
+ * with <rootArray>.
+ *
+ * The array at position `i` is the result of following the first `i` indexes
+ * of `m_indexes` (and applying <nodeKeyPath>). If a node did not resolve to an
+ * array, `NSNull` is stored instead.
+ */
+@property (nonatomic, strong, readonly) NSMutableArray *resolvedNodes;
+
+/**
+ * The <nodeKeyPath>, compiled for repeated use, or `nil` if nodes are
+ * themselves arrays.
+ */
+@property (nonatomic, strong, readonly) PROKeyPath *compiledNodeKeyPath;
+@end
+
+@implementation PROTreeCursor
+
+#pragma mark Properties
+
+@synthesize rootArray = m_rootArray;
+@synthesize nodeKeyPath = m_nodeKeyPath;
+@synthesize resolvedNodes = m_resolvedNodes;
+@synthesize compiledNodeKeyPath = m_compiledNodeKeyPath;
+
+#pragma mark Lifecycle
+
+- (id)init; {
+    return [self initWithRootArray:[NSArray array] nodeKeyPath:nil];
+}
+
+- (id)initWithRootArray:(NSArray *)rootArray nodeKeyPath:(NSString *)nodeKeyPath; {
+    NSParameterAssert(rootArray != nil);
+
+    self = [super init];
+    if (!self)
+        return nil;
+
+    m_rootArray = rootArray;
+    m_nodeKeyPath = [nodeKeyPath copy];
+    m_compiledNodeKeyPath = (nodeKeyPath ? [PROKeyPath keyPathWithString:nodeKeyPath] : nil);
+    m_resolvedNodes = [[NSMutableArray alloc] initWithObjects:rootArray, nil];
+
+    return self;
+}
+
+- (void)dealloc {
+    free(m_indexes);
+}
+
+#pragma mark Retrieving Objects at Index Paths
+
+- (id)objectAtIndexPath:(NSIndexPath *)indexPath; {
+    NSParameterAssert(indexPath);
+
+    NSUInteger length = indexPath.length;
+    if (!length)
+        return self.rootArray;
+
+    if (length > m_indexCapacity) {
+        NSUInteger *newIndexes = realloc(m_indexes, length * sizeof(*newIndexes));
+        if (!PROAssert(newIndexes, @"Could not allocate space for %lu indexes", (unsigned long)length))
+            return nil;
+
+        m_indexes = newIndexes;
+        m_indexCapacity = length;
+    }
+
+    NSUInteger indexes[length];
+    [indexPath getIndexes:indexes];
+
+    NSMutableArray *resolvedNodes = self.resolvedNodes;
+
+    // find how much of the previous path can be reused, not counting the last
+    // index (which never needs to be resolved into a node)
+    NSUInteger resolvedDepth = MIN(resolvedNodes.count - 1, length - 1);
+    NSUInteger commonDepth = 0;
+
+    while (commonDepth < resolvedDepth && m_indexes[commonDepth] == indexes[commonDepth]) {
+        ++commonDepth;
+    }
+
+    [resolvedNodes removeObjectsInRange:NSMakeRange(commonDepth + 1, resolvedNodes.count - commonDepth - 1)];
+
+    id node = [resolvedNodes lastObject];
+    for (NSUInteger depth = commonDepth; depth + 1 < length; ++depth) {
+        id child = nil;
+
+        if ([node isKindOfClass:[NSArray class]] && indexes[depth] < [node count]) {
+            child = [node objectAtIndex:indexes[depth]];
+
+            if (self.compiledNodeKeyPath)
+                child = [self.compiledNodeKeyPath valueForObject:child];
+        }
+
+        // remember paths that lead nowhere, so their descendants don't need
+        // to be resolved again
+        if (![child isKindOfClass:[NSArray class]])
+            child = [NSNull null];
+
+        node = child;
+
+        m_indexes[depth] = indexes[depth];
+        [resolvedNodes addObject:node];
+    }
+
+    if (![node isKindOfClass:[NSArray class]] || indexes[length - 1] >= [node count])
+        return nil;
+
+    return [node objectAtIndex:indexes[length - 1]];
+}
+
+- (void)reset; {
+    NSMutableArray *resolvedNodes = self.resolvedNodes;
+    [resolvedNodes removeObjectsInRange:NSMakeRange(1, resolvedNodes.count - 1)];
+}
+
+#pragma mark NSObject overrides
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p>( nodeKeyPath = %@, depth = %lu )", [self class], (__bridge void *)self, self.nodeKeyPath, (unsigned long)(self.resolvedNodes.count - 1)];
+}
+
+@end
@@ -32,12 +32,21 @@
 #import <Proton/PROAssert.h>
 #import <Proton/PROBacktraceFunctions.h>
 #import <Proton/PROBinding.h>
+#import <Proton/PROChangeJournal.h>
+#import <Proton/PROConcurrentFunctions.h>
 #import <Proton/PROCoreDataManager.h>
 #import <Proton/PROFuture.h>
+#import <Proton/PROIndexPath.h>
+#import <Proton/PROKeyPath.h>
 #import <Proton/PROKeyValueCodingMacros.h>
 #import <Proton/PROKeyValueObserver.h>
+#import <Proton/PROLazySequence.h>
 #import <Proton/PROLogging.h>
 #import <Proton/PROManagedObjectController.h>
+#import <Proton/PROMultipleKeyValueObserver.h>
+#import <Proton/PRONumericArray.h>
+#import <Proton/PROSearchIndex.h>
+#import <Proton/PROTreeCursor.h>
 #import <Proton/PROUniqueIdentifier.h>
 #import <Proton/PROViewModel.h>
 
@@ -0,0 +1,146 @@
+//
+//  PROChangeJournalTests.m
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import <Proton/Proton.h>
+
+SpecBegin(PROChangeJournal)
+    __block PROChangeJournal *journal;
+    __block NSMutableDictionary *source;
+    __block NSMutableDictionary *mirror;
+
+    // applies a change to the source, and records it in the journal
+    __block void (^applyChange)(NSString *, NSKeyValueChange, NSIndexSet *, id, id);
+
+    before(^{
+        journal = [[PROChangeJournal alloc] init];
+        expect(journal.count).toEqual(0);
+
+        source = [NSMutableDictionary dictionaryWithObjectsAndKeys:
+            [NSMutableArray arrayWithObjects:@"foo", @"bar", @"fizz", nil], @"array",
+            [NSMutableSet setWithObjects:@"foo", @"bar", nil], @"set",
+            nil
+        ];
+
+        mirror = [NSMutableDictionary dictionaryWithObjectsAndKeys:
+            [[source objectForKey:@"array"] mutableCopy], @"array",
+            [[source objectForKey:@"set"] mutableCopy], @"set",
+            nil
+        ];
+
+        applyChange = [^(NSString *keyPath, NSKeyValueChange kind, NSIndexSet *indexes, id newValue, id oldValue){
+            NSMutableDictionary *changes = [NSMutableDictionary dictionaryWithObject:[NSNumber numberWithUnsignedInteger:kind] forKey:NSKeyValueChangeKindKey];
+
+            if (indexes)
+                [changes setObject:indexes forKey:NSKeyValueChangeIndexesKey];
+
+            if (newValue)
+                [changes setObject:newValue forKey:NSKeyValueChangeNewKey];
+
+            if (oldValue)
+                [changes setObject:oldValue forKey:NSKeyValueChangeOldKey];
+
+            [source applyKeyValueChangeDictionary:changes toKeyPath:keyPath mappingNewObjectsUsingBlock:nil];
+            [journal recordChangeDictionary:changes forKeyPath:keyPath];
+        } copy];
+    });
+
+    it(@"should replay ordered and unordered changes", ^{
+        NSMutableIndexSet *indexes = [NSMutableIndexSet indexSetWithIndex:0];
+        [indexes addIndex:2];
+
+        applyChange(@"array", NSKeyValueChangeInsertion, indexes, [NSArray arrayWithObjects:@"a", @"b", nil], nil);
+        applyChange(@"set", NSKeyValueChangeInsertion, nil, [NSSet setWithObject:@"buzz"], nil);
+        applyChange(@"array", NSKeyValueChangeRemoval, [NSIndexSet indexSetWithIndex:1], nil, nil);
+        applyChange(@"array", NSKeyValueChangeReplacement, [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(2, 2)], [NSArray arrayWithObjects:@"c", @"d", nil], nil);
+        applyChange(@"set", NSKeyValueChangeRemoval, nil, nil, [NSSet setWithObject:@"foo"]);
+
+        expect(journal.count).toEqual(5);
+        expect(journal.encodedLength).toBeGreaterThan(0);
+
+        [journal replayOntoObject:mirror mappingNewObjectsUsingBlock:nil];
+        expect(mirror).toEqual(source);
+    });
+
+    it(@"should replay 'setting' changes", ^{
+        applyChange(@"array", NSKeyValueChangeSetting, nil, [NSArray arrayWithObjects:@"a", @"b", nil], nil);
+        applyChange(@"set", NSKeyValueChangeSetting, nil, [NSNull null], nil);
+
+        [journal replayOntoObject:mirror mappingNewObjectsUsingBlock:nil];
+        expect(mirror).toEqual(source);
+    });
+
+    it(@"should map new objects when replaying", ^{
+        [journal recordChange:NSKeyValueChangeInsertion forKeyPath:@"array" indexes:[NSIndexSet indexSetWithIndex:3] newValue:[NSArray arrayWithObject:@"quux"] oldValue:nil];
+
+        [journal replayOntoObject:mirror mappingNewObjectsUsingBlock:^ id (id obj){
+            return [obj uppercaseString];
+        }];
+
+        NSArray *expectedArray = [NSArray arrayWithObjects:@"foo", @"bar", @"fizz", @"QUUX", nil];
+        expect([mirror objectForKey:@"array"]).toEqual(expectedArray);
+    });
+
+    it(@"should replay from a checkpoint", ^{
+        applyChange(@"array", NSKeyValueChangeRemoval, [NSIndexSet indexSetWithIndex:0], nil, nil);
+        [journal replayOntoObject:mirror mappingNewObjectsUsingBlock:nil];
+
+        NSUInteger checkpoint = journal.count;
+        applyChange(@"array", NSKeyValueChangeInsertion, [NSIndexSet indexSetWithIndex:1], [NSArray arrayWithObject:@"a"], nil);
+
+        [journal replayOntoObject:mirror fromCheckpoint:checkpoint mappingNewObjectsUsingBlock:nil];
+        expect(mirror).toEqual(source);
+    });
+
+    it(@"should truncate to a checkpoint", ^{
+        applyChange(@"array", NSKeyValueChangeRemoval, [NSIndexSet indexSetWithIndex:0], nil, nil);
+
+        NSUInteger checkpoint = journal.count;
+        NSUInteger encodedLength = journal.encodedLength;
+
+        [journal recordChange:NSKeyValueChangeInsertion forKeyPath:@"array" indexes:[NSIndexSet indexSetWithIndex:1] newValue:[NSArray arrayWithObject:@"a"] oldValue:nil];
+        [journal recordChange:NSKeyValueChangeInsertion forKeyPath:@"set" indexes:nil newValue:[NSArray arrayWithObject:@"b"] oldValue:nil];
+        expect(journal.count).toEqual(3);
+
+        [journal truncateToCheckpoint:checkpoint];
+        expect(journal.count).toEqual(checkpoint);
+        expect(journal.encodedLength).toEqual(encodedLength);
+
+        [journal replayOntoObject:mirror mappingNewObjectsUsingBlock:nil];
+        expect(mirror).toEqual(source);
+    });
+
+    it(@"should remove changes before a checkpoint", ^{
+        applyChange(@"array", NSKeyValueChangeRemoval, [NSIndexSet indexSetWithIndex:0], nil, nil);
+        applyChange(@"set", NSKeyValueChangeInsertion, nil, [NSSet setWithObject:@"buzz"], nil);
+        [journal replayOntoObject:mirror mappingNewObjectsUsingBlock:nil];
+
+        applyChange(@"array", NSKeyValueChangeInsertion, [NSIndexSet indexSetWithIndex:2], [NSArray arrayWithObject:@"a"], nil);
+
+        [journal removeChangesBeforeCheckpoint:2];
+        expect(journal.count).toEqual(1);
+
+        [journal replayOntoObject:mirror mappingNewObjectsUsingBlock:nil];
+        expect(mirror).toEqual(source);
+
+        [journal removeAllChanges];
+        expect(journal.count).toEqual(0);
+        expect(journal.encodedLength).toEqual(0);
+    });
+
+    it(@"should encode large index sets compactly", ^{
+        NSMutableIndexSet *indexes = [NSMutableIndexSet indexSet];
+        for (NSUInteger i = 0; i < 1000; i += 2) {
+            [indexes addIndex:i];
+        }
+
+        [journal recordChange:NSKeyValueChangeRemoval forKeyPath:@"array" indexes:indexes newValue:nil oldValue:nil];
+
+        // two bytes per range, plus a small header
+        expect(journal.encodedLength < 1100).toBeTruthy();
+    });
+SpecEnd
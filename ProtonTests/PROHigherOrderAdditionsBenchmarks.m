@@ -0,0 +1,364 @@
+//
+//  PROHigherOrderAdditionsBenchmarks.m
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import <Proton/Proton.h>
+#import <mach/mach_time.h>
+
+/*
+ * These benchmarks are skipped unless the PROTON_BENCHMARK environment
+ * variable is set when running the tests. The following variables are also
+ * respected:
+ *
+ *  - PROTON_BENCHMARK_OUTPUT: The path to which JSON results are written.
+ *  Defaults to PROHigherOrderAdditionsBenchmarks.json in the temporary
+ *  directory.
+ *  - PROTON_BENCHMARK_BASELINE: The path of a previous JSON output file. If
+ *  set, any benchmark which has become slower than its baseline (by more than
+ *  the tolerance) fails.
+ *  - PROTON_BENCHMARK_TOLERANCE: The fraction by which a benchmark may be
+ *  slower than its baseline before it is considered a regression. Defaults to
+ *  0.25.
+ *  - PROTON_BENCHMARK_MAXIMUM_COUNT: The largest collection size to benchmark.
+ *  Defaults to 10000000.
+ */
+
+/*
+ * The minimum amount of time to spend repeating a single benchmark, so that
+ * small collections are measured over enough iterations to be meaningful.
+ */
+static const NSTimeInterval PROBenchmarkMinimumDuration = 0.1;
+
+/*
+ * The maximum number of times to repeat a single benchmark.
+ */
+static const NSUInteger PROBenchmarkMaximumIterations = 10;
+
+/*
+ * Benchmarks whose baseline took less time than this are never considered
+ * regressions, since they're dominated by timer and scheduling noise.
+ */
+static const NSTimeInterval PROBenchmarkNoiseFloor = 0.0001;
+
+/**
+ * Performs one of the benchmarked operations on `collection`.
+ *
+ * @param collection The collection to operate upon.
+ * @param opts The enumeration options to pass to the operation.
+ * @param expensive Whether the block passed to the operation should perform
+ * a significant amount of work for each element.
+ * @param dropPercentage The percentage of elements which should be dropped
+ * from the result (for map and filter operations).
+ */
+typedef void (^PROBenchmarkOperation)(id collection, NSEnumerationOptions opts, BOOL expensive, NSUInteger dropPercentage);
+
+/**
+ * Returns the time taken by the fastest of several invocations of `block`.
+ */
+static NSTimeInterval measureBlock (dispatch_block_t block) {
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+
+    NSTimeInterval totalDuration = 0;
+    NSTimeInterval bestDuration = DBL_MAX;
+
+    for (NSUInteger iteration = 0; iteration < PROBenchmarkMaximumIterations && totalDuration < PROBenchmarkMinimumDuration; ++iteration) {
+        @autoreleasepool {
+            uint64_t start = mach_absolute_time();
+            block();
+            uint64_t end = mach_absolute_time();
+
+            NSTimeInterval duration = (NSTimeInterval)(end - start) * timebase.numer / timebase.denom / NSEC_PER_SEC;
+
+            totalDuration += duration;
+            bestDuration = MIN(bestDuration, duration);
+        }
+    }
+
+    return bestDuration;
+}
+
+/**
+ * Simulates the work of a block for the given element, returning a value that
+ * depends on that work (so that it can't be optimized away).
+ */
+static NSUInteger performWork (NSNumber *number, BOOL expensive) {
+    NSUInteger value = [number unsignedIntegerValue];
+
+    if (expensive) {
+        for (NSUInteger i = 0; i < 64; ++i) {
+            value = value * 2654435761U + 1;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * Returns whether the given element should be dropped from the result of
+ * a benchmark.
+ */
+static BOOL shouldDrop (NSNumber *number, BOOL expensive, NSUInteger dropPercentage) {
+    // the work itself will never result in NSNotFound, but the compiler doesn't
+    // know that
+    if (performWork(number, expensive) == NSNotFound)
+        return YES;
+
+    return [number unsignedIntegerValue] % 100 < dropPercentage;
+}
+
+SpecBegin(PROHigherOrderAdditionsBenchmarks)
+    NSDictionary *environment = [[NSProcessInfo processInfo] environment];
+
+    if (![environment objectForKey:@"PROTON_BENCHMARK"])
+        return;
+
+    NSString *outputPath = [environment objectForKey:@"PROTON_BENCHMARK_OUTPUT"] ?: [NSTemporaryDirectory() stringByAppendingPathComponent:@"PROHigherOrderAdditionsBenchmarks.json"];
+    NSString *baselinePath = [environment objectForKey:@"PROTON_BENCHMARK_BASELINE"];
+
+    NSString *toleranceString = [environment objectForKey:@"PROTON_BENCHMARK_TOLERANCE"];
+    double tolerance = (toleranceString ? [toleranceString doubleValue] : 0.25);
+
+    NSString *maximumCountString = [environment objectForKey:@"PROTON_BENCHMARK_MAXIMUM_COUNT"];
+    NSUInteger maximumCount = (maximumCountString ? (NSUInteger)[maximumCountString longLongValue] : 10000000);
+
+    // baseline results, keyed by name
+    NSMutableDictionary *baselineResults = [NSMutableDictionary dictionary];
+
+    if (baselinePath) {
+        NSData *baselineData = [NSData dataWithContentsOfFile:baselinePath];
+        NSDictionary *baseline = (baselineData ? [NSJSONSerialization JSONObjectWithData:baselineData options:0 error:NULL] : nil);
+
+        for (NSDictionary *result in [baseline objectForKey:@"benchmarks"]) {
+            [baselineResults setObject:result forKey:[result objectForKey:@"name"]];
+        }
+    }
+
+    // results of this run, in the order they were measured
+    NSMutableArray *results = [NSMutableArray array];
+
+    /*
+     * Runs every operation against collections of increasing size, created
+     * from arrays of numbers with `collectionBlock`, then writes out all
+     * results so far and returns the names of any benchmarks that regressed.
+     */
+    NSArray *(^runBenchmarks)(NSString *, id (^)(NSArray *), NSDictionary *) = ^ NSArray * (NSString *collectionName, id (^collectionBlock)(NSArray *), NSDictionary *operations){
+        NSMutableArray *regressions = [NSMutableArray array];
+
+        for (NSUInteger count = 100; count <= maximumCount; count *= 10) {
+            @autoreleasepool {
+                NSMutableArray *numbers = [[NSMutableArray alloc] initWithCapacity:count];
+                for (NSUInteger i = 0; i < count; ++i) {
+                    [numbers addObject:[NSNumber numberWithUnsignedInteger:i]];
+                }
+
+                id collection = collectionBlock(numbers);
+
+                for (NSString *operationName in [[operations allKeys] sortedArrayUsingSelector:@selector(compare:)]) {
+                    PROBenchmarkOperation operation = [operations objectForKey:operationName];
+
+                    // folds can't be performed concurrently, and only map and
+                    // filter operations can drop elements
+                    BOOL canBeConcurrent = ![operationName isEqualToString:@"fold"];
+                    BOOL canDrop = [operationName isEqualToString:@"map"] || [operationName isEqualToString:@"filter"];
+
+                    for (NSUInteger concurrent = 0; concurrent <= (canBeConcurrent ? 1 : 0); ++concurrent) {
+                        for (NSUInteger expensive = 0; expensive <= 1; ++expensive) {
+                            NSUInteger dropPercentages[] = { 0, 50, 90 };
+                            NSUInteger dropCount = (canDrop ? sizeof(dropPercentages) / sizeof(*dropPercentages) : 1);
+
+                            for (NSUInteger dropIndex = 0; dropIndex < dropCount; ++dropIndex) {
+                                NSUInteger dropPercentage = dropPercentages[dropIndex];
+                                NSEnumerationOptions opts = (concurrent ? NSEnumerationConcurrent : 0);
+
+                                NSString *name = [NSString stringWithFormat:@"%@/%@/%@/drop%lu/%@/%lu",
+                                    collectionName,
+                                    operationName,
+                                    (expensive ? @"expensive" : @"cheap"),
+                                    (unsigned long)dropPercentage,
+                                    (concurrent ? @"concurrent" : @"serial"),
+                                    (unsigned long)count
+                                ];
+
+                                NSTimeInterval seconds = measureBlock(^{
+                                    operation(collection, opts, (BOOL)expensive, dropPercentage);
+                                });
+
+                                NSDictionary *result = [NSDictionary dictionaryWithObjectsAndKeys:
+                                    name, @"name",
+                                    collectionName, @"collection",
+                                    operationName, @"operation",
+                                    [NSNumber numberWithUnsignedInteger:count], @"count",
+                                    [NSNumber numberWithBool:(BOOL)concurrent], @"concurrent",
+                                    [NSNumber numberWithBool:(BOOL)expensive], @"expensive",
+                                    [NSNumber numberWithUnsignedInteger:dropPercentage], @"dropPercentage",
+                                    [NSNumber numberWithDouble:seconds], @"seconds",
+                                    [NSNumber numberWithDouble:seconds * NSEC_PER_SEC / count], @"nanosecondsPerElement",
+                                    nil
+                                ];
+
+                                [results addObject:result];
+
+                                NSDictionary *baselineResult = [baselineResults objectForKey:name];
+                                if (!baselineResult)
+                                    continue;
+
+                                NSTimeInterval baselineSeconds = [[baselineResult objectForKey:@"seconds"] doubleValue];
+                                if (baselineSeconds >= PROBenchmarkNoiseFloor && seconds > baselineSeconds * (1 + tolerance)) {
+                                    [regressions addObject:[NSString stringWithFormat:@"%@ (%.6fs, baseline %.6fs)", name, seconds, baselineSeconds]];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        NSDictionary *output = [NSDictionary dictionaryWithObject:results forKey:@"benchmarks"];
+        NSData *outputData = [NSJSONSerialization dataWithJSONObject:output options:NSJSONWritingPrettyPrinted error:NULL];
+        [outputData writeToFile:outputPath atomically:YES];
+
+        return regressions;
+    };
+
+    it(@"should not regress for arrays", ^{
+        NSMutableDictionary *operations = [NSMutableDictionary dictionary];
+
+        [operations setObject:[^(NSArray *array, NSEnumerationOptions opts, BOOL expensive, NSUInteger dropPercentage){
+            [array mapWithOptions:opts usingBlock:^ id (NSNumber *number){
+                return (shouldDrop(number, expensive, dropPercentage) ? nil : number);
+            }];
+        } copy] forKey:@"map"];
+
+        [operations setObject:[^(NSArray *array, NSEnumerationOptions opts, BOOL expensive, NSUInteger dropPercentage){
+            [array filterWithOptions:opts usingBlock:^(NSNumber *number){
+                return (BOOL)!shouldDrop(number, expensive, dropPercentage);
+            }];
+        } copy] forKey:@"filter"];
+
+        [operations setObject:[^(NSArray *array, NSEnumerationOptions opts, BOOL expensive, NSUInteger dropPercentage){
+            [array foldLeftWithValue:nil usingBlock:^(id left, NSNumber *right){
+                return (performWork(right, expensive) == NSNotFound ? left : right);
+            }];
+        } copy] forKey:@"fold"];
+
+        [operations setObject:[^(NSArray *array, NSEnumerationOptions opts, BOOL expensive, NSUInteger dropPercentage){
+            // search for an object that doesn't exist, to enumerate everything
+            [array objectsWithOptions:opts maximumCount:1 passingTest:^(NSNumber *number){
+                return (BOOL)(performWork(number, expensive) == NSNotFound);
+            }];
+        } copy] forKey:@"search"];
+
+        NSArray *regressions = runBenchmarks(@"NSArray", ^ id (NSArray *numbers){
+            return numbers;
+        }, operations);
+
+        expect(regressions).toEqual([NSArray array]);
+    });
+
+    it(@"should not regress for ordered sets", ^{
+        NSMutableDictionary *operations = [NSMutableDictionary dictionary];
+
+        [operations setObject:[^(NSOrderedSet *orderedSet, NSEnumerationOptions opts, BOOL expensive, NSUInteger dropPercentage){
+            [orderedSet mapWithOptions:opts usingBlock:^ id (NSNumber *number){
+                return (shouldDrop(number, expensive, dropPercentage) ? nil : number);
+            }];
+        } copy] forKey:@"map"];
+
+        [operations setObject:[^(NSOrderedSet *orderedSet, NSEnumerationOptions opts, BOOL expensive, NSUInteger dropPercentage){
+            [orderedSet filterWithOptions:opts usingBlock:^(NSNumber *number){
+                return (BOOL)!shouldDrop(number, expensive, dropPercentage);
+            }];
+        } copy] forKey:@"filter"];
+
+        [operations setObject:[^(NSOrderedSet *orderedSet, NSEnumerationOptions opts, BOOL expensive, NSUInteger dropPercentage){
+            [orderedSet foldLeftWithValue:nil usingBlock:^(id left, NSNumber *right){
+                return (performWork(right, expensive) == NSNotFound ? left : right);
+            }];
+        } copy] forKey:@"fold"];
+
+        [operations setObject:[^(NSOrderedSet *orderedSet, NSEnumerationOptions opts, BOOL expensive, NSUInteger dropPercentage){
+            [orderedSet objectsWithOptions:opts maximumCount:1 passingTest:^(NSNumber *number){
+                return (BOOL)(performWork(number, expensive) == NSNotFound);
+            }];
+        } copy] forKey:@"search"];
+
+        NSArray *regressions = runBenchmarks(@"NSOrderedSet", ^ id (NSArray *numbers){
+            return [NSOrderedSet orderedSetWithArray:numbers];
+        }, operations);
+
+        expect(regressions).toEqual([NSArray array]);
+    });
+
+    it(@"should not regress for sets", ^{
+        NSMutableDictionary *operations = [NSMutableDictionary dictionary];
+
+        [operations setObject:[^(NSSet *set, NSEnumerationOptions opts, BOOL expensive, NSUInteger dropPercentage){
+            [set mapWithOptions:opts usingBlock:^ id (NSNumber *number){
+                return (shouldDrop(number, expensive, dropPercentage) ? nil : number);
+            }];
+        } copy] forKey:@"map"];
+
+        [operations setObject:[^(NSSet *set, NSEnumerationOptions opts, BOOL expensive, NSUInteger dropPercentage){
+            [set filterWithOptions:opts usingBlock:^(NSNumber *number){
+                return (BOOL)!shouldDrop(number, expensive, dropPercentage);
+            }];
+        } copy] forKey:@"filter"];
+
+        [operations setObject:[^(NSSet *set, NSEnumerationOptions opts, BOOL expensive, NSUInteger dropPercentage){
+            [set foldWithValue:nil usingBlock:^(id left, NSNumber *right){
+                return (performWork(right, expensive) == NSNotFound ? left : right);
+            }];
+        } copy] forKey:@"fold"];
+
+        [operations setObject:[^(NSSet *set, NSEnumerationOptions opts, BOOL expensive, NSUInteger dropPercentage){
+            [set objectsWithOptions:opts maximumCount:1 passingTest:^(NSNumber *number){
+                return (BOOL)(performWork(number, expensive) == NSNotFound);
+            }];
+        } copy] forKey:@"search"];
+
+        NSArray *regressions = runBenchmarks(@"NSSet", ^ id (NSArray *numbers){
+            return [NSSet setWithArray:numbers];
+        }, operations);
+
+        expect(regressions).toEqual([NSArray array]);
+    });
+
+    it(@"should not regress for dictionaries", ^{
+        NSMutableDictionary *operations = [NSMutableDictionary dictionary];
+
+        [operations setObject:[^(NSDictionary *dictionary, NSEnumerationOptions opts, BOOL expensive, NSUInteger dropPercentage){
+            [dictionary mapValuesWithOptions:opts usingBlock:^ id (id key, NSNumber *value){
+                return (shouldDrop(value, expensive, dropPercentage) ? nil : value);
+            }];
+        } copy] forKey:@"map"];
+
+        [operations setObject:[^(NSDictionary *dictionary, NSEnumerationOptions opts, BOOL expensive, NSUInteger dropPercentage){
+            [dictionary filterEntriesWithOptions:opts usingBlock:^(id key, NSNumber *value){
+                return (BOOL)!shouldDrop(value, expensive, dropPercentage);
+            }];
+        } copy] forKey:@"filter"];
+
+        [operations setObject:[^(NSDictionary *dictionary, NSEnumerationOptions opts, BOOL expensive, NSUInteger dropPercentage){
+            [dictionary foldEntriesWithValue:nil usingBlock:^(id left, id rightKey, NSNumber *rightValue){
+                return (performWork(rightValue, expensive) == NSNotFound ? left : rightValue);
+            }];
+        } copy] forKey:@"fold"];
+
+        [operations setObject:[^(NSDictionary *dictionary, NSEnumerationOptions opts, BOOL expensive, NSUInteger dropPercentage){
+            [dictionary keysOfEntriesWithOptions:opts maximumCount:1 passingTest:^(id key, NSNumber *value){
+                return (BOOL)(performWork(value, expensive) == NSNotFound);
+            }];
+        } copy] forKey:@"search"];
+
+        NSArray *regressions = runBenchmarks(@"NSDictionary", ^ id (NSArray *numbers){
+            return [NSDictionary dictionaryWithObjects:numbers forKeys:numbers];
+        }, operations);
+
+        expect(regressions).toEqual([NSArray array]);
+    });
+SpecEnd
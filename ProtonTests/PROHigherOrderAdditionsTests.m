@@ -7,6 +7,7 @@
 //
 
 #import <Proton/Proton.h>
+#import <libkern/OSAtomic.h>
 
 SpecBegin(PROHigherOrderAdditions)
     describe(@"dictionary", ^{
@@ -67,6 +68,14 @@ SpecBegin(PROHigherOrderAdditions)
                 expect(failedObjects).toEqual(failedDictionary);
             });
 
+            it(@"should partition concurrently in chunks", ^{
+                __block id failedObjects = nil;
+                expect([dictionary filterEntriesWithOptions:NSEnumerationConcurrent grainSize:2 failedEntries:&failedObjects usingBlock:filterBlock]).toEqual(filteredDictionary);
+                expect(failedObjects).toEqual(failedDictionary);
+
+                expect([dictionary filterEntriesWithOptions:NSEnumerationConcurrent grainSize:0 failedEntries:NULL usingBlock:filterBlock]).toEqual(filteredDictionary);
+            });
+
             it(@"should partition in reverse", ^{
                 __block id failedObjects = nil;
                 expect([dictionary filterEntriesWithOptions:NSEnumerationReverse failedEntries:&failedObjects usingBlock:filterBlock]).toEqual(filteredDictionary);
@@ -134,6 +143,11 @@ SpecBegin(PROHigherOrderAdditions)
                 expect([dictionary mapValuesWithOptions:NSEnumerationConcurrent usingBlock:mapBlock]).toEqual(mappedDictionary);
             });
 
+            it(@"should map concurrently in chunks", ^{
+                expect([dictionary mapValuesWithOptions:NSEnumerationConcurrent grainSize:2 usingBlock:mapBlock]).toEqual(mappedDictionary);
+                expect([dictionary mapValuesWithOptions:NSEnumerationConcurrent grainSize:0 usingBlock:mapBlock]).toEqual(mappedDictionary);
+            });
+
             it(@"should map in reverse", ^{
                 expect([dictionary mapValuesWithOptions:NSEnumerationReverse usingBlock:mapBlock]).toEqual(mappedDictionary);
             });
@@ -191,6 +205,29 @@ SpecBegin(PROHigherOrderAdditions)
             });
         });
 
+        describe(@"reducing", ^{
+            id countBlock = ^(NSNumber *soFar, id nextKey, id nextValue){
+                if (![nextValue isKindOfClass:[NSString class]])
+                    return soFar;
+
+                return [NSNumber numberWithUnsignedInteger:[soFar unsignedIntegerValue] + 1];
+            };
+
+            id sumBlock = ^(NSNumber *left, NSNumber *right){
+                return [NSNumber numberWithUnsignedInteger:[left unsignedIntegerValue] + [right unsignedIntegerValue]];
+            };
+
+            NSNumber *zero = [NSNumber numberWithUnsignedInteger:0];
+
+            it(@"should reduce", ^{
+                expect([dictionary reduceEntriesWithIdentity:zero usingBlock:countBlock combiningBlock:sumBlock]).toEqual([NSNumber numberWithUnsignedInteger:4]);
+            });
+
+            it(@"should reduce to identity", ^{
+                expect([[NSDictionary dictionary] reduceEntriesWithIdentity:zero usingBlock:countBlock combiningBlock:sumBlock]).toEqual(zero);
+            });
+        });
+
         describe(@"successful key of entry passing test", ^{
             id testBlock = ^(id key, id value, BOOL *stop){
                 return [value isKindOfClass:[NSNumber class]];
@@ -211,6 +248,43 @@ SpecBegin(PROHigherOrderAdditions)
             });
         });
         
+        describe(@"searching", ^{
+            id stringValueBlock = ^(id key, id value){
+                return [value isKindOfClass:[NSString class]];
+            };
+
+            id nullValueBlock = ^(id key, id value){
+                return [value isEqual:[NSNull null]];
+            };
+
+            id missingValueBlock = ^(id key, id value){
+                return [value isEqual:@"fuzz"];
+            };
+
+            it(@"should find keys of a bounded number of entries", ^{
+                NSSet *keys = [dictionary keysOfEntriesWithMaximumCount:2 passingTest:stringValueBlock];
+                expect(keys.count).toEqual(2);
+
+                [keys enumerateObjectsUsingBlock:^(id key, BOOL *stop){
+                    expect([dictionary objectForKey:key]).toBeKindOf([NSString class]);
+                }];
+
+                expect([dictionary keysOfEntriesWithOptions:NSEnumerationConcurrent maximumCount:10 passingTest:stringValueBlock].count).toEqual(4);
+                expect([dictionary keysOfEntriesWithMaximumCount:0 passingTest:stringValueBlock]).toEqual([NSSet set]);
+            });
+
+            it(@"should test for any, every, or no entry", ^{
+                expect([dictionary anyEntryPassingTest:nullValueBlock]).toBeTruthy();
+                expect([dictionary anyEntryWithOptions:NSEnumerationConcurrent passingTest:missingValueBlock]).toBeFalsy();
+
+                expect([dictionary everyEntryPassingTest:stringValueBlock]).toBeFalsy();
+                expect([[NSDictionary dictionary] everyEntryPassingTest:stringValueBlock]).toBeTruthy();
+
+                expect([dictionary noEntryWithOptions:NSEnumerationConcurrent passingTest:missingValueBlock]).toBeTruthy();
+                expect([dictionary noEntryPassingTest:nullValueBlock]).toBeFalsy();
+            });
+        });
+
         it(@"should not return a key when testing empty dictionary", ^{
             id testBlock = ^(id key, id value, BOOL *stop){
                 return YES;
@@ -335,6 +409,26 @@ SpecBegin(PROHigherOrderAdditions)
                 expect(failedObjects).toEqual(failedSet);
             });
 
+            it(@"should partition concurrently in chunks", ^{
+                __block id failedObjects = nil;
+
+                expect([array filterWithOptions:NSEnumerationConcurrent grainSize:1 failedObjects:&failedObjects usingBlock:filterBlock]).toEqual(filteredArray);
+                expect(failedObjects).toEqual(failedArray);
+
+                expect([orderedSet filterWithOptions:NSEnumerationConcurrent grainSize:1 failedObjects:&failedObjects usingBlock:filterBlock]).toEqual(filteredOrderedSet);
+                expect(failedObjects).toEqual(failedOrderedSet);
+
+                expect([set filterWithOptions:NSEnumerationConcurrent grainSize:1 failedObjects:&failedObjects usingBlock:filterBlock]).toEqual(filteredSet);
+                expect(failedObjects).toEqual(failedSet);
+            });
+
+            it(@"should partition concurrently in chunks in reverse", ^{
+                __block id failedObjects = nil;
+
+                expect([array filterWithOptions:NSEnumerationConcurrent | NSEnumerationReverse grainSize:3 failedObjects:&failedObjects usingBlock:filterBlock]).toEqual(filteredArray.reverseObjectEnumerator.allObjects);
+                expect(failedObjects).toEqual(failedArray.reverseObjectEnumerator.allObjects);
+            });
+
             it(@"should partition in reverse", ^{
                 __block id failedObjects = nil;
 
@@ -406,6 +500,14 @@ SpecBegin(PROHigherOrderAdditions)
                 expect([set mapWithOptions:NSEnumerationConcurrent usingBlock:mapBlock]).toEqual(mappedSet);
             });
 
+            it(@"should map concurrently in chunks", ^{
+                expect([array mapWithOptions:NSEnumerationConcurrent grainSize:1 usingBlock:mapBlock]).toEqual(mappedArray);
+                expect([orderedSet mapWithOptions:NSEnumerationConcurrent grainSize:1 usingBlock:mapBlock]).toEqual(mappedOrderedSet);
+                expect([set mapWithOptions:NSEnumerationConcurrent grainSize:1 usingBlock:mapBlock]).toEqual(mappedSet);
+
+                expect([array mapWithOptions:NSEnumerationConcurrent | NSEnumerationReverse grainSize:3 usingBlock:mapBlock]).toEqual(mappedArray.reverseObjectEnumerator.allObjects);
+            });
+
             it(@"should map in reverse", ^{
                 expect([array mapWithOptions:NSEnumerationReverse usingBlock:mapBlock]).toEqual(mappedArray.reverseObjectEnumerator.allObjects);
                 expect([[orderedSet mapWithOptions:NSEnumerationReverse usingBlock:mapBlock] allObjects]).toEqual(mappedOrderedSet.reverseObjectEnumerator.allObjects);
@@ -464,6 +566,176 @@ SpecBegin(PROHigherOrderAdditions)
             });
         });
 
+        describe(@"grouping", ^{
+            id firstLetterBlock = ^(NSString *str){
+                return [str substringToIndex:1];
+            };
+
+            id lengthBucketBlock = ^ NSUInteger (NSString *str){
+                if ([str isEqualToString:@"foo"])
+                    return NSNotFound;
+
+                return str.length - 1;
+            };
+
+            it(@"should group by key", ^{
+                NSDictionary *expectedArrays = [NSDictionary dictionaryWithObjectsAndKeys:
+                    [NSArray arrayWithObject:@"foo"], @"f",
+                    [NSArray arrayWithObjects:@"bar", @"baz", @"buzz", nil], @"b",
+                    nil
+                ];
+
+                expect([array groupByUsingBlock:firstLetterBlock]).toEqual(expectedArrays);
+                expect([array groupByWithOptions:NSEnumerationConcurrent usingBlock:firstLetterBlock]).toEqual(expectedArrays);
+
+                NSDictionary *expectedSets = [NSDictionary dictionaryWithObjectsAndKeys:
+                    [NSSet setWithObject:@"foo"], @"f",
+                    [NSSet setWithObjects:@"bar", @"baz", @"bozz", nil], @"b",
+                    nil
+                ];
+
+                expect([set groupByWithOptions:NSEnumerationConcurrent usingBlock:firstLetterBlock]).toEqual(expectedSets);
+            });
+
+            it(@"should group in reverse", ^{
+                NSDictionary *groups = [orderedSet groupByWithOptions:NSEnumerationReverse usingBlock:firstLetterBlock];
+                expect([groups objectForKey:@"b"]).toEqual([NSOrderedSet orderedSetWithObjects:@"bizz", @"baz", @"bar", nil]);
+            });
+
+            it(@"should count by key", ^{
+                NSDictionary *expectedCounts = [NSDictionary dictionaryWithObjectsAndKeys:
+                    [NSNumber numberWithUnsignedInteger:1], @"f",
+                    [NSNumber numberWithUnsignedInteger:3], @"b",
+                    nil
+                ];
+
+                expect([array countByUsingBlock:firstLetterBlock]).toEqual(expectedCounts);
+                expect([orderedSet countByWithOptions:NSEnumerationConcurrent usingBlock:firstLetterBlock]).toEqual(expectedCounts);
+                expect([set countByUsingBlock:firstLetterBlock]).toEqual(expectedCounts);
+            });
+
+            it(@"should partition into buckets", ^{
+                NSArray *expectedBuckets = [NSArray arrayWithObjects:
+                    [NSArray array],
+                    [NSArray array],
+                    [NSArray arrayWithObjects:@"bar", @"baz", nil],
+                    [NSArray arrayWithObject:@"buzz"],
+                    nil
+                ];
+
+                expect([array partitionUsingBlock:lengthBucketBlock]).toEqual(expectedBuckets);
+                expect([array partitionWithOptions:NSEnumerationConcurrent usingBlock:lengthBucketBlock]).toEqual(expectedBuckets);
+                expect([[set partitionUsingBlock:lengthBucketBlock] objectAtIndex:3]).toEqual([NSSet setWithObject:@"bozz"]);
+            });
+        });
+
+        describe(@"searching", ^{
+            id prefixBlock = ^(NSString *str){
+                return [str hasPrefix:@"ba"];
+            };
+
+            id missingBlock = ^(NSString *str){
+                return [str isEqualToString:@"fuzz"];
+            };
+
+            it(@"should return a bounded number of objects", ^{
+                expect([array objectsWithMaximumCount:1 passingTest:prefixBlock]).toEqual([NSArray arrayWithObject:@"bar"]);
+                expect([array objectsWithOptions:NSEnumerationReverse maximumCount:1 passingTest:prefixBlock]).toEqual([NSArray arrayWithObject:@"baz"]);
+                expect([array objectsWithOptions:NSEnumerationConcurrent maximumCount:5 passingTest:prefixBlock]).toEqual([NSArray arrayWithObjects:@"bar", @"baz", nil]);
+                expect([array objectsWithMaximumCount:0 passingTest:prefixBlock]).toEqual([NSArray array]);
+
+                expect([orderedSet objectsWithMaximumCount:1 passingTest:prefixBlock]).toEqual([NSOrderedSet orderedSetWithObject:@"bar"]);
+                expect([set objectsWithOptions:NSEnumerationConcurrent maximumCount:5 passingTest:prefixBlock]).toEqual([NSSet setWithObjects:@"bar", @"baz", nil]);
+            });
+
+            it(@"should test for any object", ^{
+                expect([array anyObjectPassingTest:prefixBlock]).toBeTruthy();
+                expect([orderedSet anyObjectWithOptions:NSEnumerationConcurrent passingTest:prefixBlock]).toBeTruthy();
+                expect([set anyObjectWithOptions:NSEnumerationConcurrent passingTest:missingBlock]).toBeFalsy();
+            });
+
+            it(@"should test for every object", ^{
+                expect([array everyObjectPassingTest:prefixBlock]).toBeFalsy();
+                expect([orderedSet everyObjectWithOptions:NSEnumerationConcurrent passingTest:^(NSString *str){
+                    return (BOOL)(str.length == 3 || str.length == 4);
+                }]).toBeTruthy();
+            });
+
+            it(@"should test for no object", ^{
+                expect([array noObjectPassingTest:missingBlock]).toBeTruthy();
+                expect([set noObjectWithOptions:NSEnumerationConcurrent passingTest:prefixBlock]).toBeFalsy();
+            });
+
+            it(@"should stop at the first matches when searching serially", ^{
+                NSMutableSet *numbers = [NSMutableSet set];
+                NSMutableDictionary *numbersByString = [NSMutableDictionary dictionary];
+
+                for (NSUInteger i = 0; i < 100; ++i) {
+                    NSNumber *number = [NSNumber numberWithUnsignedInteger:i];
+
+                    [numbers addObject:number];
+                    [numbersByString setObject:number forKey:[number stringValue]];
+                }
+
+                __block NSUInteger invocationCount = 0;
+
+                expect([numbers anyObjectPassingTest:^(id obj){
+                    ++invocationCount;
+                    return YES;
+                }]).toBeTruthy();
+
+                expect(invocationCount).toEqual(1);
+
+                invocationCount = 0;
+                expect([[numbers objectsWithMaximumCount:2 passingTest:^(id obj){
+                    ++invocationCount;
+                    return YES;
+                }] count]).toEqual(2);
+
+                expect(invocationCount).toEqual(2);
+
+                invocationCount = 0;
+                expect([numbersByString anyEntryPassingTest:^(id key, id value){
+                    ++invocationCount;
+                    return YES;
+                }]).toBeTruthy();
+
+                expect(invocationCount).toEqual(1);
+            });
+        });
+
+        describe(@"selecting", ^{
+            NSComparator lengthComparator = ^(NSString *left, NSString *right){
+                return [[NSNumber numberWithUnsignedInteger:left.length] compare:[NSNumber numberWithUnsignedInteger:right.length]];
+            };
+
+            NSComparator stringComparator = ^(NSString *left, NSString *right){
+                return [left compare:right];
+            };
+
+            it(@"should return the top objects", ^{
+                expect([array objectsWithTopCount:2 usingComparator:stringComparator]).toEqual([NSArray arrayWithObjects:@"bar", @"baz", nil]);
+                expect([array objectsWithTopCount:10 usingComparator:stringComparator]).toEqual([NSArray arrayWithObjects:@"bar", @"baz", @"buzz", @"foo", nil]);
+                expect([array objectsWithTopCount:0 usingComparator:stringComparator]).toEqual([NSArray array]);
+
+                expect([orderedSet objectsWithOptions:NSEnumerationConcurrent topCount:3 usingComparator:stringComparator]).toEqual([NSArray arrayWithObjects:@"bar", @"baz", @"bizz", nil]);
+                expect([set objectsWithTopCount:1 usingComparator:stringComparator]).toEqual([NSArray arrayWithObject:@"bar"]);
+            });
+
+            it(@"should order equal objects stably", ^{
+                expect([array objectsWithTopCount:3 usingComparator:lengthComparator]).toEqual([NSArray arrayWithObjects:@"foo", @"bar", @"baz", nil]);
+                expect([array objectsWithOptions:NSEnumerationReverse topCount:3 usingComparator:lengthComparator]).toEqual([NSArray arrayWithObjects:@"baz", @"bar", @"foo", nil]);
+                expect([array nthObject:1 usingComparator:lengthComparator]).toEqual(@"bar");
+            });
+
+            it(@"should return the nth object", ^{
+                expect([array nthObject:0 usingComparator:stringComparator]).toEqual(@"bar");
+                expect([array nthObject:3 usingComparator:stringComparator]).toEqual(@"foo");
+                expect([orderedSet nthObject:2 usingComparator:stringComparator]).toEqual(@"bizz");
+                expect([set nthObject:1 usingComparator:stringComparator]).toEqual(@"baz");
+            });
+        });
+
         it(@"should not return object passing test when test fails", ^{
             id orderedTestBlock = ^(NSString *str, NSUInteger index, BOOL *stop){
                 return [str hasPrefix:@"quu"];
@@ -532,6 +804,26 @@ SpecBegin(PROHigherOrderAdditions)
             expect([array foldRightWithValue:nil usingBlock:rightFoldBlock]).toBeNil();
             expect([orderedSet foldRightWithValue:nil usingBlock:rightFoldBlock]).toBeNil();
         });
+
+        it(@"should reduce in order", ^{
+            id concatenateBlock = ^(NSString *left, NSString *right){
+                return [left stringByAppendingString:right];
+            };
+
+            expect([array reduceWithIdentity:@"" usingBlock:concatenateBlock]).toEqual(@"foobarbazbuzz");
+            expect([orderedSet reduceWithIdentity:@"" usingBlock:concatenateBlock]).toEqual(@"foobarbazbizz");
+        });
+
+        it(@"should reduce a set", ^{
+            id lengthBlock = ^(id left, id right){
+                NSUInteger leftLength = ([left isKindOfClass:[NSString class]] ? [left length] : [left unsignedIntegerValue]);
+                NSUInteger rightLength = ([right isKindOfClass:[NSString class]] ? [right length] : [right unsignedIntegerValue]);
+
+                return [NSNumber numberWithUnsignedInteger:leftLength + rightLength];
+            };
+
+            expect([set reduceWithIdentity:[NSNumber numberWithUnsignedInteger:0] usingBlock:lengthBlock]).toEqual([NSNumber numberWithUnsignedInteger:13]);
+        });
     });
 
     describe(@"empty collection", ^{
@@ -579,6 +871,176 @@ SpecBegin(PROHigherOrderAdditions)
             expect([[NSArray array] foldRightWithValue:value usingBlock:rightFoldBlock]).toEqual(value);
             expect([[NSOrderedSet orderedSet] foldRightWithValue:value usingBlock:rightFoldBlock]).toEqual(value);
         });
+
+        it(@"should reduce to identity", ^{
+            id value = @"foobar";
+
+            expect([[NSArray array] reduceWithIdentity:value usingBlock:leftFoldBlock]).toEqual(value);
+            expect([[NSOrderedSet orderedSet] reduceWithIdentity:value usingBlock:leftFoldBlock]).toEqual(value);
+            expect([[NSSet set] reduceWithIdentity:value usingBlock:leftFoldBlock]).toEqual(value);
+        });
+    });
+
+    describe(@"large collection", ^{
+        NSMutableArray *numbers = [NSMutableArray array];
+        for (NSUInteger i = 1; i <= 10000; ++i) {
+            [numbers addObject:[NSNumber numberWithUnsignedInteger:i]];
+        }
+
+        id sumBlock = ^(NSNumber *left, NSNumber *right){
+            return [NSNumber numberWithUnsignedInteger:[left unsignedIntegerValue] + [right unsignedIntegerValue]];
+        };
+
+        NSNumber *zero = [NSNumber numberWithUnsignedInteger:0];
+        NSNumber *sum = [NSNumber numberWithUnsignedInteger:50005000];
+
+        it(@"should reduce", ^{
+            expect([numbers reduceWithIdentity:zero usingBlock:sumBlock]).toEqual(sum);
+            expect([[NSOrderedSet orderedSetWithArray:numbers] reduceWithIdentity:zero usingBlock:sumBlock]).toEqual(sum);
+            expect([[NSSet setWithArray:numbers] reduceWithIdentity:zero usingBlock:sumBlock]).toEqual(sum);
+        });
+
+        it(@"should compact sparse results", ^{
+            NSMutableArray *multiples = [NSMutableArray array];
+            for (NSUInteger i = 100; i <= 10000; i += 100) {
+                [multiples addObject:[NSNumber numberWithUnsignedInteger:i]];
+            }
+
+            id multipleBlock = ^(NSNumber *num){
+                return (BOOL)([num unsignedIntegerValue] % 100 == 0);
+            };
+
+            id multipleMapBlock = ^ id (NSNumber *num){
+                return ([num unsignedIntegerValue] % 100 == 0 ? num : nil);
+            };
+
+            expect([numbers filterWithOptions:NSEnumerationConcurrent usingBlock:multipleBlock]).toEqual(multiples);
+            expect([numbers filterWithOptions:NSEnumerationConcurrent | NSEnumerationReverse usingBlock:multipleBlock]).toEqual(multiples.reverseObjectEnumerator.allObjects);
+            expect([numbers mapWithOptions:NSEnumerationConcurrent usingBlock:multipleMapBlock]).toEqual(multiples);
+            expect([numbers mapWithOptions:NSEnumerationReverse usingBlock:multipleMapBlock]).toEqual(multiples.reverseObjectEnumerator.allObjects);
+            expect([[NSOrderedSet orderedSetWithArray:numbers] mapWithOptions:NSEnumerationConcurrent usingBlock:multipleMapBlock]).toEqual([NSOrderedSet orderedSetWithArray:multiples]);
+        });
+
+        it(@"should stop searching once enough objects are found", ^{
+            __block volatile int32_t invocations = 0;
+
+            BOOL found = [numbers anyObjectWithOptions:NSEnumerationConcurrent passingTest:^(NSNumber *num){
+                OSAtomicIncrement32(&invocations);
+                return YES;
+            }];
+
+            expect(found).toBeTruthy();
+            expect(invocations < 10000).toBeTruthy();
+
+            NSArray *firstNumbers = [numbers objectsWithMaximumCount:3 passingTest:^(NSNumber *num){
+                return YES;
+            }];
+
+            expect(firstNumbers).toEqual([numbers subarrayWithRange:NSMakeRange(0, 3)]);
+        });
+
+        it(@"should choose between serial and concurrent enumeration automatically", ^{
+            id doubleBlock = ^(NSNumber *num){
+                return [NSNumber numberWithUnsignedInteger:[num unsignedIntegerValue] * 2];
+            };
+
+            id evenBlock = ^(NSNumber *num){
+                return (BOOL)([num unsignedIntegerValue] % 2 == 0);
+            };
+
+            NSArray *mappedNumbers = [numbers mapUsingBlock:doubleBlock];
+            NSArray *evenNumbers = [numbers filterUsingBlock:evenBlock];
+
+            // run a few times, so that later enumerations use the measured cost
+            for (NSUInteger i = 0; i < 3; ++i) {
+                expect([numbers mapWithOptions:PROEnumerationAutomatic usingBlock:doubleBlock]).toEqual(mappedNumbers);
+                expect([numbers filterWithOptions:PROEnumerationAutomatic usingBlock:evenBlock]).toEqual(evenNumbers);
+                expect([numbers mapWithOptions:PROEnumerationAutomatic | NSEnumerationReverse usingBlock:doubleBlock]).toEqual([[mappedNumbers reverseObjectEnumerator] allObjects]);
+            }
+
+            expect(PROAutomaticEnumerationCostForBlock(doubleBlock) > 0).toBeTruthy();
+            expect(PROAutomaticEnumerationCostForBlock(evenBlock) > 0).toBeTruthy();
+
+            NSSet *set = [NSSet setWithArray:numbers];
+            expect([set filterWithOptions:PROEnumerationAutomatic usingBlock:evenBlock]).toEqual([NSSet setWithArray:evenNumbers]);
+            expect([set mapWithOptions:PROEnumerationAutomatic usingBlock:doubleBlock]).toEqual([NSSet setWithArray:mappedNumbers]);
+
+            NSDictionary *dictionary = [NSDictionary dictionaryWithObjects:numbers forKeys:numbers];
+            NSDictionary *evenEntries = [dictionary filterEntriesWithOptions:PROEnumerationAutomatic usingBlock:^(id key, NSNumber *value){
+                return (BOOL)([value unsignedIntegerValue] % 2 == 0);
+            }];
+
+            expect(evenEntries.count).toEqual(evenNumbers.count);
+        });
+
+        it(@"should select the top objects without sorting", ^{
+            // order the numbers pseudorandomly, so that the selection isn't
+            // working on presorted input
+            NSComparator scrambledComparator = ^ NSComparisonResult (NSNumber *left, NSNumber *right){
+                NSUInteger leftKey = [left unsignedIntegerValue] * 7919 % 10007;
+                NSUInteger rightKey = [right unsignedIntegerValue] * 7919 % 10007;
+
+                if (leftKey < rightKey)
+                    return NSOrderedAscending;
+                else if (leftKey > rightKey)
+                    return NSOrderedDescending;
+                else
+                    return NSOrderedSame;
+            };
+
+            NSArray *sortedNumbers = [numbers sortedArrayUsingComparator:scrambledComparator];
+            NSArray *expectedTop = [sortedNumbers subarrayWithRange:NSMakeRange(0, 50)];
+
+            expect([numbers objectsWithTopCount:50 usingComparator:scrambledComparator]).toEqual(expectedTop);
+            expect([numbers objectsWithOptions:NSEnumerationConcurrent topCount:50 usingComparator:scrambledComparator]).toEqual(expectedTop);
+
+            expect([numbers nthObject:0 usingComparator:scrambledComparator]).toEqual([sortedNumbers objectAtIndex:0]);
+            expect([numbers nthObject:4999 usingComparator:scrambledComparator]).toEqual([sortedNumbers objectAtIndex:4999]);
+            expect([numbers nthObject:9999 usingComparator:scrambledComparator]).toEqual([sortedNumbers lastObject]);
+        });
+
+        it(@"should group, count, and partition concurrently in order", ^{
+            id residueBlock = ^(NSNumber *num){
+                return [NSNumber numberWithUnsignedInteger:[num unsignedIntegerValue] % 3];
+            };
+
+            id residueBucketBlock = ^(NSNumber *num){
+                return [num unsignedIntegerValue] % 3;
+            };
+
+            NSDictionary *groups = [numbers groupByWithOptions:NSEnumerationConcurrent usingBlock:residueBlock];
+            expect(groups).toEqual([numbers groupByUsingBlock:residueBlock]);
+            expect([[groups objectForKey:[NSNumber numberWithUnsignedInteger:0]] count]).toEqual(3333);
+
+            NSDictionary *counts = [numbers countByWithOptions:NSEnumerationConcurrent usingBlock:residueBlock];
+            expect([counts objectForKey:[NSNumber numberWithUnsignedInteger:1]]).toEqual([NSNumber numberWithUnsignedInteger:3334]);
+
+            NSArray *buckets = [numbers partitionWithOptions:NSEnumerationConcurrent usingBlock:residueBucketBlock];
+            expect(buckets).toEqual([numbers partitionUsingBlock:residueBucketBlock]);
+        });
+
+        it(@"should map and filter concurrently in chunks", ^{
+            id evenBlock = ^(NSNumber *num){
+                return (BOOL)([num unsignedIntegerValue] % 2 == 0);
+            };
+
+            id halveOddBlock = ^ id (NSNumber *num){
+                if ([num unsignedIntegerValue] % 2 == 0)
+                    return nil;
+
+                return [NSNumber numberWithUnsignedInteger:[num unsignedIntegerValue] / 2];
+            };
+
+            __block id failedObjects = nil;
+            __block id expectedFailedObjects = nil;
+
+            NSArray *filtered = [numbers filterWithOptions:NSEnumerationConcurrent grainSize:0 failedObjects:&failedObjects usingBlock:evenBlock];
+            expect(filtered).toEqual([numbers filterWithFailedObjects:&expectedFailedObjects usingBlock:evenBlock]);
+            expect(failedObjects).toEqual(expectedFailedObjects);
+
+            NSArray *mapped = [numbers mapWithOptions:NSEnumerationConcurrent grainSize:7 usingBlock:halveOddBlock];
+            expect(mapped).toEqual([numbers mapUsingBlock:halveOddBlock]);
+        });
     });
 
 SpecEnd
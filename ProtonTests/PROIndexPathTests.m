@@ -0,0 +1,112 @@
+//
+//  PROIndexPathTests.m
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import <Proton/Proton.h>
+
+SpecBegin(PROIndexPath)
+    NSUInteger shortIndexes[] = { 3, 1, 4 };
+    NSUInteger longIndexes[] = { 2, 7, 1, 8, 2, 8, 1, 8 };
+
+    PROIndexPath *shortPath = [PROIndexPath indexPathWithIndexes:shortIndexes length:3];
+    PROIndexPath *longPath = [PROIndexPath indexPathWithIndexes:longIndexes length:8];
+
+    it(@"should initialize with indexes", ^{
+        expect(shortPath.length).toEqual(3);
+        expect(longPath.length).toEqual(8);
+
+        for (NSUInteger i = 0; i < 8; ++i) {
+            expect([longPath indexAtPosition:i]).toEqual(longIndexes[i]);
+        }
+
+        expect([PROIndexPath indexPath].length).toEqual(0);
+        expect([[PROIndexPath indexPathWithIndex:5] indexAtPosition:0]).toEqual(5);
+    });
+
+    it(@"should convert to and from NSIndexPath", ^{
+        NSIndexPath *indexPath = [NSIndexPath indexPathWithIndexes:longIndexes length:8];
+
+        expect([longPath indexPath]).toEqual(indexPath);
+        expect([PROIndexPath indexPathWithIndexPath:indexPath]).toEqual(longPath);
+        expect([[PROIndexPath indexPath] indexPath].length).toEqual(0);
+    });
+
+    it(@"should remove indexes from either end", ^{
+        PROIndexPath *path = longPath;
+
+        for (NSUInteger i = 1; i <= 8; ++i) {
+            path = [path indexPathByRemovingFirstIndex];
+            expect(path).toEqual([PROIndexPath indexPathWithIndexes:longIndexes + i length:8 - i]);
+        }
+
+        path = longPath;
+
+        for (NSUInteger i = 1; i <= 8; ++i) {
+            path = [path indexPathByRemovingLastIndex];
+            expect(path).toEqual([PROIndexPath indexPathWithIndexes:longIndexes length:8 - i]);
+        }
+
+        expect([[PROIndexPath indexPath] indexPathByRemovingFirstIndex].length).toEqual(0);
+    });
+
+    it(@"should add indexes to either end", ^{
+        NSUInteger expectedIndexes[] = { 9, 2, 7, 1, 8, 2, 8, 1, 8, 0 };
+        PROIndexPath *expected = [PROIndexPath indexPathWithIndexes:expectedIndexes length:10];
+
+        expect([[longPath indexPathByPrependingIndex:9] indexPathByAddingIndex:0]).toEqual(expected);
+
+        NSUInteger extendedIndexes[] = { 3, 1, 4, 1, 5 };
+        expect([[shortPath indexPathByAddingIndex:1] indexPathByAddingIndex:5]).toEqual([PROIndexPath indexPathWithIndexes:extendedIndexes length:5]);
+    });
+
+    it(@"should share storage between derived paths", ^{
+        PROIndexPath *subpath = [longPath indexPathByRemovingFirstIndex];
+        expect(subpath.indexes == longPath.indexes + 1).toBeTruthy();
+
+        // prepending the same index again should reuse the original slot
+        PROIndexPath *restoredPath = [subpath indexPathByPrependingIndex:2];
+        expect(restoredPath.indexes == longPath.indexes).toBeTruthy();
+        expect(restoredPath).toEqual(longPath);
+
+        // but prepending a different index should not
+        PROIndexPath *changedPath = [subpath indexPathByPrependingIndex:5];
+        expect(changedPath.indexes == longPath.indexes).toBeFalsy();
+        expect([changedPath indexAtPosition:0]).toEqual(5);
+        expect([longPath indexAtPosition:0]).toEqual(2);
+    });
+
+    it(@"should not corrupt paths which share storage", ^{
+        PROIndexPath *firstPath = [longPath indexPathByAddingIndex:3];
+        PROIndexPath *secondPath = [longPath indexPathByAddingIndex:4];
+
+        expect([firstPath indexAtPosition:8]).toEqual(3);
+        expect([secondPath indexAtPosition:8]).toEqual(4);
+    });
+
+    it(@"should compare", ^{
+        PROIndexPath *prefix = [longPath indexPathByRemovingLastIndex];
+
+        expect([prefix compare:longPath]).toEqual(NSOrderedAscending);
+        expect([longPath compare:prefix]).toEqual(NSOrderedDescending);
+        expect([longPath compare:[longPath copy]]).toEqual(NSOrderedSame);
+        expect([longPath compare:shortPath]).toEqual(NSOrderedAscending);
+
+        expect([longPath hash]).toEqual([[PROIndexPath indexPathWithIndexes:longIndexes length:8] hash]);
+    });
+
+    it(@"should look up objects in an array", ^{
+        NSArray *array = [NSArray arrayWithObjects:
+            @"foo",
+            [NSArray arrayWithObjects:@"bar", @"baz", nil],
+            nil
+        ];
+
+        PROIndexPath *path = [[PROIndexPath indexPathWithIndex:1] indexPathByAddingIndex:1];
+        expect([array objectAtIndexes:path.indexes length:path.length nodeKeyPath:nil]).toEqual(@"baz");
+        expect([array objectAtIndexPath:[path indexPath]]).toEqual(@"baz");
+    });
+SpecEnd
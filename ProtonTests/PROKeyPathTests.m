@@ -0,0 +1,117 @@
+//
+//  PROKeyPathTests.m
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import <Proton/Proton.h>
+
+@interface KeyPathTestObject : NSObject
+@property (nonatomic, copy) NSString *name;
+@property (nonatomic, strong) id child;
+@property (nonatomic, assign) NSInteger number;
+@end
+
+SpecBegin(PROKeyPath)
+    __block KeyPathTestObject *object;
+
+    before(^{
+        object = [[KeyPathTestObject alloc] init];
+        object.name = @"foo";
+        object.number = 5;
+
+        object.child = [[KeyPathTestObject alloc] init];
+        [object.child setName:@"bar"];
+        [object.child setChild:[NSMutableDictionary dictionaryWithObject:@"baz" forKey:@"name"]];
+    });
+
+    it(@"should split a string into components", ^{
+        PROKeyPath *keyPath = [PROKeyPath keyPathWithString:@"child.child.name"];
+        expect(keyPath.string).toEqual(@"child.child.name");
+        expect(keyPath.components).toEqual([NSArray arrayWithObjects:@"child", @"child", @"name", nil]);
+    });
+
+    it(@"should cache compiled key paths", ^{
+        PROKeyPath *keyPath = [PROKeyPath keyPathWithString:@"child.name"];
+        expect([PROKeyPath keyPathWithString:[@"child" stringByAppendingKeyPathComponent:@"name"]] == keyPath).toBeTruthy();
+        expect([[PROKeyPath keyPathWithString:@"child"] keyPathByAppendingKeyPathComponent:@"name"]).toEqual(keyPath);
+        expect([[PROKeyPath alloc] initWithString:@"child.name"]).toEqual(keyPath);
+    });
+
+    it(@"should get values", ^{
+        expect([[PROKeyPath keyPathWithString:@"name"] valueForObject:object]).toEqual(@"foo");
+        expect([[PROKeyPath keyPathWithString:@"child.name"] valueForObject:object]).toEqual(@"bar");
+        expect([[PROKeyPath keyPathWithString:@"child.child.name"] valueForObject:object]).toEqual(@"baz");
+
+        // should box scalars
+        expect([[PROKeyPath keyPathWithString:@"number"] valueForObject:object]).toEqual([NSNumber numberWithInteger:5]);
+    });
+
+    it(@"should get values from many classes", ^{
+        PROKeyPath *keyPath = [PROKeyPath keyPathWithString:@"name"];
+
+        for (NSUInteger i = 0; i < 3; ++i) {
+            expect([keyPath valueForObject:object]).toEqual(@"foo");
+            expect([keyPath valueForObject:[[object child] child]]).toEqual(@"baz");
+        }
+    });
+
+    it(@"should return nil for a nil object or intermediate value", ^{
+        PROKeyPath *keyPath = [PROKeyPath keyPathWithString:@"child.child.child.name"];
+        expect([keyPath valueForObject:nil]).toBeNil();
+        expect([keyPath valueForObject:object]).toBeNil();
+    });
+
+    it(@"should set values", ^{
+        [[PROKeyPath keyPathWithString:@"name"] setValue:@"fizz" forObject:object];
+        expect(object.name).toEqual(@"fizz");
+
+        [[PROKeyPath keyPathWithString:@"child.name"] setValue:@"buzz" forObject:object];
+        expect([object.child name]).toEqual(@"buzz");
+
+        [[PROKeyPath keyPathWithString:@"child.child.name"] setValue:@"fuzz" forObject:object];
+        expect([[object.child child] objectForKey:@"name"]).toEqual(@"fuzz");
+
+        [[PROKeyPath keyPathWithString:@"number"] setValue:[NSNumber numberWithInteger:10] forObject:object];
+        expect(object.number).toEqual(10);
+
+        // should not crash
+        [[PROKeyPath keyPathWithString:@"child.child.child.name"] setValue:@"foobar" forObject:object];
+        [[PROKeyPath keyPathWithString:@"name"] setValue:@"foobar" forObject:nil];
+    });
+
+    it(@"should use collection operators", ^{
+        NSArray *array = [NSArray arrayWithObjects:object, object.child, nil];
+        expect([[PROKeyPath keyPathWithString:@"@count"] valueForObject:array]).toEqual([NSNumber numberWithUnsignedInteger:2]);
+        expect([[PROKeyPath keyPathWithString:@"name"] valueForObject:array]).toEqual([NSArray arrayWithObjects:@"foo", @"bar", nil]);
+    });
+
+    it(@"should post KVO notifications when setting", ^{
+        __block NSUInteger changeCount = 0;
+
+        PROKeyValueObserver *observer = [[PROKeyValueObserver alloc]
+            initWithTarget:object
+            keyPath:@"child.name"
+            block:^(NSDictionary *changes){
+                ++changeCount;
+            }
+        ];
+
+        expect(observer).not.toBeNil();
+
+        [[PROKeyPath keyPathWithString:@"child.name"] setValue:@"fizz" forObject:object];
+        expect(changeCount).toEqual(1);
+        expect([object.child name]).toEqual(@"fizz");
+
+        [[PROKeyPath keyPathWithString:@"child"] setValue:[[KeyPathTestObject alloc] init] forObject:object];
+        expect(changeCount).toEqual(2);
+    });
+SpecEnd
+
+@implementation KeyPathTestObject
+@synthesize name = m_name;
+@synthesize child = m_child;
+@synthesize number = m_number;
+@end
@@ -284,6 +284,97 @@ SpecBegin(PROKeyValueObserver)
         });
     });
 
+    describe(@"coalescing changes", ^{
+        __block NSMutableArray *receivedChanges;
+
+        before(^{
+            keyPath = @"foobar";
+            options = NSKeyValueObservingOptionNew | NSKeyValueObservingOptionOld;
+            queue = [[SDQueue alloc] init];
+
+            observedObject = [[KVOTestObject alloc] init];
+            [observedObject setFoobar:@"initial"];
+
+            receivedChanges = [NSMutableArray array];
+
+            // only ever invoked on the serial queue
+            block = ^(NSDictionary *changes){
+                [receivedChanges addObject:changes];
+            };
+
+            weakObserver = observer = [[PROKeyValueObserver alloc]
+                initWithTarget:observedObject
+                keyPath:keyPath
+                options:options
+                block:block
+            ];
+
+            observer.queue = queue;
+            observer.coalescesChanges = YES;
+
+            verifyObserverInitialization();
+        });
+
+        it(@"should deliver pending changes once", ^{
+            // keep the queue busy until all of the changes have been made
+            dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+            [queue runAsynchronously:^{
+                dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+            }];
+
+            for (NSUInteger i = 0; i < 100; ++i) {
+                [observedObject setFoobar:[NSString stringWithFormat:@"%lu", (unsigned long)i]];
+            }
+
+            dispatch_semaphore_signal(semaphore);
+            dispatch_release(semaphore);
+
+            [queue runSynchronously:^{
+                expect(receivedChanges.count).toEqual(1);
+
+                NSDictionary *changes = [receivedChanges lastObject];
+                expect([changes objectForKey:NSKeyValueChangeOldKey]).toEqual(@"initial");
+                expect([changes objectForKey:NSKeyValueChangeNewKey]).toEqual(@"99");
+                expect([[changes objectForKey:PROKeyValueObserverCoalescedChangesKey] count]).toEqual(100);
+            }];
+        });
+
+        it(@"should deliver pending changes after an interval", ^{
+            observer.coalescingInterval = 0.05;
+
+            [observedObject setFoobar:@"foo"];
+            [observedObject setFoobar:@"bar"];
+
+            // wait out the interval without touching the array off the queue
+            __block BOOL delivered = NO;
+            NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:1];
+
+            while (!delivered && [deadline timeIntervalSinceNow] > 0) {
+                [NSThread sleepForTimeInterval:0.01];
+
+                [queue runSynchronously:^{
+                    delivered = (receivedChanges.count > 0);
+                }];
+            }
+
+            [queue runSynchronously:^{
+                expect(receivedChanges.count).toEqual(1);
+
+                NSDictionary *changes = [receivedChanges lastObject];
+                expect([changes objectForKey:NSKeyValueChangeOldKey]).toEqual(@"initial");
+                expect([changes objectForKey:NSKeyValueChangeNewKey]).toEqual(@"bar");
+                expect([[changes objectForKey:PROKeyValueObserverCoalescedChangesKey] count]).toEqual(2);
+            }];
+        });
+
+        it(@"should deliver changes which occur on the queue immediately", ^{
+            [queue runSynchronously:^{
+                [observedObject setFoobar:@"foo"];
+                expect(receivedChanges.count).toEqual(1);
+            }];
+        });
+    });
+
 SpecEnd
 
 @implementation KVOTestObject
@@ -0,0 +1,141 @@
+//
+//  PROLazySequenceTests.m
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import <Proton/Proton.h>
+#import <libkern/OSAtomic.h>
+
+SpecBegin(PROLazySequence)
+    NSArray *array = [NSArray arrayWithObjects:@"foo", @"bar", @"baz", @"buzz", @"fizz", nil];
+
+    id filterBlock = ^(NSString *str){
+        return [str hasPrefix:@"b"];
+    };
+
+    id mapBlock = ^ id (NSString *str){
+        if ([str isEqualToString:@"baz"])
+            return nil;
+
+        return [str stringByAppendingString:@"buzz"];
+    };
+
+    NSArray *filteredAndMappedArray = [NSArray arrayWithObjects:@"barbuzz", @"buzzbuzz", nil];
+
+    it(@"should evaluate to the original collection without any stages", ^{
+        expect([[array lazySequence] array]).toEqual(array);
+        expect([[[NSOrderedSet orderedSetWithArray:array] lazySequence] orderedSet]).toEqual([NSOrderedSet orderedSetWithArray:array]);
+        expect([[[NSSet setWithArray:array] lazySequence] set]).toEqual([NSSet setWithArray:array]);
+    });
+
+    it(@"should be equivalent to filtering and then mapping", ^{
+        PROLazySequence *sequence = [[[array lazySequence] filterUsingBlock:filterBlock] mapUsingBlock:mapBlock];
+
+        expect([sequence array]).toEqual([[array filterUsingBlock:filterBlock] mapUsingBlock:mapBlock]);
+        expect([sequence array]).toEqual(filteredAndMappedArray);
+    });
+
+    it(@"should be equivalent to filtering and then mapping concurrently", ^{
+        PROLazySequence *sequence = [[[[array lazySequence] concurrentSequence] filterUsingBlock:filterBlock] mapUsingBlock:mapBlock];
+
+        expect(sequence.concurrent).toBeTruthy();
+        expect([sequence array]).toEqual(filteredAndMappedArray);
+    });
+
+    it(@"should not modify the receiver when adding stages", ^{
+        PROLazySequence *sequence = [array lazySequence];
+        PROLazySequence *filteredSequence = [sequence filterUsingBlock:filterBlock];
+
+        expect(filteredSequence).not.toEqual(sequence);
+        expect([sequence array]).toEqual(array);
+    });
+
+    it(@"should evaluate multiple times", ^{
+        PROLazySequence *sequence = [[[array lazySequence] mapUsingBlock:mapBlock] takeCount:2];
+
+        NSArray *expectedArray = [NSArray arrayWithObjects:@"foobuzz", @"barbuzz", nil];
+        expect([sequence array]).toEqual(expectedArray);
+        expect([sequence array]).toEqual(expectedArray);
+    });
+
+    it(@"should stop enumerating once a take stage is exhausted", ^{
+        __block NSUInteger invocations = 0;
+
+        PROLazySequence *sequence = [[[array lazySequence] mapUsingBlock:^(NSString *str){
+            ++invocations;
+            return str;
+        }] takeCount:2];
+
+        expect([sequence array]).toEqual([array subarrayWithRange:NSMakeRange(0, 2)]);
+        expect(invocations).toEqual(2);
+    });
+
+    it(@"should apply a take stage in order when concurrent", ^{
+        NSMutableArray *numbers = [NSMutableArray array];
+        for (int i = 0; i < 1000; ++i) {
+            [numbers addObject:[NSNumber numberWithInt:i]];
+        }
+
+        PROLazySequence *sequence = [[[[numbers lazySequence] concurrentSequence] filterUsingBlock:^(NSNumber *num){
+            return (BOOL)([num intValue] % 2 == 0);
+        }] takeCount:3];
+
+        NSArray *expectedArray = [NSArray arrayWithObjects:[NSNumber numberWithInt:0], [NSNumber numberWithInt:2], [NSNumber numberWithInt:4], nil];
+        expect([sequence array]).toEqual(expectedArray);
+    });
+
+    it(@"should stop evaluating concurrent stages after a take stage is exhausted", ^{
+        NSMutableArray *numbers = [NSMutableArray array];
+        for (int i = 0; i < 10000; ++i) {
+            [numbers addObject:[NSNumber numberWithInt:i]];
+        }
+
+        __block volatile int32_t invocations = 0;
+
+        PROLazySequence *sequence = [[[[numbers lazySequence] concurrentSequence] mapUsingBlock:^(NSNumber *num){
+            OSAtomicIncrement32Barrier(&invocations);
+            return num;
+        }] takeCount:1];
+
+        expect([sequence array]).toEqual([NSArray arrayWithObject:[NSNumber numberWithInt:0]]);
+        expect(invocations < 10000).toBeTruthy();
+    });
+
+    it(@"should take no objects", ^{
+        expect([[[array lazySequence] takeCount:0] array]).toEqual([NSArray array]);
+    });
+
+    it(@"should fold left", ^{
+        PROLazySequence *sequence = [[array lazySequence] filterUsingBlock:filterBlock];
+
+        id result = [sequence foldLeftWithValue:@"" usingBlock:^(NSString *left, NSString *right){
+            return [left stringByAppendingString:right];
+        }];
+
+        expect(result).toEqual(@"barbazbuzz");
+    });
+
+    it(@"should fold to starting value when empty", ^{
+        PROLazySequence *sequence = [[NSArray array] lazySequence];
+
+        id result = [sequence foldLeftWithValue:@"foobar" usingBlock:^ id (id left, id right){
+            return nil;
+        }];
+
+        expect(result).toEqual(@"foobar");
+    });
+
+    it(@"should stop enumerating", ^{
+        __block NSUInteger count = 0;
+
+        [[array lazySequence] enumerateObjectsUsingBlock:^(id obj, BOOL *stop){
+            ++count;
+            *stop = YES;
+        }];
+
+        expect(count).toEqual(1);
+    });
+SpecEnd
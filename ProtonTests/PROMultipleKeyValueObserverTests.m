@@ -0,0 +1,192 @@
+//
+//  PROMultipleKeyValueObserverTests.m
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import <Proton/PROMultipleKeyValueObserver.h>
+#import <Proton/SDQueue.h>
+
+@interface MultipleKVOTestObject : NSObject
+@property (nonatomic, copy) NSString *name;
+@property (nonatomic, assign) NSInteger number;
+@end
+
+SpecBegin(PROMultipleKeyValueObserver)
+
+    __block MultipleKVOTestObject *observedObject;
+    __block PROMultipleKeyValueObserver *observer;
+    __block SDQueue *queue;
+
+    // the key path of each change received, in order
+    __block NSMutableArray *receivedKeyPaths;
+
+    before(^{
+        observedObject = [[MultipleKVOTestObject alloc] init];
+        queue = [[SDQueue alloc] init];
+        receivedKeyPaths = [NSMutableArray array];
+
+        observer = [[PROMultipleKeyValueObserver alloc] initWithTarget:observedObject];
+        expect(observer).not.toBeNil();
+        expect(observer.target == observedObject).toBeTruthy();
+        expect(observer.keyPaths.count).toEqual(0);
+        expect(observer.queue).toEqual([SDQueue mainQueue]);
+
+        observer.queue = queue;
+
+        __weak PROMultipleKeyValueObserver *weakObserver = observer;
+
+        [observer addKeyPath:@"name" options:NSKeyValueObservingOptionNew usingBlock:^(NSDictionary *changes){
+            expect(weakObserver.executing).toBeTruthy();
+
+            [receivedKeyPaths addObject:@"name"];
+            expect([changes objectForKey:NSKeyValueChangeNewKey]).toEqual(observedObject.name);
+        }];
+
+        [observer addKeyPath:@"number" usingBlock:^(NSDictionary *changes){
+            expect(weakObserver.executing).toBeTruthy();
+
+            [receivedKeyPaths addObject:@"number"];
+            expect([changes objectForKey:NSKeyValueChangeNewKey]).toBeNil();
+        }];
+
+        expect(observer.keyPaths).toEqual([NSSet setWithObjects:@"name", @"number", nil]);
+    });
+
+    after(^{
+        expect(observer.executing).toBeFalsy();
+
+        // tear down observers before the observed object
+        observer = nil;
+        observedObject = nil;
+    });
+
+    it(@"should invoke the block for each key path", ^{
+        [queue runSynchronously:^{
+            observedObject.name = @"foo";
+            observedObject.number = 5;
+            observedObject.name = @"bar";
+        }];
+
+        NSArray *expectedKeyPaths = [NSArray arrayWithObjects:@"name", @"number", @"name", nil];
+        expect(receivedKeyPaths).toEqual(expectedKeyPaths);
+    });
+
+    it(@"should deliver changes from other threads together and in order", ^{
+        // keep the queue busy until all of the changes have been made
+        dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+        [queue runAsynchronously:^{
+            dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+        }];
+
+        observedObject.number = 1;
+        observedObject.name = @"foo";
+        observedObject.number = 2;
+
+        dispatch_semaphore_signal(semaphore);
+        dispatch_release(semaphore);
+
+        [queue runSynchronously:^{}];
+
+        NSArray *expectedKeyPaths = [NSArray arrayWithObjects:@"number", @"name", @"number", nil];
+        expect(receivedKeyPaths).toEqual(expectedKeyPaths);
+    });
+
+    it(@"should replace the block for a key path", ^{
+        __block BOOL replacementInvoked = NO;
+
+        [observer addKeyPath:@"name" usingBlock:^(NSDictionary *changes){
+            replacementInvoked = YES;
+        }];
+
+        expect(observer.keyPaths.count).toEqual(2);
+
+        [queue runSynchronously:^{
+            observedObject.name = @"foo";
+        }];
+
+        expect(replacementInvoked).toBeTruthy();
+        expect(receivedKeyPaths.count).toEqual(0);
+    });
+
+    it(@"should stop observing a removed key path", ^{
+        [observer removeKeyPath:@"name"];
+        expect(observer.keyPaths).toEqual([NSSet setWithObject:@"number"]);
+
+        // should do nothing
+        [observer removeKeyPath:@"name"];
+
+        [queue runSynchronously:^{
+            observedObject.name = @"foo";
+            observedObject.number = 5;
+        }];
+
+        expect(receivedKeyPaths).toEqual([NSArray arrayWithObject:@"number"]);
+    });
+
+    it(@"should stop observing all key paths", ^{
+        [observer removeAllKeyPaths];
+        expect(observer.keyPaths.count).toEqual(0);
+
+        [queue runSynchronously:^{
+            observedObject.name = @"foo";
+            observedObject.number = 5;
+        }];
+
+        expect(receivedKeyPaths.count).toEqual(0);
+    });
+
+    it(@"should add and remove key paths concurrently", ^{
+        // the number of registration changes to test concurrently
+        const size_t count = 100;
+
+        dispatch_apply(count, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t index){
+            NSString *keyPath = (index % 2 ? @"name" : @"number");
+
+            // every other pair of iterations removes the key paths again
+            if (index % 4 < 2) {
+                [observer addKeyPath:keyPath options:NSKeyValueObservingOptionInitial usingBlock:^(NSDictionary *changes){}];
+            } else {
+                [observer removeKeyPath:keyPath];
+            }
+        });
+
+        // flush any initial notifications
+        [queue runSynchronously:^{}];
+
+        // leave a known set of key paths, which should be registered exactly
+        // once each
+        [observer addKeyPath:@"name" usingBlock:^(NSDictionary *changes){
+            [receivedKeyPaths addObject:@"name"];
+        }];
+
+        [observer removeKeyPath:@"number"];
+        expect(observer.keyPaths).toEqual([NSSet setWithObject:@"name"]);
+
+        [queue runSynchronously:^{
+            observedObject.name = @"foo";
+            observedObject.number = 5;
+        }];
+
+        expect(receivedKeyPaths).toEqual([NSArray arrayWithObject:@"name"]);
+    });
+
+    it(@"should stop observing when destroyed", ^{
+        __weak PROMultipleKeyValueObserver *weakObserver = observer;
+        observer = nil;
+        expect(weakObserver).toBeNil();
+
+        observedObject.name = @"foo";
+        [queue runSynchronously:^{}];
+
+        expect(receivedKeyPaths.count).toEqual(0);
+    });
+
+SpecEnd
+
+@implementation MultipleKVOTestObject
+@synthesize name = m_name;
+@synthesize number = m_number;
+@end
@@ -7,6 +7,7 @@
 //
 
 #import <Proton/Proton.h>
+#import <libkern/OSAtomic.h>
 
 SpecBegin(PRONSArrayAdditions)
     
@@ -83,6 +84,42 @@ SpecBegin(PRONSArrayAdditions)
 
             commonSubarray = nil;
         });
+
+        it(@"should find the first of multiple common subarrays of the same length", ^{
+            [firstArray addObject:@"fizz"];
+            [firstArray addObjectsFromArray:commonSubarray];
+            [secondArray insertObject:@"buzz" atIndex:0];
+            [secondArray addObjectsFromArray:commonSubarray];
+
+            NSRange firstRange;
+            NSRange secondRange;
+            [firstArray longestSubarrayCommonWithArray:secondArray rangeInReceiver:&firstRange rangeInOtherArray:&secondRange];
+
+            expect(firstRange.location).toEqual(0);
+            expect(secondRange.location).toEqual(1);
+        });
+
+        it(@"should find a common subarray between large arrays", ^{
+            [firstArray removeAllObjects];
+            [secondArray removeAllObjects];
+
+            // repeating patterns with many shorter matches, to exercise the
+            // suffix links of the automaton
+            for (NSUInteger i = 0; i < 20000; ++i) {
+                [firstArray addObject:[NSNumber numberWithUnsignedInteger:i % 7]];
+                [secondArray addObject:[NSNumber numberWithUnsignedInteger:i % 5]];
+            }
+
+            // the longest runs in common are 0 through 4
+            commonSubarray = [NSArray arrayWithObjects:
+                [NSNumber numberWithInt:0],
+                [NSNumber numberWithInt:1],
+                [NSNumber numberWithInt:2],
+                [NSNumber numberWithInt:3],
+                [NSNumber numberWithInt:4],
+                nil
+            ];
+        });
     });
     
     describe(@"longest identical subarray", ^{
@@ -160,6 +197,391 @@ SpecBegin(PRONSArrayAdditions)
         });
     });
 
+    describe(@"longest common subsequence", ^{
+        it(@"should find a subsequence that is not contiguous", ^{
+            NSArray *firstArray = [NSArray arrayWithObjects:@"a", @"b", @"c", @"d", @"e", @"f", nil];
+            NSArray *secondArray = [NSArray arrayWithObjects:@"x", @"b", @"d", @"y", @"f", nil];
+            NSArray *expected = [NSArray arrayWithObjects:@"b", @"d", @"f", nil];
+
+            expect([firstArray longestSubsequenceCommonWithArray:secondArray]).toEqual(expected);
+
+            NSIndexSet *firstIndexes = nil;
+            NSIndexSet *secondIndexes = nil;
+            expect([firstArray longestSubsequenceCommonWithArray:secondArray indexesInReceiver:&firstIndexes indexesInOtherArray:&secondIndexes]).toEqual(expected);
+
+            expect([firstArray objectsAtIndexes:firstIndexes]).toEqual(expected);
+            expect([secondArray objectsAtIndexes:secondIndexes]).toEqual(expected);
+        });
+
+        it(@"should return the full array for the same arrays", ^{
+            NSArray *array = [NSArray arrayWithObjects:@"foo", @"bar", @"baz", nil];
+            expect([array longestSubsequenceCommonWithArray:[array mutableCopy]]).toEqual(array);
+        });
+
+        it(@"should return nil if nothing is common", ^{
+            NSArray *firstArray = [NSArray arrayWithObjects:@"foo", @"bar", nil];
+            NSArray *secondArray = [NSArray arrayWithObjects:@"fizz", @"buzz", nil];
+
+            NSIndexSet *firstIndexes = nil;
+            expect([firstArray longestSubsequenceCommonWithArray:secondArray indexesInReceiver:&firstIndexes indexesInOtherArray:NULL]).toBeNil();
+            expect(firstIndexes.count).toEqual(0);
+
+            expect([firstArray longestSubsequenceCommonWithArray:[NSArray array]]).toBeNil();
+        });
+
+        it(@"should compare by identity", ^{
+            NSString *string = @"foo";
+            NSString *equalString = [NSMutableString stringWithString:string];
+
+            NSArray *firstArray = [NSArray arrayWithObjects:string, @"bar", nil];
+            NSArray *secondArray = [NSArray arrayWithObjects:equalString, @"bar", nil];
+
+            expect([firstArray longestSubsequenceCommonWithArray:secondArray]).toEqual(firstArray);
+            expect([firstArray longestSubsequenceIdenticalWithArray:secondArray]).toEqual([NSArray arrayWithObject:@"bar"]);
+        });
+
+        it(@"should find a subsequence between large arrays", ^{
+            NSUInteger count = 10000;
+
+            // the first array counts up by twos, and the second by threes, so
+            // their longest common subsequence is the multiples of six
+            NSMutableArray *firstArray = [NSMutableArray arrayWithCapacity:count];
+            NSMutableArray *secondArray = [NSMutableArray arrayWithCapacity:count];
+            NSMutableArray *expected = [NSMutableArray array];
+
+            for (NSUInteger i = 0; i < count; ++i) {
+                [firstArray addObject:[NSNumber numberWithUnsignedInteger:i * 2]];
+                [secondArray addObject:[NSNumber numberWithUnsignedInteger:i * 3]];
+
+                if (i * 6 < count * 2)
+                    [expected addObject:[NSNumber numberWithUnsignedInteger:i * 6]];
+            }
+
+            expect([firstArray longestSubsequenceCommonWithArray:secondArray]).toEqual(expected);
+        });
+    });
+
+    describe(@"sorted arrays", ^{
+        NSComparator comparator = ^(NSNumber *left, NSNumber *right){
+            return [left compare:right];
+        };
+
+        NSArray *(^numbers)(NSUInteger, ...) = ^ NSArray * (NSUInteger count, ...){
+            NSMutableArray *array = [NSMutableArray arrayWithCapacity:count];
+
+            va_list args;
+            va_start(args, count);
+
+            for (NSUInteger i = 0; i < count; ++i) {
+                [array addObject:[NSNumber numberWithInt:va_arg(args, int)]];
+            }
+
+            va_end(args);
+            return array;
+        };
+
+        NSArray *array = numbers(7, 1, 3, 3, 3, 5, 8, 9);
+
+        it(@"should find lower and upper bounds", ^{
+            expect([array lowerBoundOfObject:[NSNumber numberWithInt:3] usingComparator:comparator]).toEqual(1);
+            expect([array upperBoundOfObject:[NSNumber numberWithInt:3] usingComparator:comparator]).toEqual(4);
+
+            expect([array lowerBoundOfObject:[NSNumber numberWithInt:6] usingComparator:comparator]).toEqual(5);
+            expect([array upperBoundOfObject:[NSNumber numberWithInt:6] usingComparator:comparator]).toEqual(5);
+
+            expect([array lowerBoundOfObject:[NSNumber numberWithInt:0] usingComparator:comparator]).toEqual(0);
+            expect([array upperBoundOfObject:[NSNumber numberWithInt:10] usingComparator:comparator]).toEqual(array.count);
+        });
+
+        it(@"should find the range of equal objects", ^{
+            NSRange range = [array equalRangeOfObject:[NSNumber numberWithInt:3] usingComparator:comparator];
+            expect(range.location).toEqual(1);
+            expect(range.length).toEqual(3);
+
+            range = [array equalRangeOfObject:[NSNumber numberWithInt:4] usingComparator:comparator];
+            expect(range.location).toEqual(4);
+            expect(range.length).toEqual(0);
+        });
+
+        it(@"should intersect", ^{
+            NSArray *otherArray = numbers(6, 0, 3, 3, 4, 9, 12);
+            expect([array sortedArrayByIntersectingSortedArray:otherArray usingComparator:comparator]).toEqual(numbers(3, 3, 3, 9));
+            expect([array sortedArrayByIntersectingSortedArray:[NSArray array] usingComparator:comparator]).toEqual([NSArray array]);
+        });
+
+        it(@"should subtract", ^{
+            NSArray *otherArray = numbers(6, 0, 3, 3, 4, 9, 12);
+            expect([array sortedArrayBySubtractingSortedArray:otherArray usingComparator:comparator]).toEqual(numbers(4, 1, 3, 5, 8));
+            expect([array sortedArrayBySubtractingSortedArray:[NSArray array] usingComparator:comparator]).toEqual(array);
+        });
+
+        it(@"should unite", ^{
+            NSArray *otherArray = numbers(6, 0, 3, 3, 4, 9, 12);
+            expect([array sortedArrayByUnioningSortedArray:otherArray usingComparator:comparator]).toEqual(numbers(10, 0, 1, 3, 3, 3, 4, 5, 8, 9, 12));
+            expect([[NSArray array] sortedArrayByUnioningSortedArray:array usingComparator:comparator]).toEqual(array);
+        });
+
+        it(@"should intersect a small array with a large one", ^{
+            NSUInteger count = 1000000;
+
+            NSMutableArray *largeArray = [NSMutableArray arrayWithCapacity:count];
+            for (NSUInteger i = 0; i < count; ++i) {
+                [largeArray addObject:[NSNumber numberWithUnsignedInteger:i * 2]];
+            }
+
+            NSMutableArray *smallArray = [NSMutableArray array];
+            NSMutableArray *expected = [NSMutableArray array];
+
+            for (NSUInteger i = 0; i < 100; ++i) {
+                // alternate between even numbers (which are in the large
+                // array) and odd numbers (which are not)
+                NSNumber *number = [NSNumber numberWithUnsignedInteger:i * 19999];
+                [smallArray addObject:number];
+
+                if (i % 2 == 0)
+                    [expected addObject:number];
+            }
+
+            __block NSUInteger comparisons = 0;
+            NSComparator countingComparator = ^(NSNumber *left, NSNumber *right){
+                ++comparisons;
+                return [left compare:right];
+            };
+
+            expect([smallArray sortedArrayByIntersectingSortedArray:largeArray usingComparator:countingComparator]).toEqual(expected);
+            expect([largeArray sortedArrayByIntersectingSortedArray:smallArray usingComparator:countingComparator]).toEqual(expected);
+
+            // each object of the small array should only need a logarithmic
+            // number of comparisons
+            expect(comparisons < 2 * 100 * 50).toBeTruthy();
+        });
+    });
+
+    describe(@"differences", ^{
+        __block NSIndexSet *deletedIndexes;
+        __block NSIndexSet *insertedIndexes;
+        __block NSDictionary *movedIndexes;
+
+        before(^{
+            deletedIndexes = nil;
+            insertedIndexes = nil;
+            movedIndexes = nil;
+        });
+
+        it(@"should find no differences between equal arrays", ^{
+            NSArray *array = [NSArray arrayWithObjects:@"foo", @"bar", @"baz", nil];
+
+            [array getDifferencesWithArray:[array mutableCopy] deletedIndexes:&deletedIndexes insertedIndexes:&insertedIndexes movedIndexes:&movedIndexes];
+            expect(deletedIndexes.count).toEqual(0);
+            expect(insertedIndexes.count).toEqual(0);
+            expect(movedIndexes.count).toEqual(0);
+        });
+
+        it(@"should find deletions and insertions", ^{
+            NSArray *oldArray = [NSArray arrayWithObjects:@"a", @"b", @"c", @"d", @"e", nil];
+            NSArray *newArray = [NSArray arrayWithObjects:@"a", @"x", @"c", @"e", @"y", nil];
+
+            [oldArray getDifferencesWithArray:newArray deletedIndexes:&deletedIndexes insertedIndexes:&insertedIndexes movedIndexes:NULL];
+
+            NSMutableIndexSet *expectedDeletions = [NSMutableIndexSet indexSetWithIndex:1];
+            [expectedDeletions addIndex:3];
+
+            NSMutableIndexSet *expectedInsertions = [NSMutableIndexSet indexSetWithIndex:1];
+            [expectedInsertions addIndex:4];
+
+            expect(deletedIndexes).toEqual(expectedDeletions);
+            expect(insertedIndexes).toEqual(expectedInsertions);
+        });
+
+        it(@"should find everything deleted and inserted from an empty array", ^{
+            NSArray *array = [NSArray arrayWithObjects:@"foo", @"bar", nil];
+
+            [array getDifferencesWithArray:[NSArray array] deletedIndexes:&deletedIndexes insertedIndexes:&insertedIndexes movedIndexes:&movedIndexes];
+            expect(deletedIndexes).toEqual([NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 2)]);
+            expect(insertedIndexes.count).toEqual(0);
+
+            [[NSArray array] getDifferencesWithArray:array deletedIndexes:&deletedIndexes insertedIndexes:&insertedIndexes movedIndexes:&movedIndexes];
+            expect(deletedIndexes.count).toEqual(0);
+            expect(insertedIndexes).toEqual([NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 2)]);
+        });
+
+        it(@"should detect moves", ^{
+            NSArray *oldArray = [NSArray arrayWithObjects:@"a", @"b", @"c", @"d", nil];
+            NSArray *newArray = [NSArray arrayWithObjects:@"b", @"c", @"d", @"a", @"e", nil];
+
+            [oldArray getDifferencesWithArray:newArray deletedIndexes:&deletedIndexes insertedIndexes:&insertedIndexes movedIndexes:&movedIndexes];
+            expect(deletedIndexes.count).toEqual(0);
+            expect(insertedIndexes).toEqual([NSIndexSet indexSetWithIndex:4]);
+            expect(movedIndexes).toEqual([NSDictionary dictionaryWithObject:[NSNumber numberWithUnsignedInteger:3] forKey:[NSNumber numberWithUnsignedInteger:0]]);
+
+            // without asking for moves, the same change is a deletion and an
+            // insertion
+            [oldArray getDifferencesWithArray:newArray deletedIndexes:&deletedIndexes insertedIndexes:&insertedIndexes movedIndexes:NULL];
+            expect(deletedIndexes).toEqual([NSIndexSet indexSetWithIndex:0]);
+            expect(insertedIndexes).toEqual([NSIndexSet indexSetWithIndexesInRange:NSMakeRange(3, 2)]);
+        });
+
+        it(@"should compare by identity", ^{
+            NSString *string = @"foo";
+            NSString *equalString = [NSMutableString stringWithString:string];
+
+            NSArray *oldArray = [NSArray arrayWithObjects:string, @"bar", nil];
+            NSArray *newArray = [NSArray arrayWithObjects:equalString, @"bar", nil];
+
+            [oldArray getDifferencesWithArray:newArray deletedIndexes:&deletedIndexes insertedIndexes:&insertedIndexes movedIndexes:&movedIndexes];
+            expect(deletedIndexes.count).toEqual(0);
+            expect(insertedIndexes.count).toEqual(0);
+
+            [oldArray getIdentityDifferencesWithArray:newArray deletedIndexes:&deletedIndexes insertedIndexes:&insertedIndexes movedIndexes:&movedIndexes];
+            expect(deletedIndexes).toEqual([NSIndexSet indexSetWithIndex:0]);
+            expect(insertedIndexes).toEqual([NSIndexSet indexSetWithIndex:0]);
+            expect(movedIndexes.count).toEqual(0);
+        });
+
+        it(@"should find a small change between large arrays", ^{
+            NSUInteger count = 100000;
+
+            NSMutableArray *oldArray = [NSMutableArray arrayWithCapacity:count];
+            for (NSUInteger i = 0; i < count; ++i) {
+                [oldArray addObject:[NSNumber numberWithUnsignedInteger:i]];
+            }
+
+            NSMutableArray *newArray = [oldArray mutableCopy];
+            [newArray removeObjectAtIndex:50000];
+            [newArray insertObject:@"foo" atIndex:1000];
+
+            [oldArray getDifferencesWithArray:newArray deletedIndexes:&deletedIndexes insertedIndexes:&insertedIndexes movedIndexes:&movedIndexes];
+            expect(deletedIndexes).toEqual([NSIndexSet indexSetWithIndex:50000]);
+            expect(insertedIndexes).toEqual([NSIndexSet indexSetWithIndex:1000]);
+            expect(movedIndexes.count).toEqual(0);
+        });
+    });
+
+    describe(@"tree enumeration", ^{
+        // a  [b  [c]  d]  [e]
+        NSArray *tree = [NSArray arrayWithObjects:
+            @"a",
+            [NSArray arrayWithObjects:@"b", [NSArray arrayWithObject:@"c"], @"d", nil],
+            [NSArray arrayWithObject:@"e"],
+            nil
+        ];
+
+        // collects the strings visited, along with their depths and index
+        // paths
+        __block NSMutableArray *visited;
+        __block NSMutableArray *depths;
+        __block NSMutableArray *indexPaths;
+
+        void (^visitBlock)(id, NSUInteger, const NSUInteger *, BOOL *, BOOL *) = ^(id obj, NSUInteger depth, const NSUInteger *indexes, BOOL *skipDescendants, BOOL *stop){
+            if (![obj isKindOfClass:[NSString class]])
+                return;
+
+            [visited addObject:obj];
+            [depths addObject:[NSNumber numberWithUnsignedInteger:depth]];
+            [indexPaths addObject:[NSIndexPath indexPathWithIndexes:(NSUInteger *)indexes length:depth + 1]];
+        };
+
+        before(^{
+            visited = [NSMutableArray array];
+            depths = [NSMutableArray array];
+            indexPaths = [NSMutableArray array];
+        });
+
+        it(@"should enumerate in pre-order", ^{
+            [tree enumerateTreeUsingBlock:visitBlock];
+
+            expect(visited).toEqual(([NSArray arrayWithObjects:@"a", @"b", @"c", @"d", @"e", nil]));
+            expect([depths objectAtIndex:2]).toEqual([NSNumber numberWithUnsignedInteger:2]);
+
+            [visited enumerateObjectsUsingBlock:^(id obj, NSUInteger index, BOOL *stop){
+                expect([tree objectAtIndexPath:[indexPaths objectAtIndex:index]]).toEqual(obj);
+            }];
+        });
+
+        it(@"should enumerate in post-order", ^{
+            NSMutableArray *containers = [NSMutableArray array];
+
+            [tree enumerateTreeWithOptions:PROTreeEnumerationPostOrder nodeKeyPath:nil usingBlock:^(id obj, NSUInteger depth, const NSUInteger *indexes, BOOL *skipDescendants, BOOL *stop){
+                if ([obj isKindOfClass:[NSArray class]])
+                    [containers addObject:obj];
+                else
+                    [visited addObject:obj];
+            }];
+
+            expect(visited).toEqual(([NSArray arrayWithObjects:@"a", @"b", @"c", @"d", @"e", nil]));
+
+            // each array should be visited after its children
+            expect(containers.count).toEqual(3);
+            expect([containers objectAtIndex:0]).toEqual([NSArray arrayWithObject:@"c"]);
+            expect([containers objectAtIndex:1]).toEqual([tree objectAtIndex:1]);
+        });
+
+        it(@"should enumerate in reverse", ^{
+            [tree enumerateTreeWithOptions:NSEnumerationReverse nodeKeyPath:nil usingBlock:visitBlock];
+            expect(visited).toEqual(([NSArray arrayWithObjects:@"e", @"d", @"c", @"b", @"a", nil]));
+        });
+
+        it(@"should skip descendants", ^{
+            [tree enumerateTreeUsingBlock:^(id obj, NSUInteger depth, const NSUInteger *indexes, BOOL *skipDescendants, BOOL *stop){
+                if ([obj isKindOfClass:[NSArray class]] && depth == 0)
+                    *skipDescendants = ([obj count] == 3);
+
+                visitBlock(obj, depth, indexes, skipDescendants, stop);
+            }];
+
+            expect(visited).toEqual(([NSArray arrayWithObjects:@"a", @"e", nil]));
+        });
+
+        it(@"should stop", ^{
+            [tree enumerateTreeUsingBlock:^(id obj, NSUInteger depth, const NSUInteger *indexes, BOOL *skipDescendants, BOOL *stop){
+                visitBlock(obj, depth, indexes, skipDescendants, stop);
+                *stop = [obj isEqual:@"c"];
+            }];
+
+            expect(visited).toEqual(([NSArray arrayWithObjects:@"a", @"b", @"c", nil]));
+        });
+
+        it(@"should enumerate with a key path", ^{
+            NSDictionary *firstLeaf = [NSDictionary dictionaryWithObject:@"b" forKey:@"name"];
+            NSDictionary *secondLeaf = [NSDictionary dictionaryWithObject:@"c" forKey:@"name"];
+
+            NSDictionary *node = [NSDictionary dictionaryWithObjectsAndKeys:
+                @"a", @"name",
+                [NSArray arrayWithObjects:firstLeaf, secondLeaf, nil], @"children",
+                nil
+            ];
+
+            NSArray *nodes = [NSArray arrayWithObject:node];
+            __block NSIndexPath *lastIndexPath = nil;
+
+            [nodes enumerateTreeWithOptions:0 nodeKeyPath:@"children" usingBlock:^(NSDictionary *obj, NSUInteger depth, const NSUInteger *indexes, BOOL *skipDescendants, BOOL *stop){
+                [visited addObject:[obj objectForKey:@"name"]];
+                lastIndexPath = [NSIndexPath indexPathWithIndexes:(NSUInteger *)indexes length:depth + 1];
+            }];
+
+            expect(visited).toEqual(([NSArray arrayWithObjects:@"a", @"b", @"c", nil]));
+
+            NSUInteger indexes[] = { 0, 1 };
+            expect(lastIndexPath).toEqual([NSIndexPath indexPathWithIndexes:indexes length:2]);
+            expect([nodes objectAtIndexPath:lastIndexPath nodeKeyPath:@"children"]).toEqual(secondLeaf);
+        });
+
+        it(@"should enumerate subtrees concurrently", ^{
+            NSMutableArray *largeTree = [NSMutableArray array];
+            for (NSUInteger i = 0; i < 100; ++i) {
+                [largeTree addObject:tree];
+            }
+
+            __block int32_t count = 0;
+            [largeTree enumerateTreeWithOptions:NSEnumerationConcurrent nodeKeyPath:nil usingBlock:^(id obj, NSUInteger depth, const NSUInteger *indexes, BOOL *skipDescendants, BOOL *stop){
+                if ([obj isKindOfClass:[NSString class]])
+                    OSAtomicIncrement32Barrier(&count);
+            }];
+
+            expect(count).toEqual(500);
+        });
+    });
+
     describe(@"object at index path", ^{
         __block NSArray *array;
 
@@ -222,6 +644,53 @@ SpecBegin(PRONSArrayAdditions)
 
             expect([array objectAtIndexPath:indexPath nodeKeyPath:@"bar"]).toEqual(object);
         });
+
+        it(@"should return objects at multiple index paths", ^{
+            NSUInteger nestedIndexes[] = { 1, 1 };
+            NSUInteger firstNestedIndexes[] = { 1, 0 };
+            NSUInteger invalidIndexes[] = { 0, 1 };
+
+            NSArray *indexPaths = [NSArray arrayWithObjects:
+                [NSIndexPath indexPathWithIndexes:nestedIndexes length:2],
+                [NSIndexPath indexPathWithIndex:0],
+                [NSIndexPath indexPathWithIndexes:invalidIndexes length:2],
+                [NSIndexPath indexPathWithIndexes:firstNestedIndexes length:2],
+                [NSIndexPath indexPathWithIndexes:nestedIndexes length:2],
+                nil
+            ];
+
+            NSArray *expected = [NSArray arrayWithObjects:@"bar", @"foo", [NSNull null], @"foo", @"bar", nil];
+            expect([array objectsAtIndexPaths:indexPaths]).toEqual(expected);
+        });
+
+        it(@"should return NSNull for out-of-range index paths", ^{
+            NSUInteger outOfRangeLeafIndexes[] = { 1, 5 };
+            NSUInteger outOfRangeNodeIndexes[] = { 10, 0 };
+
+            NSArray *indexPaths = [NSArray arrayWithObjects:
+                [NSIndexPath indexPathWithIndexes:outOfRangeLeafIndexes length:2],
+                [NSIndexPath indexPathWithIndex:10],
+                [NSIndexPath indexPathWithIndexes:outOfRangeNodeIndexes length:2],
+                [NSIndexPath indexPathWithIndex:0],
+                nil
+            ];
+
+            NSArray *expected = [NSArray arrayWithObjects:[NSNull null], [NSNull null], [NSNull null], @"foo", nil];
+            expect([array objectsAtIndexPaths:indexPaths]).toEqual(expected);
+        });
+
+        it(@"should return objects at multiple index paths with a key path", ^{
+            NSUInteger indexes[] = { 2, 0 };
+
+            NSArray *indexPaths = [NSArray arrayWithObjects:
+                [NSIndexPath indexPathWithIndexes:indexes length:2],
+                [NSIndexPath indexPathWithIndex:1],
+                nil
+            ];
+
+            NSArray *expected = [NSArray arrayWithObjects:@"foo", [array objectAtIndex:1], nil];
+            expect([array objectsAtIndexPaths:indexPaths nodeKeyPath:@"bar"]).toEqual(expected);
+        });
     });
 
 SpecEnd
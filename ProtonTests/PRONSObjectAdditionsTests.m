@@ -126,6 +126,22 @@ SpecBegin(PRONSObjectAdditions)
             expect(secondObserver).toBeNil();
         });
 
+        it(@"should remove observers when the owner is deallocated", ^{
+            __weak PROKeyValueObserver *observer;
+            __weak NSObject *weakOwner;
+
+            @autoreleasepool {
+                NSObject *owner = [[NSObject alloc] init];
+                weakOwner = owner;
+
+                observer = [operation addObserverOwnedByObject:owner forKeyPath:keyPath usingBlock:block];
+                expect(observer).not.toBeNil();
+            }
+
+            expect(weakOwner).toBeNil();
+            expect(observer).toBeNil();
+        });
+
         it(@"should add observers in a thread-safe way", ^{
             // the number of observers to test concurrently
             const size_t count = 10;
@@ -209,6 +225,44 @@ SpecBegin(PRONSObjectAdditions)
             [operation start];
             [operation waitUntilFinished];
         });
+
+        it(@"should add and remove observers for many owners concurrently", ^{
+            // the number of owners to test concurrently
+            const size_t count = 100;
+
+            __weak PROKeyValueObserver * volatile *observers = (__weak id *)malloc(sizeof(*observers) * count);
+            @onExit {
+                free((void *)observers);
+            };
+
+            @autoreleasepool {
+                dispatch_apply(count, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t index){
+                    @autoreleasepool {
+                        NSObject *owner = [[NSObject alloc] init];
+
+                        observers[index] = [operation addObserverOwnedByObject:owner forKeyPath:keyPath usingBlock:block];
+                        [operation addObserverOwnedByObject:owner forKeyPath:@"isFinished" usingBlock:block];
+
+                        [owner removeOwnedObserver:observers[index]];
+                        [owner removeAllOwnedObservers];
+
+                        // removing again should do nothing
+                        [owner removeAllOwnedObservers];
+                    }
+                });
+
+                // make sure all stores and weak reference updates complete
+                OSMemoryBarrier();
+            }
+
+            for (size_t i = 0;i < count;++i) {
+                expect(observers[i]).toBeNil();
+            }
+
+            // start the operation and make sure no observers are triggered
+            [operation start];
+            [operation waitUntilFinished];
+        });
     });
 
     describe(@"applying key-value changes", ^{
@@ -622,6 +676,212 @@ SpecBegin(PRONSObjectAdditions)
         });
     });
 
+    describe(@"applying batched key-value changes", ^{
+        NSString *keyPath = @"foobar";
+
+        NSDictionary *(^orderedChange)(NSKeyValueChange, NSIndexSet *, NSArray *) = ^ NSDictionary * (NSKeyValueChange kind, NSIndexSet *indexes, NSArray *newObjects){
+            NSMutableDictionary *changes = [NSMutableDictionary dictionaryWithObjectsAndKeys:
+                [NSNumber numberWithUnsignedInteger:kind], NSKeyValueChangeKindKey,
+                indexes, NSKeyValueChangeIndexesKey,
+                nil
+            ];
+
+            if (newObjects)
+                [changes setObject:newObjects forKey:NSKeyValueChangeNewKey];
+
+            return changes;
+        };
+
+        __block NSMutableArray *array;
+        __block NSMutableDictionary *object;
+
+        before(^{
+            array = [NSMutableArray arrayWithObjects:@"foo", @"bar", @"fizz", @"buzz", nil];
+            object = [NSMutableDictionary dictionaryWithObject:[array mutableCopy] forKey:keyPath];
+        });
+
+        it(@"should have the same result as applying each change", ^{
+            NSArray *changeDictionaries = [NSArray arrayWithObjects:
+                orderedChange(NSKeyValueChangeInsertion, [NSIndexSet indexSetWithIndex:4], [NSArray arrayWithObject:@"quux"]),
+                orderedChange(NSKeyValueChangeRemoval, [NSIndexSet indexSetWithIndex:0], nil),
+                orderedChange(NSKeyValueChangeInsertion, [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(1, 2)], [NSArray arrayWithObjects:@"a", @"b", nil]),
+                orderedChange(NSKeyValueChangeReplacement, [NSIndexSet indexSetWithIndex:3], [NSArray arrayWithObject:@"c"]),
+                orderedChange(NSKeyValueChangeRemoval, [NSIndexSet indexSetWithIndex:1], nil),
+                nil
+            ];
+
+            NSMutableDictionary *expectedObject = [NSMutableDictionary dictionaryWithObject:[array mutableCopy] forKey:keyPath];
+            for (NSDictionary *changes in changeDictionaries) {
+                [expectedObject applyKeyValueChangeDictionary:changes toKeyPath:keyPath mappingNewObjectsUsingBlock:nil];
+            }
+
+            [object applyKeyValueChangeDictionaries:changeDictionaries toKeyPath:keyPath mappingNewObjectsUsingBlock:nil];
+            expect([object objectForKey:keyPath]).toEqual([expectedObject objectForKey:keyPath]);
+        });
+
+        it(@"should only map objects which remain in the collection", ^{
+            __block NSUInteger mappedCount = 0;
+
+            NSArray *changeDictionaries = [NSArray arrayWithObjects:
+                orderedChange(NSKeyValueChangeInsertion, [NSIndexSet indexSetWithIndex:0], [NSArray arrayWithObject:@"quux"]),
+                orderedChange(NSKeyValueChangeInsertion, [NSIndexSet indexSetWithIndex:1], [NSArray arrayWithObject:@"a"]),
+                orderedChange(NSKeyValueChangeRemoval, [NSIndexSet indexSetWithIndex:0], nil),
+                nil
+            ];
+
+            [object applyKeyValueChangeDictionaries:changeDictionaries toKeyPath:keyPath mappingNewObjectsUsingBlock:^ id (id obj){
+                ++mappedCount;
+                return [obj uppercaseString];
+            }];
+
+            NSArray *expectedArray = [NSArray arrayWithObjects:@"A", @"foo", @"bar", @"fizz", @"buzz", nil];
+            expect([object objectForKey:keyPath]).toEqual(expectedArray);
+            expect(mappedCount).toEqual(1);
+        });
+
+        it(@"should apply changes around a 'setting' change", ^{
+            NSDictionary *settingChange = [NSDictionary dictionaryWithObjectsAndKeys:
+                [NSNumber numberWithUnsignedInteger:NSKeyValueChangeSetting], NSKeyValueChangeKindKey,
+                [NSArray arrayWithObjects:@"a", @"b", nil], NSKeyValueChangeNewKey,
+                nil
+            ];
+
+            NSArray *changeDictionaries = [NSArray arrayWithObjects:
+                orderedChange(NSKeyValueChangeRemoval, [NSIndexSet indexSetWithIndex:0], nil),
+                settingChange,
+                orderedChange(NSKeyValueChangeInsertion, [NSIndexSet indexSetWithIndex:2], [NSArray arrayWithObject:@"c"]),
+                nil
+            ];
+
+            [object applyKeyValueChangeDictionaries:changeDictionaries toKeyPath:keyPath mappingNewObjectsUsingBlock:nil];
+
+            NSArray *expectedArray = [NSArray arrayWithObjects:@"a", @"b", @"c", nil];
+            expect([object objectForKey:keyPath]).toEqual(expectedArray);
+        });
+
+        it(@"should fold unordered changes", ^{
+            [object setObject:[NSMutableSet setWithArray:array] forKey:keyPath];
+
+            NSArray *changeDictionaries = [NSArray arrayWithObjects:
+                [NSDictionary dictionaryWithObjectsAndKeys:
+                    [NSNumber numberWithUnsignedInteger:NSKeyValueChangeInsertion], NSKeyValueChangeKindKey,
+                    [NSArray arrayWithObjects:@"quux", @"a", nil], NSKeyValueChangeNewKey,
+                    nil
+                ],
+                [NSDictionary dictionaryWithObjectsAndKeys:
+                    [NSNumber numberWithUnsignedInteger:NSKeyValueChangeRemoval], NSKeyValueChangeKindKey,
+                    [NSArray arrayWithObjects:@"foo", @"quux", nil], NSKeyValueChangeOldKey,
+                    nil
+                ],
+                [NSDictionary dictionaryWithObjectsAndKeys:
+                    [NSNumber numberWithUnsignedInteger:NSKeyValueChangeInsertion], NSKeyValueChangeKindKey,
+                    [NSArray arrayWithObject:@"foo"], NSKeyValueChangeNewKey,
+                    nil
+                ],
+                nil
+            ];
+
+            [object applyKeyValueChangeDictionaries:changeDictionaries toKeyPath:keyPath mappingNewObjectsUsingBlock:nil];
+
+            NSSet *expectedSet = [NSSet setWithObjects:@"foo", @"bar", @"fizz", @"buzz", @"a", nil];
+            expect([object objectForKey:keyPath]).toEqual(expectedSet);
+        });
+    });
+
+    describe(@"applying large key-value changes", ^{
+        NSString *keyPath = @"foobar";
+
+        __block NSMutableDictionary *object;
+
+        before(^{
+            object = [NSMutableDictionary dictionaryWithObject:[NSMutableArray array] forKey:keyPath];
+        });
+
+        it(@"should map new objects concurrently", ^{
+            NSMutableArray *insertedObjects = [NSMutableArray array];
+            for (NSUInteger i = 0; i < 10000; ++i) {
+                [insertedObjects addObject:[NSNumber numberWithUnsignedInteger:i]];
+            }
+
+            NSDictionary *changes = [NSDictionary dictionaryWithObjectsAndKeys:
+                [NSNumber numberWithUnsignedInteger:NSKeyValueChangeInsertion], NSKeyValueChangeKindKey,
+                insertedObjects, NSKeyValueChangeNewKey,
+                [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, insertedObjects.count)], NSKeyValueChangeIndexesKey,
+                nil
+            ];
+
+            id (^doubleBlock)(id) = ^ id (id number){
+                return [NSNumber numberWithUnsignedInteger:[number unsignedIntegerValue] * 2];
+            };
+
+            [object applyKeyValueChangeDictionary:changes toKeyPath:keyPath options:NSEnumerationConcurrent mappedObjects:nil mappingNewObjectsUsingBlock:doubleBlock];
+            expect([object objectForKey:keyPath]).toEqual([insertedObjects mapUsingBlock:doubleBlock]);
+        });
+
+        it(@"should not map an object twice with a mapping dictionary", ^{
+            NSMutableDictionary *mappedObjects = PROIdentityMappingDictionary();
+            __block volatile int32_t mappedCount = 0;
+
+            // plain objects don't conform to NSCopying
+            NSArray *insertedObjects = [NSArray arrayWithObjects:[[NSObject alloc] init], [[NSObject alloc] init], nil];
+
+            NSDictionary *changes = [NSDictionary dictionaryWithObjectsAndKeys:
+                [NSNumber numberWithUnsignedInteger:NSKeyValueChangeInsertion], NSKeyValueChangeKindKey,
+                insertedObjects, NSKeyValueChangeNewKey,
+                [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 2)], NSKeyValueChangeIndexesKey,
+                nil
+            ];
+
+            id (^mappingBlock)(id) = ^ id (id obj){
+                OSAtomicIncrement32Barrier(&mappedCount);
+                return [NSArray arrayWithObject:obj];
+            };
+
+            [object applyKeyValueChangeDictionary:changes toKeyPath:keyPath options:NSEnumerationConcurrent mappedObjects:mappedObjects mappingNewObjectsUsingBlock:mappingBlock];
+            [object applyKeyValueChangeDictionary:changes toKeyPath:keyPath options:0 mappedObjects:mappedObjects mappingNewObjectsUsingBlock:mappingBlock];
+
+            expect((int)mappedCount).toEqual(2);
+            expect(mappedObjects.count).toEqual(2);
+
+            NSArray *array = [object objectForKey:keyPath];
+            expect(array.count).toEqual(4);
+            expect([array objectAtIndex:0] == [array objectAtIndex:2]).toBeTruthy();
+            expect([array objectAtIndex:1] == [array objectAtIndex:3]).toBeTruthy();
+        });
+
+        it(@"should add entries to a mapping dictionary without copying keys", ^{
+            NSMutableDictionary *mappedObjects = PROIdentityMappingDictionary();
+
+            // plain objects don't conform to NSCopying
+            NSObject *key = [[NSObject alloc] init];
+            [mappedObjects setObject:@"foo" forKey:key];
+
+            expect(mappedObjects.count).toEqual(1);
+            expect([mappedObjects objectForKey:key]).toEqual(@"foo");
+            expect([[mappedObjects allKeys] lastObject] == key).toBeTruthy();
+
+            [mappedObjects removeObjectForKey:key];
+            expect(mappedObjects.count).toEqual(0);
+        });
+
+        it(@"should remove a set of objects from an unordered collection", ^{
+            [object setObject:[NSMutableSet setWithObjects:@"foo", @"bar", @"fizz", nil] forKey:keyPath];
+
+            NSDictionary *changes = [NSDictionary dictionaryWithObjectsAndKeys:
+                [NSNumber numberWithUnsignedInteger:NSKeyValueChangeReplacement], NSKeyValueChangeKindKey,
+                [NSSet setWithObjects:@"foo", @"fizz", nil], NSKeyValueChangeOldKey,
+                [NSSet setWithObject:@"buzz"], NSKeyValueChangeNewKey,
+                nil
+            ];
+
+            [object applyKeyValueChangeDictionary:changes toKeyPath:keyPath options:NSEnumerationConcurrent mappedObjects:nil mappingNewObjectsUsingBlock:^ id (id str){
+                return [str uppercaseString];
+            }];
+
+            expect([object objectForKey:keyPath]).toEqual([NSSet setWithObjects:@"bar", @"BUZZ", nil]);
+        });
+    });
+
 SpecEnd
 
 @implementation ErrorTestClass
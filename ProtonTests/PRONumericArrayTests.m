@@ -0,0 +1,108 @@
+//
+//  PRONumericArrayTests.m
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import <Proton/Proton.h>
+
+SpecBegin(PRONumericArray)
+    double values[] = { 3, -1, 4, 1.5, 9, 2 };
+    NSUInteger count = sizeof(values) / sizeof(*values);
+
+    PRONumericArray *numericArray = [PRONumericArray numericArrayWithValues:values count:count];
+    PRONumericArray *emptyArray = [[PRONumericArray alloc] init];
+
+    it(@"should initialize with values", ^{
+        expect(numericArray.count).toEqual(count);
+
+        for (NSUInteger i = 0; i < count; ++i) {
+            expect([numericArray valueAtIndex:i]).toEqual(values[i]);
+        }
+    });
+
+    it(@"should convert to and from an array of numbers", ^{
+        NSArray *array = [numericArray array];
+        expect(array.count).toEqual(count);
+        expect([array objectAtIndex:3]).toEqual([NSNumber numberWithDouble:1.5]);
+
+        expect([PRONumericArray numericArrayWithArray:array]).toEqual(numericArray);
+        expect([emptyArray array]).toEqual([NSArray array]);
+    });
+
+    it(@"should map", ^{
+        double expectedValues[] = { 6, -2, 8, 3, 18, 4 };
+        PRONumericArray *expected = [PRONumericArray numericArrayWithValues:expectedValues count:count];
+
+        id doubleBlock = ^(double value){
+            return value * 2;
+        };
+
+        expect([numericArray mapUsingBlock:doubleBlock]).toEqual(expected);
+        expect([numericArray mapWithOptions:NSEnumerationConcurrent usingBlock:doubleBlock]).toEqual(expected);
+        expect([numericArray numericArrayByMultiplyingByValue:2]).toEqual(expected);
+    });
+
+    it(@"should filter", ^{
+        double expectedValues[] = { 3, 4, 9 };
+        PRONumericArray *expected = [PRONumericArray numericArrayWithValues:expectedValues count:3];
+
+        id thresholdBlock = ^(double value){
+            return (BOOL)(value >= 2.5);
+        };
+
+        expect([numericArray filterUsingBlock:thresholdBlock]).toEqual(expected);
+        expect([numericArray filterWithOptions:NSEnumerationConcurrent usingBlock:thresholdBlock]).toEqual(expected);
+        expect([numericArray filterValuesFromMinimum:2.5 toMaximum:INFINITY]).toEqual(expected);
+    });
+
+    it(@"should fold", ^{
+        double result = [numericArray foldLeftWithValue:0 usingBlock:^(double left, double right){
+            return left - right;
+        }];
+
+        expect(result).toEqual(-18.5);
+
+        result = [numericArray foldRightWithValue:0 usingBlock:^(double left, double right){
+            return left - right;
+        }];
+
+        expect(result).toEqual(3 - (-1 - (4 - (1.5 - (9 - 2)))));
+    });
+
+    it(@"should compute aggregates", ^{
+        expect([numericArray sum]).toEqual(18.5);
+        expect([numericArray minimum]).toEqual(-1);
+        expect([numericArray maximum]).toEqual(9);
+
+        double sums[] = { 3, 2, 6, 7.5, 16.5, 18.5 };
+        expect([numericArray prefixSums]).toEqual([PRONumericArray numericArrayWithValues:sums count:count]);
+
+        expect([emptyArray sum]).toEqual(0);
+        expect(isnan([emptyArray minimum])).toBeTruthy();
+    });
+
+    it(@"should reduce a large array", ^{
+        NSUInteger largeCount = 100000;
+        double *largeValues = malloc(largeCount * sizeof(*largeValues));
+
+        for (NSUInteger i = 0; i < largeCount; ++i) {
+            largeValues[i] = i + 1;
+        }
+
+        PRONumericArray *largeArray = [PRONumericArray numericArrayWithValues:largeValues count:largeCount];
+        free(largeValues);
+
+        double expectedSum = (double)largeCount * (largeCount + 1) / 2;
+        expect([largeArray sum]).toEqual(expectedSum);
+
+        double reduced = [largeArray reduceWithIdentity:0 usingBlock:^(double left, double right){
+            return left + right;
+        }];
+
+        expect(reduced).toEqual(expectedSum);
+        expect([[largeArray prefixSums] valueAtIndex:largeCount - 1]).toEqual(expectedSum);
+    });
+SpecEnd
@@ -0,0 +1,88 @@
+//
+//  PROSearchIndexTests.m
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import <Proton/Proton.h>
+
+SpecBegin(PROSearchIndex)
+    NSArray *array = [NSArray arrayWithObjects:@"a", @"b", @"r", @"a", @"c", @"a", @"d", @"a", @"b", @"r", @"a", nil];
+    PROSearchIndex *searchIndex = [PROSearchIndex searchIndexWithArray:array];
+
+    it(@"should initialize with an array", ^{
+        expect(searchIndex.array).toEqual(array);
+        expect(searchIndex.comparesIdentity).toBeFalsy();
+    });
+
+    it(@"should find subarrays", ^{
+        NSArray *subarray = [NSArray arrayWithObjects:@"b", @"r", @"a", nil];
+
+        expect([searchIndex containsSubarray:subarray]).toBeTruthy();
+        expect([searchIndex countOfSubarray:subarray]).toEqual(2);
+
+        NSRange range = [searchIndex rangeOfSubarray:subarray];
+        expect(range.location).toEqual(1);
+        expect(range.length).toEqual(3);
+
+        expect([searchIndex countOfSubarray:[NSArray arrayWithObject:@"a"]]).toEqual(5);
+        expect([searchIndex containsSubarray:[NSArray array]]).toBeTruthy();
+    });
+
+    it(@"should not find missing subarrays", ^{
+        NSArray *subarray = [NSArray arrayWithObjects:@"b", @"a", nil];
+
+        expect([searchIndex containsSubarray:subarray]).toBeFalsy();
+        expect([searchIndex countOfSubarray:subarray]).toEqual(0);
+        expect([searchIndex rangeOfSubarray:subarray].location).toEqual(NSNotFound);
+
+        expect([searchIndex containsSubarray:[NSArray arrayWithObject:@"z"]]).toBeFalsy();
+    });
+
+    it(@"should find the longest common subarray", ^{
+        NSArray *otherArray = [NSArray arrayWithObjects:@"z", @"c", @"a", @"d", @"z", nil];
+
+        NSRange range = NSMakeRange(0, 0);
+        NSRange indexedRange = NSMakeRange(0, 0);
+
+        NSArray *expected = [NSArray arrayWithObjects:@"c", @"a", @"d", nil];
+        expect([searchIndex longestSubarrayCommonWithArray:otherArray rangeInArray:&range rangeInIndexedArray:&indexedRange]).toEqual(expected);
+
+        expect([otherArray subarrayWithRange:range]).toEqual(expected);
+        expect([array subarrayWithRange:indexedRange]).toEqual(expected);
+
+        expect([searchIndex longestSubarrayCommonWithArray:[NSArray arrayWithObject:@"z"]]).toBeNil();
+    });
+
+    it(@"should compare by identity", ^{
+        NSString *string = [NSMutableString stringWithString:@"foo"];
+        NSArray *identityArray = [NSArray arrayWithObjects:string, @"bar", nil];
+
+        PROSearchIndex *identityIndex = [[PROSearchIndex alloc] initWithArray:identityArray comparesIdentity:YES];
+        expect(identityIndex.comparesIdentity).toBeTruthy();
+
+        expect([identityIndex containsSubarray:[NSArray arrayWithObject:string]]).toBeTruthy();
+        expect([identityIndex containsSubarray:[NSArray arrayWithObject:[string copy]]]).toBeFalsy();
+    });
+
+    it(@"should answer many queries concurrently", ^{
+        NSMutableArray *probes = [NSMutableArray array];
+        NSMutableArray *expected = [NSMutableArray array];
+
+        for (NSUInteger i = 0; i < 1000; ++i) {
+            NSUInteger location = i % (array.count - 1);
+            NSArray *subarray = [array subarrayWithRange:NSMakeRange(location, 2)];
+
+            [probes addObject:[[NSArray arrayWithObject:@"z"] arrayByAddingObjectsFromArray:subarray]];
+            [expected addObject:subarray];
+        }
+
+        [probes addObject:[NSArray arrayWithObject:@"z"]];
+        [expected addObject:[NSNull null]];
+
+        expect([searchIndex longestSubarraysCommonWithArrays:probes options:NSEnumerationConcurrent]).toEqual(expected);
+        expect([searchIndex longestSubarraysCommonWithArrays:probes options:0]).toEqual(expected);
+    });
+SpecEnd
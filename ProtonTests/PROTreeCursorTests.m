@@ -0,0 +1,92 @@
+//
+//  PROTreeCursorTests.m
+//  Proton
+//
+//  Created by Justin Spahr-Summers on 16.10.12.
+//  Copyright (c) 2012 Bitswift. All rights reserved.
+//
+
+#import <Proton/Proton.h>
+
+@interface TreeCursorTestNode : NSObject
+@property (nonatomic, copy) NSArray *children;
+
+// incremented every time the children of any node are retrieved
++ (NSUInteger)childrenAccessCount;
+@end
+
+SpecBegin(PROTreeCursor)
+    __block NSArray *rootArray;
+
+    before(^{
+        TreeCursorTestNode *firstNode = [[TreeCursorTestNode alloc] init];
+        firstNode.children = [NSArray arrayWithObjects:@"foo", @"bar", @"baz", nil];
+
+        TreeCursorTestNode *secondNode = [[TreeCursorTestNode alloc] init];
+        secondNode.children = [NSArray arrayWithObjects:@"fizz", @"buzz", nil];
+
+        rootArray = [NSArray arrayWithObjects:firstNode, secondNode, @"leaf", nil];
+    });
+
+    it(@"should return the root array for an empty index path", ^{
+        PROTreeCursor *cursor = [[PROTreeCursor alloc] initWithRootArray:rootArray nodeKeyPath:@"children"];
+        expect([cursor objectAtIndexPath:[NSIndexPath indexPathWithIndexes:NULL length:0]]).toEqual(rootArray);
+    });
+
+    it(@"should return the same objects as an array", ^{
+        PROTreeCursor *cursor = [[PROTreeCursor alloc] initWithRootArray:rootArray nodeKeyPath:@"children"];
+
+        NSUInteger paths[][2] = { { 0, 2 }, { 1, 1 }, { 0, 0 }, { 1, 0 } };
+        for (NSUInteger i = 0; i < sizeof(paths) / sizeof(*paths); ++i) {
+            NSIndexPath *indexPath = [NSIndexPath indexPathWithIndexes:paths[i] length:2];
+            expect([cursor objectAtIndexPath:indexPath]).toEqual([rootArray objectAtIndexPath:indexPath nodeKeyPath:@"children"]);
+        }
+
+        expect([cursor objectAtIndexPath:[NSIndexPath indexPathWithIndex:2]]).toEqual(@"leaf");
+    });
+
+    it(@"should resolve each node only once for sibling lookups", ^{
+        PROTreeCursor *cursor = [[PROTreeCursor alloc] initWithRootArray:rootArray nodeKeyPath:@"children"];
+        NSUInteger startingCount = [TreeCursorTestNode childrenAccessCount];
+
+        for (NSUInteger i = 0; i < 3; ++i) {
+            NSUInteger indexes[] = { 0, i };
+            [cursor objectAtIndexPath:[NSIndexPath indexPathWithIndexes:indexes length:2]];
+        }
+
+        expect([TreeCursorTestNode childrenAccessCount] - startingCount).toEqual(1);
+
+        NSUInteger indexes[] = { 1, 0 };
+        expect([cursor objectAtIndexPath:[NSIndexPath indexPathWithIndexes:indexes length:2]]).toEqual(@"fizz");
+        expect([TreeCursorTestNode childrenAccessCount] - startingCount).toEqual(2);
+    });
+
+    it(@"should resolve nodes again after being reset", ^{
+        PROTreeCursor *cursor = [[PROTreeCursor alloc] initWithRootArray:rootArray nodeKeyPath:@"children"];
+
+        NSUInteger indexes[] = { 0, 0 };
+        NSIndexPath *indexPath = [NSIndexPath indexPathWithIndexes:indexes length:2];
+        expect([cursor objectAtIndexPath:indexPath]).toEqual(@"foo");
+
+        [[rootArray objectAtIndex:0] setChildren:[NSArray arrayWithObject:@"quux"]];
+        [cursor reset];
+
+        expect([cursor objectAtIndexPath:indexPath]).toEqual(@"quux");
+    });
+SpecEnd
+
+static NSUInteger childrenAccessCount = 0;
+
+@implementation TreeCursorTestNode
+@synthesize children = m_children;
+
++ (NSUInteger)childrenAccessCount {
+    return childrenAccessCount;
+}
+
+- (NSArray *)children {
+    ++childrenAccessCount;
+    return m_children;
+}
+
+@end